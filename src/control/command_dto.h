@@ -19,7 +19,8 @@ enum kernelCommandType {
   KernelCmd_SetInputForce,
   KernelCmd_SetOutputMask,
   KernelCmd_SetOutputMaskGlobal,
-  KernelCmd_SetRtcCardState
+  KernelCmd_SetRtcCardState,
+  KernelCmd_ResetTimingStats
 };
 
 struct KernelCommand {
@@ -150,96 +150,67 @@ void profileInitializeCardSafeDefaults(LogicCard& card, uint8_t globalId,
   card.setCombine = Combine_None;
   card.resetCombine = Combine_None;
 
-  if (globalId < layout.doStart) {
-    card.type = DigitalInput;
-    card.index = globalId;
-    card.hwPin = layout.diPins[card.index];
-    card.setting1 = 50;
-    card.setting2 = 0;
-    card.setting3 = 0;
-    card.mode = Mode_DI_Rising;
-    card.state = State_DI_Idle;
-    return;
-  }
-
-  if (globalId < layout.aiStart) {
-    card.type = DigitalOutput;
-    card.index = static_cast<uint8_t>(globalId - layout.doStart);
-    card.hwPin = layout.doPins[card.index];
-    card.setting1 = 1000;
-    card.setting2 = 1000;
-    card.setting3 = 1;
-    card.mode = Mode_DO_Normal;
-    card.state = State_DO_Idle;
-    return;
-  }
-
-  if (globalId < layout.sioStart) {
-    card.type = AnalogInput;
-    card.index = static_cast<uint8_t>(globalId - layout.aiStart);
-    card.hwPin = layout.aiPins[card.index];
-    card.setting1 = 0;
-    card.setting2 = 4095;
-    card.setting3 = 250;
-    card.startOnMs = 0;
-    card.startOffMs = 10000;
-    card.mode = Mode_AI_Continuous;
-    card.state = State_AI_Streaming;
-    return;
-  }
-
-  if (globalId < layout.mathStart) {
-    card.type = SoftIO;
-    card.index = static_cast<uint8_t>(globalId - layout.sioStart);
-    card.hwPin = layout.sioPins[card.index];
-    card.setting1 = 1000;
-    card.setting2 = 1000;
-    card.setting3 = 1;
-    card.mode = Mode_DO_Normal;
-    card.state = State_DO_Idle;
-    return;
-  }
-
-  if (globalId < layout.rtcStart) {
-    card.type = MathCard;
-    card.index = static_cast<uint8_t>(globalId - layout.mathStart);
-    card.hwPin = 255;
-    card.setting1 = 0;
-    card.setting2 = 0;
-    card.setting3 = 0;
-    card.startOnMs = 0;
-    card.startOffMs = 0;
-    card.mode = Mode_None;
-    card.state = State_None;
-    return;
-  }
-
-  card.type = RtcCard;
-  card.index = static_cast<uint8_t>(globalId - layout.rtcStart);
+  const V3CardFamily family = v3CardFamilyForId(layout.cards, globalId);
+  card.type = v3CardTypeForFamily(family);
+  card.index = v3CardFamilyIndex(layout.cards, globalId);
   card.hwPin = 255;
-  card.setting1 = 60000;
-  card.setting2 = 0;
-  card.setting3 = 0;
   card.mode = Mode_None;
   card.state = State_None;
+
+  switch (family) {
+    case V3CardFamily::DI:
+      card.hwPin = layout.diPins[card.index];
+      card.setting1 = 50;
+      card.mode = Mode_DI_Rising;
+      card.state = State_DI_Idle;
+      return;
+    case V3CardFamily::DO:
+      card.hwPin = layout.doPins[card.index];
+      card.setting1 = 1000;
+      card.setting2 = 1000;
+      card.setting3 = 1;
+      card.mode = Mode_DO_Normal;
+      card.state = State_DO_Idle;
+      return;
+    case V3CardFamily::AI:
+      card.hwPin = layout.aiPins[card.index];
+      card.setting2 = 4095;
+      card.setting3 = 250;
+      card.startOffMs = 10000;
+      card.mode = Mode_AI_Continuous;
+      card.state = State_AI_Streaming;
+      return;
+    case V3CardFamily::SIO:
+      card.setting1 = 1000;
+      card.setting2 = 1000;
+      card.setting3 = 1;
+      card.mode = Mode_DO_Normal;
+      card.state = State_DO_Idle;
+      return;
+    case V3CardFamily::MATH:
+      return;
+    case V3CardFamily::RTC:
+      card.setting1 = 60000;
+      return;
+  }
 }
 
 void profileInitializeCardArraySafeDefaults(LogicCard* cards,
                                             const LegacyCardProfileLayout& layout) {
-  for (uint8_t i = 0; i < layout.totalCards; ++i) {
+  for (uint8_t i = 0; i < layout.cards.totalCards; ++i) {
     profileInitializeCardSafeDefaults(cards[i], i, layout);
   }
 }
 
 bool profileDeserializeCardsFromArray(JsonArrayConst array, LogicCard* outCards,
                                       const LegacyCardProfileLayout& layout) {
-  if (array.size() != layout.totalCards) return false;
+  if (array.size() != layout.cards.totalCards) return false;
   profileInitializeCardArraySafeDefaults(outCards, layout);
-  for (uint8_t i = 0; i < layout.totalCards; ++i) {
+  for (uint8_t i = 0; i < layout.cards.totalCards; ++i) {
     JsonVariantConst item = array[i];
     if (!item.is<JsonObjectConst>()) return false;
     profileDeserializeCardFromJson(item, outCards[i]);
   }
-  sanitizeConfigCardsRuntimeFields(outCards, layout.totalCards);
+  sanitizeConfigCardsRuntimeFields(outCards, layout.cards.totalCards);
   return true;
 }
@@ -5,18 +5,14 @@
 #include <ArduinoJson.h>
 
 #include "kernel/card_model.h"
+#include "kernel/v3_card_layout.h"
 
+// SIO, MATH and RTC cards are virtual and get hwPin 255.
 struct LegacyCardProfileLayout {
-  uint8_t totalCards;
-  uint8_t doStart;
-  uint8_t aiStart;
-  uint8_t sioStart;
-  uint8_t mathStart;
-  uint8_t rtcStart;
+  V3CardLayout cards;
   const uint8_t* diPins;
   const uint8_t* doPins;
   const uint8_t* aiPins;
-  const uint8_t* sioPins;
 };
 
 void profileSerializeCardToJson(const LogicCard& card, JsonObject& json);
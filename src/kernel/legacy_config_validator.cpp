@@ -4,10 +4,9 @@
 
 #include "kernel/enum_codec.h"
 
-bool validateLegacyConfigCardsArray(JsonArrayConst array, uint8_t totalCards,
-                                    uint8_t doStart, uint8_t aiStart,
-                                    uint8_t sioStart, uint8_t mathStart,
-                                    uint8_t rtcStart, String& reason) {
+bool validateLegacyConfigCardsArray(JsonArrayConst array,
+                                    const V3CardLayout& layout, String& reason) {
+  const uint8_t totalCards = layout.totalCards;
   if (array.size() != totalCards) {
     reason = "cards size mismatch";
     return false;
@@ -126,21 +125,7 @@ bool validateLegacyConfigCardsArray(JsonArrayConst array, uint8_t totalCards,
     seenId[id] = true;
     typeById[id] = cardTypeFromString(card["type"] | "DigitalInput");
     typeKnown[id] = true;
-    logicCardType expectedType = DigitalInput;
-    if (id < doStart) {
-      expectedType = DigitalInput;
-    } else if (id < aiStart) {
-      expectedType = DigitalOutput;
-    } else if (id < sioStart) {
-      expectedType = AnalogInput;
-    } else if (id < mathStart) {
-      expectedType = SoftIO;
-    } else if (id < rtcStart) {
-      expectedType = MathCard;
-    } else {
-      expectedType = RtcCard;
-    }
-    if (typeById[id] != expectedType) {
+    if (typeById[id] != v3CardTypeForId(layout, id)) {
       reason = "card type does not match fixed family slot";
       return false;
     }
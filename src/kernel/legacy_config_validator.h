@@ -5,8 +5,7 @@
 #include <ArduinoJson.h>
 
 #include "kernel/string_compat.h"
+#include "kernel/v3_card_layout.h"
 
-bool validateLegacyConfigCardsArray(JsonArrayConst array, uint8_t totalCards,
-                                    uint8_t doStart, uint8_t aiStart,
-                                    uint8_t sioStart, uint8_t mathStart,
-                                    uint8_t rtcStart, String& reason);
+bool validateLegacyConfigCardsArray(JsonArrayConst array,
+                                    const V3CardLayout& layout, String& reason);
@@ -45,6 +45,7 @@ bool legacyToV3CardConfig(const LogicCard& legacy, const int16_t rtcYear,
                           const int8_t rtcMonth, const int8_t rtcDay,
                           const int8_t rtcWeekday, const int8_t rtcHour,
                           const int8_t rtcMinute, V3CardConfig& out) {
+  out = {};
   out.cardId = legacy.id;
   out.enabled = true;
   out.faultPolicy = V3FaultPolicy::WARN;
@@ -52,64 +53,70 @@ bool legacyToV3CardConfig(const LogicCard& legacy, const int16_t rtcYear,
 
   switch (legacy.type) {
     case DigitalInput: {
-      out.di.channel = legacy.index;
-      out.di.invert = legacy.invert;
-      out.di.debounceTimeMs = legacyDiDebounceMs(legacy);
-      out.di.edgeMode = legacy.mode;
-      copyCondition(legacy, out.di.set, out.di.reset);
+      V3DiConfig& di = out.asDi();
+      di.channel = legacy.index;
+      di.invert = legacy.invert;
+      di.debounceTimeMs = legacyDiDebounceMs(legacy);
+      di.edgeMode = legacy.mode;
+      copyCondition(legacy, di.set, di.reset);
       return true;
     }
     case DigitalOutput: {
-      out.dout.channel = legacy.index;
-      out.dout.mode = legacy.mode;
-      out.dout.delayBeforeOnMs = legacyDoDelayBeforeOnMs(legacy);
-      out.dout.onDurationMs = legacyDoOnDurationMs(legacy);
-      out.dout.repeatCount = legacyDoRepeatCount(legacy);
-      copyCondition(legacy, out.dout.set, out.dout.reset);
+      V3DoConfig& dout = out.asDo();
+      dout.channel = legacy.index;
+      dout.mode = legacy.mode;
+      dout.delayBeforeOnMs = legacyDoDelayBeforeOnMs(legacy);
+      dout.onDurationMs = legacyDoOnDurationMs(legacy);
+      dout.repeatCount = legacyDoRepeatCount(legacy);
+      copyCondition(legacy, dout.set, dout.reset);
       return true;
     }
     case AnalogInput: {
-      out.ai.channel = legacy.index;
-      out.ai.inputMin = legacyAiInputMin(legacy);
-      out.ai.inputMax = legacyAiInputMax(legacy);
-      out.ai.outputMin = legacyAiOutputMin(legacy);
-      out.ai.outputMax = legacyAiOutputMax(legacy);
+      V3AiConfig& ai = out.asAi();
+      ai.channel = legacy.index;
+      ai.inputMin = legacyAiInputMin(legacy);
+      ai.inputMax = legacyAiInputMax(legacy);
+      ai.outputMin = legacyAiOutputMin(legacy);
+      ai.outputMax = legacyAiOutputMax(legacy);
       uint32_t alphaX100 = (legacyAiAlphaX1000(legacy) + 5U) / 10U;
       if (alphaX100 > 100U) alphaX100 = 100U;
-      out.ai.emaAlphaX100 = alphaX100;
+      ai.emaAlphaX100 = alphaX100;
       return true;
     }
     case SoftIO: {
-      out.sio.mode = legacy.mode;
-      out.sio.delayBeforeOnMs = legacyDoDelayBeforeOnMs(legacy);
-      out.sio.onDurationMs = legacyDoOnDurationMs(legacy);
-      out.sio.repeatCount = legacyDoRepeatCount(legacy);
-      copyCondition(legacy, out.sio.set, out.sio.reset);
+      V3SioConfig& sio = out.asSio();
+      sio.mode = legacy.mode;
+      sio.delayBeforeOnMs = legacyDoDelayBeforeOnMs(legacy);
+      sio.onDurationMs = legacyDoOnDurationMs(legacy);
+      sio.repeatCount = legacyDoRepeatCount(legacy);
+      copyCondition(legacy, sio.set, sio.reset);
       return true;
     }
     case MathCard: {
-      out.math.fallbackValue = legacyMathFallbackValue(legacy);
-      out.math.inputA = legacyMathInputA(legacy);
-      out.math.inputB = legacyMathInputB(legacy);
-      out.math.clampMin = legacyMathClampMin(legacy);
-      out.math.clampMax = legacyMathClampMax(legacy);
-      copyCondition(legacy, out.math.set, out.math.reset);
+      V3MathConfig& math = out.asMath();
+      math.fallbackValue = legacyMathFallbackValue(legacy);
+      math.inputA = legacyMathInputA(legacy);
+      math.inputB = legacyMathInputB(legacy);
+      math.clampMin = legacyMathClampMin(legacy);
+      math.clampMax = legacyMathClampMax(legacy);
+      copyCondition(legacy, math.set, math.reset);
       return true;
     }
     case RtcCard: {
-      out.rtc.hasYear = rtcYear >= 0;
-      out.rtc.hasMonth = rtcMonth >= 0;
-      out.rtc.hasDay = rtcDay >= 0;
-      out.rtc.hasWeekday = rtcWeekday >= 0;
-      out.rtc.year = (rtcYear >= 0) ? static_cast<uint16_t>(rtcYear) : 0U;
-      out.rtc.month = (rtcMonth >= 0) ? static_cast<uint8_t>(rtcMonth) : 0U;
-      out.rtc.day = (rtcDay >= 0) ? static_cast<uint8_t>(rtcDay) : 0U;
-      out.rtc.weekday =
+      V3RtcConfig& rtc = out.asRtc();
+      rtc.hasYear = rtcYear >= 0;
+      rtc.hasMonth = rtcMonth >= 0;
+      rtc.hasDay = rtcDay >= 0;
+      rtc.hasWeekday = rtcWeekday >= 0;
+      rtc.year = (rtcYear >= 0) ? static_cast<uint16_t>(rtcYear) : 0U;
+      rtc.month = (rtcMonth >= 0) ? static_cast<uint8_t>(rtcMonth) : 0U;
+      rtc.day = (rtcDay >= 0) ? static_cast<uint8_t>(rtcDay) : 0U;
+      rtc.weekday =
           (rtcWeekday >= 0) ? static_cast<uint8_t>(rtcWeekday) : 0U;
-      out.rtc.hour = (rtcHour >= 0) ? static_cast<uint8_t>(rtcHour) : 0U;
-      out.rtc.minute =
+      rtc.hour = (rtcHour >= 0) ? static_cast<uint8_t>(rtcHour) : 0U;
+      rtc.minute =
           (rtcMinute >= 0) ? static_cast<uint8_t>(rtcMinute) : 0U;
-      out.rtc.triggerDurationMs = legacyRtcTriggerDurationMs(legacy);
+      rtc.triggerDurationMs = legacyRtcTriggerDurationMs(legacy);
       return true;
     }
     default:
@@ -119,107 +126,118 @@ bool legacyToV3CardConfig(const LogicCard& legacy, const int16_t rtcYear,
 
 bool v3CardConfigToLegacy(const V3CardConfig& v3, LogicCard& out) {
   switch (v3.family) {
-    case V3CardFamily::DI:
+    case V3CardFamily::DI: {
+      const V3DiConfig& di = v3.asDi();
       out.type = DigitalInput;
-      out.index = v3.di.channel;
-      out.invert = v3.di.invert;
-      setLegacyDiDebounceMs(out, v3.di.debounceTimeMs);
-      out.mode = v3.di.edgeMode;
-      out.setA_ID = v3.di.set.clauseAId;
-      out.setA_Operator = v3.di.set.clauseAOperator;
-      out.setA_Threshold = v3.di.set.clauseAThreshold;
-      out.setB_ID = v3.di.set.clauseBId;
-      out.setB_Operator = v3.di.set.clauseBOperator;
-      out.setB_Threshold = v3.di.set.clauseBThreshold;
-      out.setCombine = v3.di.set.combiner;
-      out.resetA_ID = v3.di.reset.clauseAId;
-      out.resetA_Operator = v3.di.reset.clauseAOperator;
-      out.resetA_Threshold = v3.di.reset.clauseAThreshold;
-      out.resetB_ID = v3.di.reset.clauseBId;
-      out.resetB_Operator = v3.di.reset.clauseBOperator;
-      out.resetB_Threshold = v3.di.reset.clauseBThreshold;
-      out.resetCombine = v3.di.reset.combiner;
+      out.index = di.channel;
+      out.invert = di.invert;
+      setLegacyDiDebounceMs(out, di.debounceTimeMs);
+      out.mode = di.edgeMode;
+      out.setA_ID = di.set.clauseAId;
+      out.setA_Operator = di.set.clauseAOperator;
+      out.setA_Threshold = di.set.clauseAThreshold;
+      out.setB_ID = di.set.clauseBId;
+      out.setB_Operator = di.set.clauseBOperator;
+      out.setB_Threshold = di.set.clauseBThreshold;
+      out.setCombine = di.set.combiner;
+      out.resetA_ID = di.reset.clauseAId;
+      out.resetA_Operator = di.reset.clauseAOperator;
+      out.resetA_Threshold = di.reset.clauseAThreshold;
+      out.resetB_ID = di.reset.clauseBId;
+      out.resetB_Operator = di.reset.clauseBOperator;
+      out.resetB_Threshold = di.reset.clauseBThreshold;
+      out.resetCombine = di.reset.combiner;
       return true;
-    case V3CardFamily::DO:
+    }
+    case V3CardFamily::DO: {
+      const V3DoConfig& dout = v3.asDo();
       out.type = DigitalOutput;
-      out.index = v3.dout.channel;
-      out.mode = v3.dout.mode;
-      setLegacyDoDelayBeforeOnMs(out, v3.dout.delayBeforeOnMs);
-      setLegacyDoOnDurationMs(out, v3.dout.onDurationMs);
-      setLegacyDoRepeatCount(out, v3.dout.repeatCount);
-      out.setA_ID = v3.dout.set.clauseAId;
-      out.setA_Operator = v3.dout.set.clauseAOperator;
-      out.setA_Threshold = v3.dout.set.clauseAThreshold;
-      out.setB_ID = v3.dout.set.clauseBId;
-      out.setB_Operator = v3.dout.set.clauseBOperator;
-      out.setB_Threshold = v3.dout.set.clauseBThreshold;
-      out.setCombine = v3.dout.set.combiner;
-      out.resetA_ID = v3.dout.reset.clauseAId;
-      out.resetA_Operator = v3.dout.reset.clauseAOperator;
-      out.resetA_Threshold = v3.dout.reset.clauseAThreshold;
-      out.resetB_ID = v3.dout.reset.clauseBId;
-      out.resetB_Operator = v3.dout.reset.clauseBOperator;
-      out.resetB_Threshold = v3.dout.reset.clauseBThreshold;
-      out.resetCombine = v3.dout.reset.combiner;
+      out.index = dout.channel;
+      out.mode = dout.mode;
+      setLegacyDoDelayBeforeOnMs(out, dout.delayBeforeOnMs);
+      setLegacyDoOnDurationMs(out, dout.onDurationMs);
+      setLegacyDoRepeatCount(out, dout.repeatCount);
+      out.setA_ID = dout.set.clauseAId;
+      out.setA_Operator = dout.set.clauseAOperator;
+      out.setA_Threshold = dout.set.clauseAThreshold;
+      out.setB_ID = dout.set.clauseBId;
+      out.setB_Operator = dout.set.clauseBOperator;
+      out.setB_Threshold = dout.set.clauseBThreshold;
+      out.setCombine = dout.set.combiner;
+      out.resetA_ID = dout.reset.clauseAId;
+      out.resetA_Operator = dout.reset.clauseAOperator;
+      out.resetA_Threshold = dout.reset.clauseAThreshold;
+      out.resetB_ID = dout.reset.clauseBId;
+      out.resetB_Operator = dout.reset.clauseBOperator;
+      out.resetB_Threshold = dout.reset.clauseBThreshold;
+      out.resetCombine = dout.reset.combiner;
       return true;
-    case V3CardFamily::AI:
+    }
+    case V3CardFamily::AI: {
+      const V3AiConfig& ai = v3.asAi();
       out.type = AnalogInput;
-      out.index = v3.ai.channel;
-      setLegacyAiInputMin(out, v3.ai.inputMin);
-      setLegacyAiInputMax(out, v3.ai.inputMax);
-      setLegacyAiOutputMin(out, v3.ai.outputMin);
-      setLegacyAiOutputMax(out, v3.ai.outputMax);
-      setLegacyAiAlphaX1000(out, v3.ai.emaAlphaX100 * 10U);
+      out.index = ai.channel;
+      setLegacyAiInputMin(out, ai.inputMin);
+      setLegacyAiInputMax(out, ai.inputMax);
+      setLegacyAiOutputMin(out, ai.outputMin);
+      setLegacyAiOutputMax(out, ai.outputMax);
+      setLegacyAiAlphaX1000(out, ai.emaAlphaX100 * 10U);
       out.mode = Mode_AI_Continuous;
       return true;
-    case V3CardFamily::SIO:
+    }
+    case V3CardFamily::SIO: {
+      const V3SioConfig& sio = v3.asSio();
       out.type = SoftIO;
-      out.mode = v3.sio.mode;
-      setLegacyDoDelayBeforeOnMs(out, v3.sio.delayBeforeOnMs);
-      setLegacyDoOnDurationMs(out, v3.sio.onDurationMs);
-      setLegacyDoRepeatCount(out, v3.sio.repeatCount);
-      out.setA_ID = v3.sio.set.clauseAId;
-      out.setA_Operator = v3.sio.set.clauseAOperator;
-      out.setA_Threshold = v3.sio.set.clauseAThreshold;
-      out.setB_ID = v3.sio.set.clauseBId;
-      out.setB_Operator = v3.sio.set.clauseBOperator;
-      out.setB_Threshold = v3.sio.set.clauseBThreshold;
-      out.setCombine = v3.sio.set.combiner;
-      out.resetA_ID = v3.sio.reset.clauseAId;
-      out.resetA_Operator = v3.sio.reset.clauseAOperator;
-      out.resetA_Threshold = v3.sio.reset.clauseAThreshold;
-      out.resetB_ID = v3.sio.reset.clauseBId;
-      out.resetB_Operator = v3.sio.reset.clauseBOperator;
-      out.resetB_Threshold = v3.sio.reset.clauseBThreshold;
-      out.resetCombine = v3.sio.reset.combiner;
+      out.mode = sio.mode;
+      setLegacyDoDelayBeforeOnMs(out, sio.delayBeforeOnMs);
+      setLegacyDoOnDurationMs(out, sio.onDurationMs);
+      setLegacyDoRepeatCount(out, sio.repeatCount);
+      out.setA_ID = sio.set.clauseAId;
+      out.setA_Operator = sio.set.clauseAOperator;
+      out.setA_Threshold = sio.set.clauseAThreshold;
+      out.setB_ID = sio.set.clauseBId;
+      out.setB_Operator = sio.set.clauseBOperator;
+      out.setB_Threshold = sio.set.clauseBThreshold;
+      out.setCombine = sio.set.combiner;
+      out.resetA_ID = sio.reset.clauseAId;
+      out.resetA_Operator = sio.reset.clauseAOperator;
+      out.resetA_Threshold = sio.reset.clauseAThreshold;
+      out.resetB_ID = sio.reset.clauseBId;
+      out.resetB_Operator = sio.reset.clauseBOperator;
+      out.resetB_Threshold = sio.reset.clauseBThreshold;
+      out.resetCombine = sio.reset.combiner;
       return true;
-    case V3CardFamily::MATH:
+    }
+    case V3CardFamily::MATH: {
+      const V3MathConfig& math = v3.asMath();
       out.type = MathCard;
-      setLegacyMathFallbackValue(out, v3.math.fallbackValue);
-      setLegacyMathInputA(out, v3.math.inputA);
-      setLegacyMathInputB(out, v3.math.inputB);
-      setLegacyMathClampMin(out, v3.math.clampMin);
-      setLegacyMathClampMax(out, v3.math.clampMax);
+      setLegacyMathFallbackValue(out, math.fallbackValue);
+      setLegacyMathInputA(out, math.inputA);
+      setLegacyMathInputB(out, math.inputB);
+      setLegacyMathClampMin(out, math.clampMin);
+      setLegacyMathClampMax(out, math.clampMax);
       out.mode = Mode_None;
-      out.setA_ID = v3.math.set.clauseAId;
-      out.setA_Operator = v3.math.set.clauseAOperator;
-      out.setA_Threshold = v3.math.set.clauseAThreshold;
-      out.setB_ID = v3.math.set.clauseBId;
-      out.setB_Operator = v3.math.set.clauseBOperator;
-      out.setB_Threshold = v3.math.set.clauseBThreshold;
-      out.setCombine = v3.math.set.combiner;
-      out.resetA_ID = v3.math.reset.clauseAId;
-      out.resetA_Operator = v3.math.reset.clauseAOperator;
-      out.resetA_Threshold = v3.math.reset.clauseAThreshold;
-      out.resetB_ID = v3.math.reset.clauseBId;
-      out.resetB_Operator = v3.math.reset.clauseBOperator;
-      out.resetB_Threshold = v3.math.reset.clauseBThreshold;
-      out.resetCombine = v3.math.reset.combiner;
+      out.setA_ID = math.set.clauseAId;
+      out.setA_Operator = math.set.clauseAOperator;
+      out.setA_Threshold = math.set.clauseAThreshold;
+      out.setB_ID = math.set.clauseBId;
+      out.setB_Operator = math.set.clauseBOperator;
+      out.setB_Threshold = math.set.clauseBThreshold;
+      out.setCombine = math.set.combiner;
+      out.resetA_ID = math.reset.clauseAId;
+      out.resetA_Operator = math.reset.clauseAOperator;
+      out.resetA_Threshold = math.reset.clauseAThreshold;
+      out.resetB_ID = math.reset.clauseBId;
+      out.resetB_Operator = math.reset.clauseBOperator;
+      out.resetB_Threshold = math.reset.clauseBThreshold;
+      out.resetCombine = math.reset.combiner;
       return true;
-    case V3CardFamily::RTC:
+    }
+    case V3CardFamily::RTC: {
+      const V3RtcConfig& rtc = v3.asRtc();
       out.type = RtcCard;
       out.mode = Mode_None;
-      setLegacyRtcTriggerDurationMs(out, v3.rtc.triggerDurationMs);
+      setLegacyRtcTriggerDurationMs(out, rtc.triggerDurationMs);
       out.setA_Operator = Op_AlwaysFalse;
       out.setB_Operator = Op_AlwaysFalse;
       out.resetA_Operator = Op_AlwaysFalse;
@@ -227,6 +245,7 @@ bool v3CardConfigToLegacy(const V3CardConfig& v3, LogicCard& out) {
       out.setCombine = Combine_None;
       out.resetCombine = Combine_None;
       return true;
+    }
     default:
       return false;
   }
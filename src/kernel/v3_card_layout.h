@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/card_model.h"
+#include "kernel/v3_card_types.h"
+
+constexpr uint16_t kV3MaxCards = 255;
+
+// Card id ranges per family in fixed order DI, DO, AI, SIO, MATH, RTC.
+// Each family occupies [start, next start); RTC runs to `totalCards`.
+struct V3CardLayout {
+  uint8_t totalCards;
+  uint8_t doStart;
+  uint8_t aiStart;
+  uint8_t sioStart;
+  uint8_t mathStart;
+  uint8_t rtcStart;
+};
+
+constexpr V3CardFamily v3CardFamilyForId(const V3CardLayout& layout,
+                                         uint8_t id) {
+  return id < layout.doStart     ? V3CardFamily::DI
+         : id < layout.aiStart   ? V3CardFamily::DO
+         : id < layout.sioStart  ? V3CardFamily::AI
+         : id < layout.mathStart ? V3CardFamily::SIO
+         : id < layout.rtcStart  ? V3CardFamily::MATH
+                                 : V3CardFamily::RTC;
+}
+
+constexpr logicCardType v3CardTypeForFamily(V3CardFamily family) {
+  return family == V3CardFamily::DI     ? DigitalInput
+         : family == V3CardFamily::DO   ? DigitalOutput
+         : family == V3CardFamily::AI   ? AnalogInput
+         : family == V3CardFamily::SIO  ? SoftIO
+         : family == V3CardFamily::MATH ? MathCard
+                                        : RtcCard;
+}
+
+constexpr logicCardType v3CardTypeForId(const V3CardLayout& layout,
+                                        uint8_t id) {
+  return v3CardTypeForFamily(v3CardFamilyForId(layout, id));
+}
+
+constexpr uint8_t v3FamilyStart(const V3CardLayout& layout,
+                                V3CardFamily family) {
+  return family == V3CardFamily::DI     ? 0
+         : family == V3CardFamily::DO   ? layout.doStart
+         : family == V3CardFamily::AI   ? layout.aiStart
+         : family == V3CardFamily::SIO  ? layout.sioStart
+         : family == V3CardFamily::MATH ? layout.mathStart
+                                        : layout.rtcStart;
+}
+
+// Position of `id` within its family (channel slot for IO families).
+constexpr uint8_t v3CardFamilyIndex(const V3CardLayout& layout, uint8_t id) {
+  return static_cast<uint8_t>(
+      id - v3FamilyStart(layout, v3CardFamilyForId(layout, id)));
+}
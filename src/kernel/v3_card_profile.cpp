@@ -0,0 +1,13 @@
+#include "kernel/v3_card_profile.h"
+
+void resetV3CardCosts(V3CardCost* costs, uint8_t count) {
+  if (costs == nullptr) return;
+  for (uint8_t i = 0; i < count; ++i) costs[i] = {};
+}
+
+void recordV3CardCost(V3CardCost& cost, uint32_t ticks) {
+  cost.lastTicks = ticks;
+  if (ticks > cost.maxTicks) cost.maxTicks = ticks;
+  cost.totalTicks += ticks;
+  cost.samples += 1;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+// Per-card execution cost instrumentation. Off by default; with
+// CARD_PROFILING=0 no storage, timing reads or snapshot fields are compiled.
+#ifndef CARD_PROFILING
+#define CARD_PROFILING 0
+#endif
+
+// Cost of one card step (process + signal refresh) in counter ticks: CPU
+// cycles on target, steady-clock nanoseconds on native.
+struct V3CardCost {
+  uint32_t lastTicks;
+  uint32_t maxTicks;
+  uint64_t totalTicks;
+  uint32_t samples;
+};
+
+inline uint32_t readV3CostCounter() {
+#ifdef ARDUINO
+  return ESP.getCycleCount();
+#else
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+void resetV3CardCosts(V3CardCost* costs, uint8_t count);
+void recordV3CardCost(V3CardCost& cost, uint32_t ticks);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <assert.h>
 #include <stdint.h>
 
 #include "kernel/card_model.h"
@@ -106,16 +107,75 @@ struct V3RtcConfig {
   uint32_t triggerDurationMs;
 };
 
+// Typed card config. `family` selects the one live member of the family
+// union; writers reset the card (`= {}`) and set `family` before filling a
+// family so no other family's bytes leak through. Only the largest family
+// is paid for per card.
+//
+// Read and write the union through the `as*()` accessors, which assert
+// that `family` matches (compiled out under NDEBUG). The raw members stay
+// public so the struct remains an aggregate.
 struct V3CardConfig {
   uint8_t cardId;
   V3CardFamily family;
   bool enabled;
   V3FaultPolicy faultPolicy;
 
-  V3DiConfig di;
-  V3DoConfig dout;
-  V3AiConfig ai;
-  V3SioConfig sio;
-  V3MathConfig math;
-  V3RtcConfig rtc;
+  union {
+    V3DoConfig dout;
+    V3DiConfig di;
+    V3AiConfig ai;
+    V3SioConfig sio;
+    V3MathConfig math;
+    V3RtcConfig rtc;
+  };
+
+  V3DiConfig& asDi() {
+    assert(family == V3CardFamily::DI);
+    return di;
+  }
+  const V3DiConfig& asDi() const {
+    assert(family == V3CardFamily::DI);
+    return di;
+  }
+  V3DoConfig& asDo() {
+    assert(family == V3CardFamily::DO);
+    return dout;
+  }
+  const V3DoConfig& asDo() const {
+    assert(family == V3CardFamily::DO);
+    return dout;
+  }
+  V3AiConfig& asAi() {
+    assert(family == V3CardFamily::AI);
+    return ai;
+  }
+  const V3AiConfig& asAi() const {
+    assert(family == V3CardFamily::AI);
+    return ai;
+  }
+  V3SioConfig& asSio() {
+    assert(family == V3CardFamily::SIO);
+    return sio;
+  }
+  const V3SioConfig& asSio() const {
+    assert(family == V3CardFamily::SIO);
+    return sio;
+  }
+  V3MathConfig& asMath() {
+    assert(family == V3CardFamily::MATH);
+    return math;
+  }
+  const V3MathConfig& asMath() const {
+    assert(family == V3CardFamily::MATH);
+    return math;
+  }
+  V3RtcConfig& asRtc() {
+    assert(family == V3CardFamily::RTC);
+    return rtc;
+  }
+  const V3RtcConfig& asRtc() const {
+    assert(family == V3CardFamily::RTC);
+    return rtc;
+  }
 };
@@ -0,0 +1,119 @@
+#include "kernel/v3_condition_batch.h"
+
+namespace {
+const uint32_t kOnesWord[1] = {0xFFFFFFFFUL};
+const uint32_t kZeroWord[1] = {0};
+
+// Returns true when the clause must be inverted after the gather.
+bool lowerClause(const V3ConditionInstr& instr, V3BitClause& out) {
+  out.source = instr.source;
+  switch (instr.opcode) {
+    case CondOp_True:
+      out.source = 0;
+      out.plane = CondPlane_One;
+      return false;
+    case CondOp_Logical:
+      out.plane = CondPlane_Logical;
+      return false;
+    case CondOp_NotLogical:
+      out.plane = CondPlane_Logical;
+      return true;
+    case CondOp_Physical:
+      out.plane = CondPlane_Physical;
+      return false;
+    case CondOp_NotPhysical:
+      out.plane = CondPlane_Physical;
+      return true;
+    case CondOp_Triggered:
+      out.plane = CondPlane_Trigger;
+      return false;
+    case CondOp_NotTriggered:
+      out.plane = CondPlane_Trigger;
+      return true;
+    case CondOp_GT:
+    case CondOp_LT:
+    case CondOp_EQ:
+    case CondOp_NEQ:
+    case CondOp_GTE:
+    case CondOp_LTE:
+    case CondOp_StateEq:
+    case CondOp_StateEither:
+      out.source = 0;
+      out.plane = CondPlane_Compare;
+      return false;
+    default:
+      // CondOp_False and unknown opcodes: inverted constant one.
+      out.source = 0;
+      out.plane = CondPlane_One;
+      return true;
+  }
+}
+
+inline uint32_t gatherBit(const uint32_t* const* planes,
+                          const V3BitClause& clause) {
+  return (planes[clause.plane][clause.source >> 5] >> (clause.source & 31U)) &
+         1U;
+}
+}  // namespace
+
+void compileV3ConditionBatch(V3ConditionBatchView& batch) {
+  const uint16_t words = v3SignalWordCount(batch.count);
+  for (uint16_t w = 0; w < words; ++w) {
+    batch.invertA[w] = 0;
+    batch.invertB[w] = 0;
+    batch.anyOf[w] = 0;
+  }
+  batch.compareCount = 0;
+  for (uint16_t p = 0; p < batch.count; ++p) {
+    const V3ConditionProgram& program = batch.programs[p];
+    const uint32_t bit = 1UL << (p & 31U);
+    if (lowerClause(program.a, batch.clauseA[p])) batch.invertA[p >> 5] |= bit;
+    if (lowerClause(program.b, batch.clauseB[p])) batch.invertB[p >> 5] |= bit;
+    if (program.anyOf) batch.anyOf[p >> 5] |= bit;
+    if (batch.clauseA[p].plane == CondPlane_Compare) {
+      batch.compares[batch.compareCount++] = static_cast<uint16_t>(p << 1);
+    }
+    if (batch.clauseB[p].plane == CondPlane_Compare) {
+      batch.compares[batch.compareCount++] =
+          static_cast<uint16_t>((p << 1) | 1U);
+    }
+  }
+}
+
+void evalV3ConditionBatch(const V3ConditionBatchView& batch,
+                          const V3SignalStoreView& signals, uint32_t* out) {
+  const uint32_t* const planes[] = {signals.logical, signals.physical,
+                                    signals.trigger, kOnesWord, kZeroWord};
+  const uint16_t words = v3SignalWordCount(batch.count);
+  uint16_t nextCompare = 0;
+  for (uint16_t w = 0; w < words; ++w) {
+    const uint16_t base = static_cast<uint16_t>(w * 32U);
+    const uint16_t end = batch.count < base + 32U
+                             ? batch.count
+                             : static_cast<uint16_t>(base + 32U);
+    uint32_t a = 0;
+    uint32_t b = 0;
+    for (uint16_t p = base; p < end; ++p) {
+      const uint8_t shift = static_cast<uint8_t>(p - base);
+      a |= gatherBit(planes, batch.clauseA[p]) << shift;
+      b |= gatherBit(planes, batch.clauseB[p]) << shift;
+    }
+    a ^= batch.invertA[w];
+    b ^= batch.invertB[w];
+    while (nextCompare < batch.compareCount &&
+           (batch.compares[nextCompare] >> 1) < end) {
+      const uint16_t entry = batch.compares[nextCompare++];
+      const uint16_t p = static_cast<uint16_t>(entry >> 1);
+      const bool isB = (entry & 1U) != 0;
+      const V3ConditionProgram& program = batch.programs[p];
+      if (!evalV3ConditionInstr(isB ? program.b : program.a, signals)) continue;
+      const uint32_t bit = 1UL << (p - base);
+      if (isB) {
+        b |= bit;
+      } else {
+        a |= bit;
+      }
+    }
+    out[w] = (a & b) | (batch.anyOf[w] & (a | b));
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel/v3_condition_program.h"
+#include "kernel/v3_runtime_signals.h"
+
+// Bit plane a lowered clause reads. `One` backs the constants (false is
+// inverted true); `Compare` marks clauses that need per-clause evaluation.
+enum V3ConditionPlane : uint8_t {
+  CondPlane_Logical,
+  CondPlane_Physical,
+  CondPlane_Trigger,
+  CondPlane_One,
+  CondPlane_Compare
+};
+
+struct V3BitClause {
+  uint8_t source;
+  V3ConditionPlane plane;
+};
+
+// Whole-image evaluation of `count` compiled programs, 32 per word: each
+// boolean clause is one bit gathered from a signal plane, negation and the
+// AND/OR combine run on whole words, and only numeric/state compares
+// (listed in `compares` as program << 1 | isClauseB) run per clause.
+// Storage is caller-owned (`V3ConditionBatchStorage<N>`).
+struct V3ConditionBatchView {
+  uint16_t count;
+  const V3ConditionProgram* programs;
+  V3BitClause* clauseA;
+  V3BitClause* clauseB;
+  uint32_t* invertA;
+  uint32_t* invertB;
+  uint32_t* anyOf;
+  uint16_t* compares;
+  uint16_t compareCount;
+};
+
+template <size_t N>
+struct V3ConditionBatchStorage {
+  V3BitClause clauseA[N];
+  V3BitClause clauseB[N];
+  uint32_t invertA[v3SignalWordCount(N)];
+  uint32_t invertB[v3SignalWordCount(N)];
+  uint32_t anyOf[v3SignalWordCount(N)];
+  uint16_t compares[2 * N];
+};
+
+template <size_t N>
+V3ConditionBatchView makeV3ConditionBatchView(
+    V3ConditionBatchStorage<N>& storage, const V3ConditionProgram* programs,
+    uint16_t count) {
+  return {count < N ? count : static_cast<uint16_t>(N),
+          programs,
+          storage.clauseA,
+          storage.clauseB,
+          storage.invertA,
+          storage.invertB,
+          storage.anyOf,
+          storage.compares,
+          0};
+}
+
+// Lowers `batch.programs[0 .. count)`; re-run after the programs change.
+void compileV3ConditionBatch(V3ConditionBatchView& batch);
+// Writes program i's result to bit i of `out` (v3SignalWordCount(count)
+// words). Bit-exact with evalV3ConditionProgram(...) on every program.
+void evalV3ConditionBatch(const V3ConditionBatchView& batch,
+                          const V3SignalStoreView& signals, uint32_t* out);
@@ -0,0 +1,68 @@
+#include "kernel/v3_condition_eval.h"
+
+#include "kernel/v3_status_runtime.h"
+
+bool evalV3ConditionOperator(const V3RuntimeSignal& target, logicOperator op,
+                             uint32_t threshold) {
+  switch (op) {
+    case Op_AlwaysTrue:
+      return true;
+    case Op_AlwaysFalse:
+      return false;
+    case Op_LogicalTrue:
+      return target.logicalState;
+    case Op_LogicalFalse:
+      return !target.logicalState;
+    case Op_PhysicalOn:
+      return target.physicalState;
+    case Op_PhysicalOff:
+      return !target.physicalState;
+    case Op_Triggered:
+      return target.triggerFlag;
+    case Op_TriggerCleared:
+      return !target.triggerFlag;
+    case Op_GT:
+      return target.currentValue > threshold;
+    case Op_LT:
+      return target.currentValue < threshold;
+    case Op_EQ:
+      return target.currentValue == threshold;
+    case Op_NEQ:
+      return target.currentValue != threshold;
+    case Op_GTE:
+      return target.currentValue >= threshold;
+    case Op_LTE:
+      return target.currentValue <= threshold;
+    case Op_Running:
+      return isMissionRunning(target.type, target.state);
+    case Op_Finished:
+      return isMissionFinished(target.type, target.state);
+    case Op_Stopped:
+      return isMissionStopped(target.type, target.state);
+    default:
+      return false;
+  }
+}
+
+bool evalV3ConditionBlock(const V3ConditionBlock& block,
+                          const V3RuntimeSignal* signals, uint8_t count) {
+  if (signals == nullptr) return false;
+  const bool aResult =
+      (block.clauseAId < count)
+          ? evalV3ConditionOperator(signals[block.clauseAId],
+                                    block.clauseAOperator,
+                                    block.clauseAThreshold)
+          : false;
+  if (block.combiner == Combine_None) return aResult;
+
+  const bool bResult =
+      (block.clauseBId < count)
+          ? evalV3ConditionOperator(signals[block.clauseBId],
+                                    block.clauseBOperator,
+                                    block.clauseBThreshold)
+          : false;
+
+  if (block.combiner == Combine_AND) return aResult && bResult;
+  if (block.combiner == Combine_OR) return aResult || bResult;
+  return false;
+}
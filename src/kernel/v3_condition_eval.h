@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/v3_card_types.h"
+#include "kernel/v3_runtime_signals.h"
+
+bool evalV3ConditionOperator(const V3RuntimeSignal& target, logicOperator op,
+                             uint32_t threshold);
+bool evalV3ConditionBlock(const V3ConditionBlock& block,
+                          const V3RuntimeSignal* signals, uint8_t count);
@@ -0,0 +1,111 @@
+#include "kernel/v3_condition_program.h"
+
+namespace {
+V3ConditionInstr constantInstr(bool value) {
+  V3ConditionInstr instr = {};
+  instr.opcode = value ? CondOp_True : CondOp_False;
+  return instr;
+}
+
+bool isMissionSource(logicCardType type) {
+  return type == DigitalOutput || type == SoftIO;
+}
+
+V3ConditionInstr compileClause(uint8_t sourceId, logicOperator op,
+                               uint32_t threshold, const RuntimeCardMeta* meta,
+                               uint8_t count) {
+  if (sourceId >= count || meta == nullptr) return constantInstr(false);
+  if (op == Op_AlwaysTrue) return constantInstr(true);
+
+  V3ConditionInstr instr = {};
+  instr.source = sourceId;
+  instr.threshold = threshold;
+  switch (op) {
+    case Op_LogicalTrue:
+      instr.opcode = CondOp_Logical;
+      return instr;
+    case Op_LogicalFalse:
+      instr.opcode = CondOp_NotLogical;
+      return instr;
+    case Op_PhysicalOn:
+      instr.opcode = CondOp_Physical;
+      return instr;
+    case Op_PhysicalOff:
+      instr.opcode = CondOp_NotPhysical;
+      return instr;
+    case Op_Triggered:
+      instr.opcode = CondOp_Triggered;
+      return instr;
+    case Op_TriggerCleared:
+      instr.opcode = CondOp_NotTriggered;
+      return instr;
+    case Op_GT:
+      instr.opcode = CondOp_GT;
+      return instr;
+    case Op_LT:
+      instr.opcode = CondOp_LT;
+      return instr;
+    case Op_EQ:
+      instr.opcode = CondOp_EQ;
+      return instr;
+    case Op_NEQ:
+      instr.opcode = CondOp_NEQ;
+      return instr;
+    case Op_GTE:
+      instr.opcode = CondOp_GTE;
+      return instr;
+    case Op_LTE:
+      instr.opcode = CondOp_LTE;
+      return instr;
+    case Op_Running:
+      if (!isMissionSource(meta[sourceId].type)) return constantInstr(false);
+      instr.opcode = CondOp_StateEither;
+      instr.stateA = State_DO_OnDelay;
+      instr.stateB = State_DO_Active;
+      return instr;
+    case Op_Finished:
+      if (!isMissionSource(meta[sourceId].type)) return constantInstr(false);
+      instr.opcode = CondOp_StateEq;
+      instr.stateA = State_DO_Finished;
+      return instr;
+    case Op_Stopped:
+      if (!isMissionSource(meta[sourceId].type)) return constantInstr(false);
+      instr.opcode = CondOp_StateEither;
+      instr.stateA = State_DO_Idle;
+      instr.stateB = State_DO_Finished;
+      return instr;
+    default:
+      return constantInstr(false);
+  }
+}
+}  // namespace
+
+V3ConditionProgram compileV3ConditionProgram(const V3ConditionBlock& block,
+                                             const RuntimeCardMeta* meta,
+                                             uint8_t count) {
+  V3ConditionProgram program = {};
+  program.a = compileClause(block.clauseAId, block.clauseAOperator,
+                            block.clauseAThreshold, meta, count);
+  switch (block.combiner) {
+    case Combine_None:
+      program.b = constantInstr(true);
+      program.anyOf = false;
+      break;
+    case Combine_AND:
+      program.b = compileClause(block.clauseBId, block.clauseBOperator,
+                                block.clauseBThreshold, meta, count);
+      program.anyOf = false;
+      break;
+    case Combine_OR:
+      program.b = compileClause(block.clauseBId, block.clauseBOperator,
+                                block.clauseBThreshold, meta, count);
+      program.anyOf = true;
+      break;
+    default:
+      program.a = constantInstr(false);
+      program.b = constantInstr(false);
+      program.anyOf = false;
+      break;
+  }
+  return program;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/v3_card_types.h"
+#include "kernel/v3_runtime_signals.h"
+#include "runtime/runtime_card_meta.h"
+
+enum V3ConditionOpcode : uint8_t {
+  CondOp_False,
+  CondOp_True,
+  CondOp_Logical,
+  CondOp_NotLogical,
+  CondOp_Physical,
+  CondOp_NotPhysical,
+  CondOp_Triggered,
+  CondOp_NotTriggered,
+  CondOp_GT,
+  CondOp_LT,
+  CondOp_EQ,
+  CondOp_NEQ,
+  CondOp_GTE,
+  CondOp_LTE,
+  CondOp_StateEq,
+  CondOp_StateEither
+};
+
+// One pre-validated clause. `source` is always a valid signal index and
+// mission operators are already lowered to state compares, so the
+// interpreter needs no range or type checks.
+struct V3ConditionInstr {
+  uint8_t source;
+  V3ConditionOpcode opcode;
+  uint8_t stateA;
+  uint8_t stateB;
+  uint32_t threshold;
+};
+
+struct V3ConditionProgram {
+  V3ConditionInstr a;
+  V3ConditionInstr b;
+  bool anyOf;
+};
+
+V3ConditionProgram compileV3ConditionProgram(const V3ConditionBlock& block,
+                                             const RuntimeCardMeta* meta,
+                                             uint8_t count);
+
+inline bool evalV3ConditionInstr(const V3ConditionInstr& instr,
+                                 const V3SignalStoreView& signals) {
+  const uint8_t id = instr.source;
+  switch (instr.opcode) {
+    case CondOp_True:
+      return true;
+    case CondOp_Logical:
+      return v3SignalBit(signals.logical, id);
+    case CondOp_NotLogical:
+      return !v3SignalBit(signals.logical, id);
+    case CondOp_Physical:
+      return v3SignalBit(signals.physical, id);
+    case CondOp_NotPhysical:
+      return !v3SignalBit(signals.physical, id);
+    case CondOp_Triggered:
+      return v3SignalBit(signals.trigger, id);
+    case CondOp_NotTriggered:
+      return !v3SignalBit(signals.trigger, id);
+    case CondOp_GT:
+      return signals.currentValue[id] > instr.threshold;
+    case CondOp_LT:
+      return signals.currentValue[id] < instr.threshold;
+    case CondOp_EQ:
+      return signals.currentValue[id] == instr.threshold;
+    case CondOp_NEQ:
+      return signals.currentValue[id] != instr.threshold;
+    case CondOp_GTE:
+      return signals.currentValue[id] >= instr.threshold;
+    case CondOp_LTE:
+      return signals.currentValue[id] <= instr.threshold;
+    case CondOp_StateEq:
+      return signals.state[id] == instr.stateA;
+    case CondOp_StateEither:
+      return signals.state[id] == instr.stateA ||
+             signals.state[id] == instr.stateB;
+    default:
+      return false;
+  }
+}
+
+inline bool evalV3ConditionProgram(const V3ConditionProgram& program,
+                                   const V3SignalStoreView& signals) {
+  const bool aResult = evalV3ConditionInstr(program.a, signals);
+  if (program.anyOf) return aResult || evalV3ConditionInstr(program.b, signals);
+  return aResult && evalV3ConditionInstr(program.b, signals);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/v3_card_layout.h"
+#include "kernel/v3_scan_plan.h"
+
+// Build-time hardware profile (`docs/hardware-profile-v3.md`). `Board`
+// supplies channel arrays `kDiPins`/`kDoPins`/`kAiPins` and capacities
+// `kDi|Do|Ai|Sio|Math|RtcCapacity`; everything else is derived here so
+// array sizes and family ranges are compile-time constants.
+template <typename Board>
+struct V3HardwareProfile {
+  using BoardType = Board;
+
+  static constexpr uint8_t kDiCount = Board::kDiCapacity;
+  static constexpr uint8_t kDoCount = Board::kDoCapacity;
+  static constexpr uint8_t kAiCount = Board::kAiCapacity;
+  static constexpr uint8_t kSioCount = Board::kSioCapacity;
+  static constexpr uint8_t kMathCount = Board::kMathCapacity;
+  static constexpr uint8_t kRtcCount = Board::kRtcCapacity;
+
+  static_assert(sizeof(Board::kDiPins) >= kDiCount,
+                "DI capacity exceeds DI channel array");
+  static_assert(sizeof(Board::kDoPins) >= kDoCount,
+                "DO capacity exceeds DO channel array");
+  static_assert(sizeof(Board::kAiPins) >= kAiCount,
+                "AI capacity exceeds AI channel array");
+  static_assert(static_cast<uint16_t>(kDiCount) + kDoCount + kAiCount +
+                        kSioCount + kMathCount + kRtcCount <=
+                    kV3MaxCards,
+                "hardware profile exceeds 255 cards");
+
+  static constexpr uint8_t kDiStart = 0;
+  static constexpr uint8_t kDoStart = kDiStart + kDiCount;
+  static constexpr uint8_t kAiStart = kDoStart + kDoCount;
+  static constexpr uint8_t kSioStart = kAiStart + kAiCount;
+  static constexpr uint8_t kMathStart = kSioStart + kSioCount;
+  static constexpr uint8_t kRtcStart = kMathStart + kMathCount;
+  static constexpr uint8_t kTotalCards = kRtcStart + kRtcCount;
+  static_assert(kTotalCards > 0, "hardware profile has no cards");
+
+  static constexpr V3CardLayout kLayout = {kTotalCards, kDoStart,  kAiStart,
+                                           kSioStart,   kMathStart, kRtcStart};
+
+  static constexpr V3CardFamily familyForId(uint8_t id) {
+    return v3CardFamilyForId(kLayout, id);
+  }
+  static constexpr logicCardType typeForId(uint8_t id) {
+    return v3CardTypeForId(kLayout, id);
+  }
+  static V3ScanPlanPins scanPlanPins() {
+    return {Board::kDiPins, kDiCount, Board::kDoPins,
+            kDoCount,       Board::kAiPins, kAiCount};
+  }
+};
+
+template <typename Board>
+constexpr V3CardLayout V3HardwareProfile<Board>::kLayout;
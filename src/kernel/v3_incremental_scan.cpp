@@ -0,0 +1,115 @@
+#include "kernel/v3_incremental_scan.h"
+
+namespace {
+void appendSource(const V3ConditionInstr& instr, uint8_t count,
+                  uint8_t* sources, uint8_t& sourceCount) {
+  if (instr.opcode == CondOp_False || instr.opcode == CondOp_True) return;
+  if (instr.source >= count) return;
+  for (uint8_t i = 0; i < sourceCount; ++i) {
+    if (sources[i] == instr.source) return;
+  }
+  sources[sourceCount++] = instr.source;
+}
+
+uint8_t collectSources(const V3ScanPlanEntry& entry, uint8_t count,
+                       uint8_t* sources) {
+  uint8_t sourceCount = 0;
+  appendSource(entry.set.a, count, sources, sourceCount);
+  appendSource(entry.set.b, count, sources, sourceCount);
+  appendSource(entry.reset.a, count, sources, sourceCount);
+  appendSource(entry.reset.b, count, sources, sourceCount);
+  return sourceCount;
+}
+
+uint32_t deadlineAfter(uint32_t startMs, uint32_t durationMs, uint32_t nowMs) {
+  const uint32_t elapsed = nowMs - startMs;
+  if (elapsed >= durationMs) return nowMs;
+  uint32_t remaining = durationMs - elapsed;
+  if (remaining > kV3MaxTimerWaitMs) remaining = kV3MaxTimerWaitMs;
+  return nowMs + remaining;
+}
+
+template <typename MissionState, typename MissionConfig>
+bool missionDeadline(const MissionState& runtime, const MissionConfig& cfg,
+                     uint32_t nowMs, uint32_t& dueMs) {
+  if (runtime.state == State_DO_OnDelay && cfg.delayBeforeOnMs > 0) {
+    dueMs = deadlineAfter(runtime.startOnMs, cfg.delayBeforeOnMs, nowMs);
+    return true;
+  }
+  if (runtime.state == State_DO_Active && cfg.onDurationMs > 0) {
+    dueMs = deadlineAfter(runtime.startOffMs, cfg.onDurationMs, nowMs);
+    return true;
+  }
+  return false;
+}
+}  // namespace
+
+void buildV3DependencyIndex(const V3ScanPlanEntry* plan, uint8_t count,
+                            V3DependencyIndexView& out) {
+  if (out.offsets == nullptr) return;
+  for (uint16_t i = 0; i <= count; ++i) out.offsets[i] = 0;
+  out.count = count;
+  if (plan == nullptr || out.dependents == nullptr) return;
+
+  uint8_t sources[kV3MaxSourcesPerCard] = {};
+  for (uint8_t i = 0; i < count; ++i) {
+    const uint8_t n = collectSources(plan[i], count, sources);
+    for (uint8_t i = 0; i < n; ++i) out.offsets[sources[i]] += 1;
+  }
+
+  uint16_t running = 0;
+  for (uint8_t s = 0; s < count; ++s) {
+    running = static_cast<uint16_t>(running + out.offsets[s]);
+    out.offsets[s] = running;
+  }
+  out.offsets[count] = running;
+
+  // Reverse fill leaves offsets[s] at the start of its range and keeps each
+  // dependents range in plan order.
+  for (uint8_t i = count; i > 0; --i) {
+    const V3ScanPlanEntry& entry = plan[i - 1];
+    const uint8_t dependent = entry.cardId;
+    const uint8_t n = collectSources(entry, count, sources);
+    for (uint8_t i = 0; i < n; ++i) {
+      out.offsets[sources[i]] -= 1;
+      out.dependents[out.offsets[sources[i]]] = dependent;
+    }
+  }
+}
+
+void markV3SignalChanged(const V3DependencyIndexView& index, uint8_t source,
+                         bool* dirty) {
+  if (dirty == nullptr || source >= index.count) return;
+  // A card whose own signal moved may not be at its fixpoint yet.
+  dirty[source] = true;
+  if (index.offsets == nullptr || index.dependents == nullptr) return;
+  for (uint16_t i = index.offsets[source]; i < index.offsets[source + 1]; ++i) {
+    dirty[index.dependents[i]] = true;
+  }
+}
+
+bool v3ScanPlanEntryNextDeadline(const V3ScanPlanEntry& entry, uint32_t nowMs,
+                                 uint32_t& dueMs) {
+  if (entry.runtime.any == nullptr) return false;
+  switch (entry.family) {
+    case V3CardFamily::DO:
+      return missionDeadline(*entry.runtime.dOut, entry.config.dOut, nowMs,
+                             dueMs);
+    case V3CardFamily::SIO:
+      return missionDeadline(*entry.runtime.sio, entry.config.sio, nowMs,
+                             dueMs);
+    case V3CardFamily::RTC: {
+      const V3RtcRuntimeState& runtime = *entry.runtime.rtc;
+      if (!runtime.logicalState || entry.config.rtc.triggerDurationMs == 0) {
+        return false;
+      }
+      dueMs = deadlineAfter(runtime.triggerStartMs,
+                            entry.config.rtc.triggerDurationMs, nowMs);
+      return true;
+    }
+    default:
+      // DI debounce only gates edges, so DI/AI change state only on a new
+      // sample; MATH is a pure function of its conditions.
+      return false;
+  }
+}
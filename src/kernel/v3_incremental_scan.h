@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/v3_runtime_signals.h"
+#include "kernel/v3_scan_plan.h"
+
+// Set A/B + reset A/B clause sources.
+constexpr uint8_t kV3MaxSourcesPerCard = 4;
+
+// Reverse dependency index in CSR form: cards reading signal `s` are
+// dependents[offsets[s] .. offsets[s + 1]). Storage is caller-owned;
+// `dependents` must hold count * kV3MaxSourcesPerCard entries.
+struct V3DependencyIndexView {
+  uint16_t* offsets;
+  uint8_t* dependents;
+  uint8_t count;
+};
+
+// Indexes signals and dependents by each entry's card id, so any plan
+// order works.
+void buildV3DependencyIndex(const V3ScanPlanEntry* plan, uint8_t count,
+                            V3DependencyIndexView& out);
+void markV3SignalChanged(const V3DependencyIndexView& index, uint8_t source,
+                         bool* dirty);
+// Next time the card's state can change with unchanged inputs (DO/SIO
+// delay/on-duration expiry, RTC trigger window). Waits are clamped to
+// kV3MaxTimerWaitMs so deadlines stay orderable on the wrapping ms clock.
+constexpr uint32_t kV3MaxTimerWaitMs = 0x7FFFFFFFUL;
+bool v3ScanPlanEntryNextDeadline(const V3ScanPlanEntry& entry, uint32_t nowMs,
+                                 uint32_t& dueMs);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// Hardware access used by the scan engine. Digital I/O moves as whole
+// process images (bit n = GPIO n); `context` is handed back to every call.
+struct V3IoBackend {
+  void* context;
+  uint64_t (*readDigitalInputs)(void* context);
+  uint32_t (*readAnalogInput)(void* context, uint8_t pin);
+  void (*writeDigitalOutputs)(void* context, uint64_t setMask,
+                              uint64_t clearMask);
+};
@@ -0,0 +1,27 @@
+#include "kernel/v3_io_image.h"
+
+uint64_t v3IoImagePinMask(uint8_t pin) {
+  if (pin >= kV3IoImagePins) return 0;
+  return static_cast<uint64_t>(1) << pin;
+}
+
+bool v3InputImageLevel(const V3InputImage& image, uint8_t pin) {
+  return (image.levels & v3IoImagePinMask(pin)) != 0;
+}
+
+void writeV3OutputImage(V3OutputImage& image, uint8_t pin, bool high) {
+  const uint64_t mask = v3IoImagePinMask(pin);
+  if (high) {
+    image.levels |= mask;
+  } else {
+    image.levels &= ~mask;
+  }
+  image.driven |= mask;
+}
+
+void takeV3OutputLatch(V3OutputImage& image, uint64_t& setMask,
+                       uint64_t& clearMask) {
+  setMask = image.levels & image.driven;
+  clearMask = ~image.levels & image.driven;
+  image.driven = 0;
+}
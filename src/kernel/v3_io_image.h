@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+// PLC-style process image: inputs are captured once per scan, outputs are
+// staged during the scan and latched together at scan end. Bit n is GPIO n.
+constexpr uint8_t kV3IoImagePins = 64;
+
+struct V3InputImage {
+  uint64_t levels;
+};
+
+struct V3OutputImage {
+  uint64_t levels;
+  uint64_t driven;  // pins written since the last latch
+};
+
+uint64_t v3IoImagePinMask(uint8_t pin);
+bool v3InputImageLevel(const V3InputImage& image, uint8_t pin);
+void writeV3OutputImage(V3OutputImage& image, uint8_t pin, bool high);
+// Returns the pins to set and clear for everything driven since the last
+// latch, then starts a new latch window.
+void takeV3OutputLatch(V3OutputImage& image, uint64_t& setMask,
+                       uint64_t& clearMask);
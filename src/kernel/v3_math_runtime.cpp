@@ -3,7 +3,7 @@
 #include <limits.h>
 
 namespace {
-uint32_t clampUInt32(uint32_t value, uint32_t lo, uint32_t hi) {
+uint32_t clampMathValue(uint32_t value, uint32_t lo, uint32_t hi) {
   if (value < lo) return lo;
   if (value > hi) return hi;
   return value;
@@ -42,7 +42,7 @@ void runV3MathStep(const V3MathRuntimeConfig& cfg, V3MathRuntimeState& runtime,
   uint32_t value =
       (raw > static_cast<uint64_t>(UINT32_MAX)) ? UINT32_MAX : static_cast<uint32_t>(raw);
   if (cfg.clampEnabled) {
-    value = clampUInt32(value, cfg.clampMin, cfg.clampMax);
+    value = clampMathValue(value, cfg.clampMin, cfg.clampMax);
   }
   runtime.currentValue = value;
   runtime.state = State_None;
@@ -5,17 +5,6 @@
 #include "kernel/v3_condition_rules.h"
 
 namespace {
-logicCardType expectedTypeForId(uint8_t id, uint8_t doStart, uint8_t aiStart,
-                                uint8_t sioStart, uint8_t mathStart,
-                                uint8_t rtcStart) {
-  if (id < doStart) return DigitalInput;
-  if (id < aiStart) return DigitalOutput;
-  if (id < sioStart) return AnalogInput;
-  if (id < mathStart) return SoftIO;
-  if (id < rtcStart) return MathCard;
-  return RtcCard;
-}
-
 bool validateClause(JsonObjectConst clause, const logicCardType* sourceTypeById,
                     uint8_t totalCards, std::string& reason,
                     const char* clauseName) {
@@ -89,10 +78,10 @@ bool validateConditionBlock(JsonObjectConst block, const logicCardType* sourceTy
 }
 }  // namespace
 
-bool validateV3PayloadConditionSources(JsonArrayConst cards, uint8_t totalCards,
-                                       uint8_t doStart, uint8_t aiStart,
-                                       uint8_t sioStart, uint8_t mathStart,
-                                       uint8_t rtcStart, std::string& reason) {
+bool validateV3PayloadConditionSources(JsonArrayConst cards,
+                                       const V3CardLayout& layout,
+                                       std::string& reason) {
+  const uint8_t totalCards = layout.totalCards;
   if (cards.size() == 0) {
     reason = "cards array empty";
     return false;
@@ -101,11 +90,6 @@ bool validateV3PayloadConditionSources(JsonArrayConst cards, uint8_t totalCards,
   bool seen[255] = {};
   logicCardType sourceTypeById[255] = {};
 
-  if (totalCards > 255) {
-    reason = "totalCards exceeds validator capacity";
-    return false;
-  }
-
   for (JsonVariantConst v : cards) {
     if (!v.is<JsonObjectConst>()) {
       reason = "cards[] item is not object";
@@ -127,8 +111,7 @@ bool validateV3PayloadConditionSources(JsonArrayConst cards, uint8_t totalCards,
       reason = "invalid cardType token";
       return false;
     }
-    logicCardType expected =
-        expectedTypeForId(id, doStart, aiStart, sioStart, mathStart, rtcStart);
+    logicCardType expected = v3CardTypeForId(layout, id);
     if (parsed != expected) {
       reason = "cardType does not match family slot";
       return false;
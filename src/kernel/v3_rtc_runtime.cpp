@@ -22,6 +22,15 @@ void runV3RtcStep(const V3RtcRuntimeConfig& cfg, V3RtcRuntimeState& runtime,
   }
 }
 
+void applyV3RtcCardState(V3RtcRuntimeState& runtime, bool state,
+                         uint32_t nowMs) {
+  runtime.logicalState = state;
+  runtime.physicalState = state;
+  runtime.triggerFlag = state;  // one-minute assertion edge for condition logic
+  runtime.currentValue = state ? 1U : 0U;
+  runtime.triggerStartMs = state ? nowMs : 0;
+}
+
 bool v3RtcFieldMatches(int fieldValue, int scheduleValue) {
   return scheduleValue < 0 || fieldValue == scheduleValue;
 }
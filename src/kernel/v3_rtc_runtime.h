@@ -44,6 +44,10 @@ struct V3RtcStepInput {
 
 void runV3RtcStep(const V3RtcRuntimeConfig& cfg, V3RtcRuntimeState& runtime,
                   const V3RtcStepInput& in);
+// Applies a scheduler assertion (`true` opens the trigger window at `nowMs`)
+// or the per-minute clear.
+void applyV3RtcCardState(V3RtcRuntimeState& runtime, bool state,
+                         uint32_t nowMs);
 
 bool v3RtcFieldMatches(int fieldValue, int scheduleValue);
 bool v3RtcChannelMatchesMinute(const V3RtcScheduleView& channel,
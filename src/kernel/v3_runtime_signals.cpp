@@ -1,5 +1,7 @@
 #include "kernel/v3_runtime_signals.h"
 
+#include <string.h>
+
 V3RuntimeSignal makeRuntimeSignal(const RuntimeCardMeta& meta,
                                   const V3RuntimeStoreView& store) {
   V3RuntimeSignal signal = {};
@@ -71,18 +73,91 @@ V3RuntimeSignal makeRuntimeSignal(const RuntimeCardMeta& meta,
   }
 }
 
+V3RuntimeSignal v3SignalAt(const V3SignalStoreView& signals,
+                           logicCardType type, uint8_t cardId) {
+  V3RuntimeSignal signal = {};
+  signal.type = type;
+  if (cardId >= signals.count) return signal;
+  signal.state = static_cast<cardState>(signals.state[cardId]);
+  signal.logicalState = v3SignalBit(signals.logical, cardId);
+  signal.physicalState = v3SignalBit(signals.physical, cardId);
+  signal.triggerFlag = v3SignalBit(signals.trigger, cardId);
+  signal.currentValue = signals.currentValue[cardId];
+  return signal;
+}
+
+bool writeV3Signal(V3SignalStoreView& signals, uint8_t cardId,
+                   const V3RuntimeSignal& signal) {
+  if (cardId >= signals.count) return false;
+  const uint8_t state = static_cast<uint8_t>(signal.state);
+  const bool changed =
+      signals.state[cardId] != state ||
+      signals.currentValue[cardId] != signal.currentValue ||
+      v3SignalBit(signals.logical, cardId) != signal.logicalState ||
+      v3SignalBit(signals.physical, cardId) != signal.physicalState ||
+      v3SignalBit(signals.trigger, cardId) != signal.triggerFlag;
+  signals.state[cardId] = state;
+  signals.currentValue[cardId] = signal.currentValue;
+  setV3SignalBit(signals.logical, cardId, signal.logicalState);
+  setV3SignalBit(signals.physical, cardId, signal.physicalState);
+  setV3SignalBit(signals.trigger, cardId, signal.triggerFlag);
+  return changed;
+}
+
+void recordV3ConditionResults(V3SignalStoreView& signals, uint8_t cardId,
+                              bool setResult, bool resetResult,
+                              bool resetOverride) {
+  setV3SignalBit(signals.setResult, cardId, setResult);
+  setV3SignalBit(signals.resetResult, cardId, resetResult);
+  setV3SignalBit(signals.resetOverride, cardId, resetOverride);
+}
+
+void clearV3SignalStore(V3SignalStoreView& signals) {
+  const uint16_t words = v3SignalWordCount(signals.count);
+  for (uint16_t w = 0; w < words; ++w) {
+    signals.logical[w] = 0;
+    signals.physical[w] = 0;
+    signals.trigger[w] = 0;
+    signals.setResult[w] = 0;
+    signals.resetResult[w] = 0;
+    signals.resetOverride[w] = 0;
+  }
+  for (uint8_t i = 0; i < signals.count; ++i) {
+    signals.state[i] = 0;
+    signals.currentValue[i] = 0;
+    signals.evalCounter[i] = 0;
+  }
+}
+
+void copyV3SignalStore(const V3SignalStoreView& source,
+                       V3SignalStoreView& out) {
+  const uint8_t count = source.count < out.count ? source.count : out.count;
+  const size_t wordBytes = v3SignalWordCount(count) * sizeof(uint32_t);
+  memcpy(out.logical, source.logical, wordBytes);
+  memcpy(out.physical, source.physical, wordBytes);
+  memcpy(out.trigger, source.trigger, wordBytes);
+  memcpy(out.setResult, source.setResult, wordBytes);
+  memcpy(out.resetResult, source.resetResult, wordBytes);
+  memcpy(out.resetOverride, source.resetOverride, wordBytes);
+  memcpy(out.state, source.state, count * sizeof(out.state[0]));
+  memcpy(out.currentValue, source.currentValue,
+         count * sizeof(out.currentValue[0]));
+  memcpy(out.evalCounter, source.evalCounter,
+         count * sizeof(out.evalCounter[0]));
+}
+
 void refreshRuntimeSignalsFromRuntime(const RuntimeCardMeta* cardsMeta,
                                       const V3RuntimeStoreView& store,
-                                      V3RuntimeSignal* out, uint8_t count) {
-  for (uint8_t i = 0; i < count; ++i) {
-    out[i] = makeRuntimeSignal(cardsMeta[i], store);
+                                      V3SignalStoreView& out) {
+  for (uint8_t i = 0; i < out.count; ++i) {
+    writeV3Signal(out, i, makeRuntimeSignal(cardsMeta[i], store));
   }
 }
 
-void refreshRuntimeSignalAt(const RuntimeCardMeta* cardsMeta,
+bool refreshRuntimeSignalAt(const RuntimeCardMeta* cardsMeta,
                             const V3RuntimeStoreView& store,
-                            V3RuntimeSignal* out, uint8_t count,
-                            uint8_t cardId) {
-  if (cardId >= count) return;
-  out[cardId] = makeRuntimeSignal(cardsMeta[cardId], store);
+                            V3SignalStoreView& out, uint8_t cardId) {
+  if (cardId >= out.count) return false;
+  return writeV3Signal(out, cardId,
+                       makeRuntimeSignal(cardsMeta[cardId], store));
 }
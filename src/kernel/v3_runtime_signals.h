@@ -1,11 +1,14 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "kernel/card_model.h"
 #include "kernel/v3_runtime_store.h"
 #include "runtime/runtime_card_meta.h"
 
+// One card's condition-visible signal gathered from the runtime store.
+// Value type only; the scan keeps signals in `V3SignalStoreView`.
 struct V3RuntimeSignal {
   logicCardType type;
   cardState state;
@@ -15,12 +18,86 @@ struct V3RuntimeSignal {
   uint32_t currentValue;
 };
 
+constexpr uint16_t v3SignalWordCount(uint16_t cards) {
+  return static_cast<uint16_t>((cards + 31) / 32);
+}
+
+// Per-card scan state in struct-of-arrays form: flags are packed one bit
+// per card id, values and states are contiguous. Condition evaluation,
+// change detection and snapshot publishing all read this store; storage
+// is caller-owned (`V3SignalStorage<N>`).
+struct V3SignalStoreView {
+  uint8_t count;
+  uint32_t* logical;
+  uint32_t* physical;
+  uint32_t* trigger;
+  uint32_t* setResult;
+  uint32_t* resetResult;
+  uint32_t* resetOverride;
+  uint8_t* state;  // cardState
+  uint32_t* currentValue;
+  uint32_t* evalCounter;
+};
+
+template <size_t N>
+struct V3SignalStorage {
+  uint32_t logical[v3SignalWordCount(N)];
+  uint32_t physical[v3SignalWordCount(N)];
+  uint32_t trigger[v3SignalWordCount(N)];
+  uint32_t setResult[v3SignalWordCount(N)];
+  uint32_t resetResult[v3SignalWordCount(N)];
+  uint32_t resetOverride[v3SignalWordCount(N)];
+  uint8_t state[N];
+  uint32_t currentValue[N];
+  uint32_t evalCounter[N];
+};
+
+template <size_t N>
+V3SignalStoreView makeV3SignalStoreView(V3SignalStorage<N>& storage,
+                                        uint8_t count) {
+  return {count < N ? count : static_cast<uint8_t>(N),
+          storage.logical,
+          storage.physical,
+          storage.trigger,
+          storage.setResult,
+          storage.resetResult,
+          storage.resetOverride,
+          storage.state,
+          storage.currentValue,
+          storage.evalCounter};
+}
+
+inline bool v3SignalBit(const uint32_t* bits, uint8_t cardId) {
+  return ((bits[cardId >> 5] >> (cardId & 31U)) & 1U) != 0;
+}
+
+inline void setV3SignalBit(uint32_t* bits, uint8_t cardId, bool value) {
+  const uint32_t mask = 1UL << (cardId & 31U);
+  if (value) {
+    bits[cardId >> 5] |= mask;
+  } else {
+    bits[cardId >> 5] &= ~mask;
+  }
+}
+
 V3RuntimeSignal makeRuntimeSignal(const RuntimeCardMeta& meta,
                                   const V3RuntimeStoreView& store);
+V3RuntimeSignal v3SignalAt(const V3SignalStoreView& signals,
+                           logicCardType type, uint8_t cardId);
+// Returns true when any stored field changed.
+bool writeV3Signal(V3SignalStoreView& signals, uint8_t cardId,
+                   const V3RuntimeSignal& signal);
+void recordV3ConditionResults(V3SignalStoreView& signals, uint8_t cardId,
+                              bool setResult, bool resetResult,
+                              bool resetOverride);
+void clearV3SignalStore(V3SignalStoreView& signals);
+// Copies min(source.count, out.count) cards; used to publish snapshots.
+void copyV3SignalStore(const V3SignalStoreView& source,
+                       V3SignalStoreView& out);
 void refreshRuntimeSignalsFromRuntime(const RuntimeCardMeta* cardsMeta,
                                       const V3RuntimeStoreView& store,
-                                      V3RuntimeSignal* out, uint8_t count);
-void refreshRuntimeSignalAt(const RuntimeCardMeta* cardsMeta,
+                                      V3SignalStoreView& out);
+// Returns true when the card's signal changed.
+bool refreshRuntimeSignalAt(const RuntimeCardMeta* cardsMeta,
                             const V3RuntimeStoreView& store,
-                            V3RuntimeSignal* out, uint8_t count,
-                            uint8_t cardId);
+                            V3SignalStoreView& out, uint8_t cardId);
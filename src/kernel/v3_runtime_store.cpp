@@ -48,17 +48,17 @@ void syncRuntimeStoreFromTypedCards(const LogicCard* cards,
     const V3CardConfig& typed = typedCards[i];
     switch (typed.family) {
       case V3CardFamily::DI: {
-        V3DiRuntimeState* state = runtimeDiStateAt(typed.di.channel, store);
+        V3DiRuntimeState* state = runtimeDiStateAt(typed.asDi().channel, store);
         if (state != nullptr) *state = makeDiRuntimeState(card);
         break;
       }
       case V3CardFamily::DO: {
-        V3DoRuntimeState* state = runtimeDoStateAt(typed.dout.channel, store);
+        V3DoRuntimeState* state = runtimeDoStateAt(typed.asDo().channel, store);
         if (state != nullptr) *state = makeDoRuntimeState(card);
         break;
       }
       case V3CardFamily::AI: {
-        V3AiRuntimeState* state = runtimeAiStateAt(typed.ai.channel, store);
+        V3AiRuntimeState* state = runtimeAiStateAt(typed.asAi().channel, store);
         if (state != nullptr) *state = makeAiRuntimeState(card);
         break;
       }
@@ -88,18 +88,20 @@ void mirrorRuntimeStoreCardToLegacyByTyped(LogicCard& card,
                                            const V3RuntimeStoreView& store) {
   switch (typedCard.family) {
     case V3CardFamily::DI: {
-      const V3DiRuntimeState* state = runtimeDiStateAt(typedCard.di.channel, store);
+      const V3DiRuntimeState* state =
+          runtimeDiStateAt(typedCard.asDi().channel, store);
       if (state != nullptr) applyDiRuntimeState(card, *state);
       break;
     }
     case V3CardFamily::DO: {
       const V3DoRuntimeState* state =
-          runtimeDoStateAt(typedCard.dout.channel, store);
+          runtimeDoStateAt(typedCard.asDo().channel, store);
       if (state != nullptr) applyDoRuntimeState(card, *state);
       break;
     }
     case V3CardFamily::AI: {
-      const V3AiRuntimeState* state = runtimeAiStateAt(typedCard.ai.channel, store);
+      const V3AiRuntimeState* state =
+          runtimeAiStateAt(typedCard.asAi().channel, store);
       if (state != nullptr) applyAiRuntimeState(card, *state);
       break;
     }
@@ -0,0 +1,256 @@
+#include "kernel/v3_scan_engine.h"
+
+#include "kernel/v3_ai_runtime.h"
+#include "kernel/v3_condition_program.h"
+#include "kernel/v3_di_runtime.h"
+#include "kernel/v3_do_runtime.h"
+#include "kernel/v3_math_runtime.h"
+#include "kernel/v3_rtc_runtime.h"
+#include "kernel/v3_sio_runtime.h"
+
+namespace {
+void recordConditions(V3ScanEngine& engine, uint8_t cardId, bool setCondition,
+                      bool resetCondition) {
+  recordV3ConditionResults(engine.signals, cardId, setCondition,
+                           resetCondition, setCondition && resetCondition);
+}
+
+uint32_t readInputSample(const V3ScanEngine& engine,
+                         const V3ScanPlanEntry& entry) {
+  const inputSourceMode sourceMode = engine.inputSource[entry.cardId];
+  if (entry.family == V3CardFamily::DI) {
+    bool sample = false;
+    if (sourceMode == InputSource_ForcedHigh) {
+      sample = true;
+    } else if (sourceMode == InputSource_ForcedLow) {
+      sample = false;
+    } else {
+      sample = v3InputImageLevel(engine.inputImage, entry.hwPin);
+    }
+    if (entry.invert) sample = !sample;
+    return sample ? 1U : 0U;
+  }
+  if (sourceMode == InputSource_ForcedValue) {
+    return engine.forcedAIValue[entry.cardId];
+  }
+  if (entry.hwPin == kV3ScanPlanNoPin || engine.io.readAnalogInput == nullptr) {
+    return 0;
+  }
+  return engine.io.readAnalogInput(engine.io.context, entry.hwPin);
+}
+
+void processDICard(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                   uint32_t nowMs) {
+  const uint8_t cardId = entry.cardId;
+
+  V3DiStepInput in = {};
+  in.nowMs = nowMs;
+  in.sample = (engine.inputSample[cardId] != 0);
+  in.setCondition = evalV3ConditionProgram(entry.set, engine.signals);
+  in.resetCondition = evalV3ConditionProgram(entry.reset, engine.signals);
+  in.prevSample = engine.prevDISample[cardId];
+  in.prevSampleValid = engine.prevDIPrimed[cardId];
+
+  V3DiStepOutput out = {};
+  runV3DiStep(entry.config.di, *entry.runtime.di, in, out);
+
+  engine.prevDISample[cardId] = out.nextPrevSample;
+  engine.prevDIPrimed[cardId] = out.nextPrevSampleValid;
+  recordV3ConditionResults(engine.signals, cardId, out.setResult,
+                           out.resetResult, out.resetOverride);
+}
+
+void processAICard(V3ScanEngine& engine, const V3ScanPlanEntry& entry) {
+  recordConditions(engine, entry.cardId, false, false);
+
+  V3AiStepInput in = {};
+  in.rawSample = engine.inputSample[entry.cardId];
+
+  runV3AiStep(entry.config.ai, *entry.runtime.ai, in);
+}
+
+void processDOCard(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                   uint32_t nowMs) {
+  const uint8_t cardId = entry.cardId;
+  const bool setCondition = evalV3ConditionProgram(entry.set, engine.signals);
+  const bool resetCondition =
+      evalV3ConditionProgram(entry.reset, engine.signals);
+  recordConditions(engine, cardId, setCondition, resetCondition);
+
+  V3DoStepInput in = {};
+  in.nowMs = nowMs;
+  in.setCondition = setCondition;
+  in.resetCondition = resetCondition;
+
+  V3DoStepOutput out = {};
+  runV3DoStep(entry.config.dOut, *entry.runtime.dOut, in, out);
+
+  const bool masked = (engine.globalOutputMask != nullptr &&
+                       *engine.globalOutputMask) ||
+                      (engine.outputMask != nullptr && engine.outputMask[cardId]);
+  if (entry.hwPin != kV3ScanPlanNoPin && !masked) {
+    writeV3OutputImage(engine.outputImage, entry.hwPin, out.effectiveOutput);
+  }
+}
+
+void processSIOCard(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                    uint32_t nowMs) {
+  const bool setCondition = evalV3ConditionProgram(entry.set, engine.signals);
+  const bool resetCondition =
+      evalV3ConditionProgram(entry.reset, engine.signals);
+  recordConditions(engine, entry.cardId, setCondition, resetCondition);
+
+  V3SioStepInput in = {};
+  in.nowMs = nowMs;
+  in.setCondition = setCondition;
+  in.resetCondition = resetCondition;
+
+  V3SioStepOutput out = {};
+  runV3SioStep(entry.config.sio, *entry.runtime.sio, in, out);
+}
+
+void processMathCard(V3ScanEngine& engine, const V3ScanPlanEntry& entry) {
+  const bool setCondition = evalV3ConditionProgram(entry.set, engine.signals);
+  const bool resetCondition =
+      evalV3ConditionProgram(entry.reset, engine.signals);
+  recordConditions(engine, entry.cardId, setCondition, resetCondition);
+
+  V3MathStepInput in = {};
+  in.setCondition = setCondition;
+  in.resetCondition = resetCondition;
+
+  V3MathStepOutput out = {};
+  runV3MathStep(entry.config.math, *entry.runtime.math, in, out);
+}
+
+void processRtcCard(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                    uint32_t nowMs) {
+  recordConditions(engine, entry.cardId, false, false);
+
+  V3RtcStepInput in = {};
+  in.nowMs = nowMs;
+
+  runV3RtcStep(entry.config.rtc, *entry.runtime.rtc, in);
+}
+
+void processCard(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                 uint32_t nowMs) {
+  if (entry.runtime.any == nullptr) return;
+  switch (entry.family) {
+    case V3CardFamily::DI:
+      processDICard(engine, entry, nowMs);
+      return;
+    case V3CardFamily::AI:
+      processAICard(engine, entry);
+      return;
+    case V3CardFamily::SIO:
+      processSIOCard(engine, entry, nowMs);
+      return;
+    case V3CardFamily::DO:
+      processDOCard(engine, entry, nowMs);
+      return;
+    case V3CardFamily::MATH:
+      processMathCard(engine, entry);
+      return;
+    case V3CardFamily::RTC:
+      processRtcCard(engine, entry, nowMs);
+      return;
+    default:
+      return;
+  }
+}
+
+void updateCardTimer(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                     uint32_t nowMs) {
+  uint32_t dueMs = 0;
+  if (v3ScanPlanEntryNextDeadline(entry, nowMs, dueMs)) {
+    setV3TimerDue(engine.timers, entry.cardId, dueMs);
+  } else {
+    removeV3Timer(engine.timers, entry.cardId);
+  }
+}
+}  // namespace
+
+void markAllV3ScanCardsDirty(V3ScanEngine& engine) {
+  for (uint8_t i = 0; i < engine.count; ++i) engine.dirty[i] = true;
+}
+
+bool anyV3ScanCardDirty(const V3ScanEngine& engine) {
+  for (uint8_t i = 0; i < engine.count; ++i) {
+    if (engine.dirty[i]) return true;
+  }
+  return false;
+}
+
+// Inputs are read once per scan; a card only needs evaluation when its
+// sample moved, so a quiet DI/AI costs one pin read and no step.
+void sampleV3ScanInputs(V3ScanEngine& engine) {
+  if (engine.io.readDigitalInputs != nullptr) {
+    engine.inputImage.levels = engine.io.readDigitalInputs(engine.io.context);
+  }
+  for (uint8_t i = 0; i < engine.count; ++i) {
+    const V3ScanPlanEntry& entry = engine.plan[i];
+    if (entry.family != V3CardFamily::DI && entry.family != V3CardFamily::AI) {
+      continue;
+    }
+    const uint8_t cardId = entry.cardId;
+    const uint32_t sample = readInputSample(engine, entry);
+    if (sample == engine.inputSample[cardId]) continue;
+    engine.inputSample[cardId] = sample;
+    engine.dirty[cardId] = true;
+  }
+}
+
+void markV3DueTimerCards(V3ScanEngine& engine, uint32_t nowMs) {
+  uint8_t cardId = 0;
+  while (popV3DueTimer(engine.timers, nowMs, cardId)) {
+    engine.dirty[cardId] = true;
+  }
+}
+
+void evaluateV3ScanEntry(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                         uint32_t nowMs) {
+  const uint8_t cardId = entry.cardId;
+  if (cardId >= engine.count) return;
+  engine.dirty[cardId] = false;
+#if CARD_PROFILING
+  const uint32_t costStart = readV3CostCounter();
+#endif
+  processCard(engine, entry, nowMs);
+  const bool signalChanged =
+      refreshRuntimeSignalAt(engine.meta, engine.store, engine.signals, cardId);
+#if CARD_PROFILING
+  if (engine.cardCost != nullptr) {
+    recordV3CardCost(engine.cardCost[cardId], readV3CostCounter() - costStart);
+  }
+#endif
+  if (signalChanged) {
+    markV3SignalChanged(engine.dependencies, cardId, engine.dirty);
+  }
+  updateCardTimer(engine, entry, nowMs);
+  engine.signals.evalCounter[cardId] += 1;
+}
+
+uint8_t runV3ScanCursorCard(V3ScanEngine& engine, uint32_t nowMs,
+                            bool evaluateAll) {
+  if (engine.count == 0) return 0;
+  const V3ScanPlanEntry& entry = engine.plan[engine.cursor % engine.count];
+  const uint8_t cardId = entry.cardId;
+  if (evaluateAll || engine.dirty[cardId]) {
+    evaluateV3ScanEntry(engine, entry, nowMs);
+    engine.cardsEvaluated += 1;
+  } else {
+    engine.cardsSkipped += 1;
+  }
+  engine.cursor = static_cast<uint16_t>((engine.cursor + 1) % engine.count);
+  return cardId;
+}
+
+void latchV3ScanOutputs(V3ScanEngine& engine) {
+  uint64_t setMask = 0;
+  uint64_t clearMask = 0;
+  takeV3OutputLatch(engine.outputImage, setMask, clearMask);
+  if (setMask == 0 && clearMask == 0) return;
+  if (engine.io.writeDigitalOutputs == nullptr) return;
+  engine.io.writeDigitalOutputs(engine.io.context, setMask, clearMask);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "control/command_dto.h"
+#include "kernel/v3_card_profile.h"
+#include "kernel/v3_incremental_scan.h"
+#include "kernel/v3_io_backend.h"
+#include "kernel/v3_io_image.h"
+#include "kernel/v3_runtime_signals.h"
+#include "kernel/v3_runtime_store.h"
+#include "kernel/v3_scan_plan.h"
+#include "kernel/v3_timer_index.h"
+#include "runtime/runtime_card_meta.h"
+
+// Everything one scan touches. Per-card arrays are caller-owned and hold
+// `count` entries; hardware is reached only through `io`. Run mode,
+// breakpoints and scheduling stay with the caller.
+struct V3ScanEngine {
+  uint8_t count;
+  const V3ScanPlanEntry* plan;
+  const RuntimeCardMeta* meta;
+  V3RuntimeStoreView store;
+  V3SignalStoreView signals;  // also holds condition results, eval counts
+  V3DependencyIndexView dependencies;
+  V3TimerIndexView timers;
+  bool* dirty;
+  uint32_t* inputSample;
+  bool* prevDISample;
+  bool* prevDIPrimed;
+  V3CardCost* cardCost;  // optional; used when CARD_PROFILING=1
+  const inputSourceMode* inputSource;
+  const uint32_t* forcedAIValue;
+  const bool* outputMask;
+  const bool* globalOutputMask;
+  V3IoBackend io;
+  V3InputImage inputImage;
+  V3OutputImage outputImage;
+  uint16_t cursor;
+  uint16_t cardsEvaluated;
+  uint16_t cardsSkipped;
+};
+
+void markAllV3ScanCardsDirty(V3ScanEngine& engine);
+bool anyV3ScanCardDirty(const V3ScanEngine& engine);
+// Captures the input image and re-reads every DI/AI sample (force modes and
+// invert applied); cards whose sample changed are marked dirty.
+void sampleV3ScanInputs(V3ScanEngine& engine);
+void markV3DueTimerCards(V3ScanEngine& engine, uint32_t nowMs);
+// Runs one card step, refreshes its signal, propagates dirty marks and
+// re-publishes its timer deadline.
+void evaluateV3ScanEntry(V3ScanEngine& engine, const V3ScanPlanEntry& entry,
+                         uint32_t nowMs);
+// Visits plan entry `cursor`, evaluating its card when dirty or
+// `evaluateAll`, then advances the cursor. The plan's order is the scan
+// order; per-card state is keyed by the entry's card id. Returns that id.
+uint8_t runV3ScanCursorCard(V3ScanEngine& engine, uint32_t nowMs,
+                            bool evaluateAll);
+void latchV3ScanOutputs(V3ScanEngine& engine);
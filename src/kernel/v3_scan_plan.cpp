@@ -0,0 +1,104 @@
+#include "kernel/v3_scan_plan.h"
+
+namespace {
+uint8_t pinAt(const uint8_t* pins, uint8_t count, uint8_t channel) {
+  if (pins == nullptr || channel >= count) return kV3ScanPlanNoPin;
+  return pins[channel];
+}
+}  // namespace
+
+V3ScanPlanEntry compileV3ScanPlanEntry(const V3CardConfig& card,
+                                       const RuntimeCardMeta& meta,
+                                       const RuntimeCardMeta* signalMeta,
+                                       uint8_t signalCount,
+                                       const V3RuntimeStoreView& store,
+                                       const V3ScanPlanPins& pins) {
+  V3ScanPlanEntry entry = {};
+  entry.cardId = card.cardId;
+  entry.family = card.family;
+  entry.hwPin = kV3ScanPlanNoPin;
+  entry.runtime.any = nullptr;
+
+  switch (card.family) {
+    case V3CardFamily::DI: {
+      const V3DiConfig& di = card.asDi();
+      entry.runtime.di = runtimeDiStateAt(di.channel, store);
+      entry.hwPin = pinAt(pins.diPins, pins.diCount, di.channel);
+      entry.invert = di.invert;
+      entry.set = compileV3ConditionProgram(di.set, signalMeta, signalCount);
+      entry.reset =
+          compileV3ConditionProgram(di.reset, signalMeta, signalCount);
+      entry.config.di.debounceTimeMs = di.debounceTimeMs;
+      entry.config.di.edgeMode = di.edgeMode;
+      break;
+    }
+    case V3CardFamily::DO: {
+      const V3DoConfig& dout = card.asDo();
+      entry.runtime.dOut = runtimeDoStateAt(dout.channel, store);
+      entry.hwPin = pinAt(pins.doPins, pins.doCount, dout.channel);
+      entry.set = compileV3ConditionProgram(dout.set, signalMeta, signalCount);
+      entry.reset =
+          compileV3ConditionProgram(dout.reset, signalMeta, signalCount);
+      entry.config.dOut.mode = dout.mode;
+      entry.config.dOut.delayBeforeOnMs = dout.delayBeforeOnMs;
+      entry.config.dOut.onDurationMs = dout.onDurationMs;
+      entry.config.dOut.repeatCount = dout.repeatCount;
+      break;
+    }
+    case V3CardFamily::AI: {
+      const V3AiConfig& ai = card.asAi();
+      entry.runtime.ai = runtimeAiStateAt(ai.channel, store);
+      entry.hwPin = pinAt(pins.aiPins, pins.aiCount, ai.channel);
+      entry.config.ai.inputMin = ai.inputMin;
+      entry.config.ai.inputMax = ai.inputMax;
+      entry.config.ai.outputMin = ai.outputMin;
+      entry.config.ai.outputMax = ai.outputMax;
+      entry.config.ai.emaAlphaX1000 = ai.emaAlphaX100 * 10U;
+      break;
+    }
+    case V3CardFamily::SIO: {
+      const V3SioConfig& sio = card.asSio();
+      entry.runtime.sio = runtimeSioStateAt(meta.index, store);
+      entry.set = compileV3ConditionProgram(sio.set, signalMeta, signalCount);
+      entry.reset =
+          compileV3ConditionProgram(sio.reset, signalMeta, signalCount);
+      entry.config.sio.mode = sio.mode;
+      entry.config.sio.delayBeforeOnMs = sio.delayBeforeOnMs;
+      entry.config.sio.onDurationMs = sio.onDurationMs;
+      entry.config.sio.repeatCount = sio.repeatCount;
+      break;
+    }
+    case V3CardFamily::MATH: {
+      const V3MathConfig& math = card.asMath();
+      entry.runtime.math = runtimeMathStateAt(meta.index, store);
+      entry.set = compileV3ConditionProgram(math.set, signalMeta, signalCount);
+      entry.reset =
+          compileV3ConditionProgram(math.reset, signalMeta, signalCount);
+      entry.config.math.inputA = math.inputA;
+      entry.config.math.inputB = math.inputB;
+      entry.config.math.fallbackValue = math.fallbackValue;
+      entry.config.math.clampMin = math.clampMin;
+      entry.config.math.clampMax = math.clampMax;
+      entry.config.math.clampEnabled = (math.clampMax >= math.clampMin);
+      break;
+    }
+    case V3CardFamily::RTC: {
+      const V3RtcConfig& rtc = card.asRtc();
+      entry.runtime.rtc = runtimeRtcStateAt(meta.index, store);
+      entry.config.rtc.triggerDurationMs = rtc.triggerDurationMs;
+      break;
+    }
+    default:
+      break;
+  }
+  return entry;
+}
+
+void compileV3ScanPlan(const V3CardConfig* cards, const RuntimeCardMeta* meta,
+                       uint8_t count, const V3RuntimeStoreView& store,
+                       const V3ScanPlanPins& pins, V3ScanPlanEntry* out) {
+  if (cards == nullptr || meta == nullptr || out == nullptr) return;
+  for (uint8_t i = 0; i < count; ++i) {
+    out[i] = compileV3ScanPlanEntry(cards[i], meta[i], meta, count, store, pins);
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/v3_card_types.h"
+#include "kernel/v3_condition_program.h"
+#include "kernel/v3_runtime_store.h"
+#include "runtime/runtime_card_meta.h"
+
+constexpr uint8_t kV3ScanPlanNoPin = 255;
+
+struct V3ScanPlanPins {
+  const uint8_t* diPins;
+  uint8_t diCount;
+  const uint8_t* doPins;
+  uint8_t doCount;
+  const uint8_t* aiPins;
+  uint8_t aiCount;
+};
+
+// One pre-resolved scan step per card. Built once per config apply so the
+// scan loop never re-derives family, runtime slot, pin, step config or
+// condition operands.
+struct V3ScanPlanEntry {
+  uint8_t cardId;
+  V3CardFamily family;
+  uint8_t hwPin;
+  bool invert;
+  V3ConditionProgram set;
+  V3ConditionProgram reset;
+  union {
+    V3DiRuntimeState* di;
+    V3DoRuntimeState* dOut;
+    V3AiRuntimeState* ai;
+    V3SioRuntimeState* sio;
+    V3MathRuntimeState* math;
+    V3RtcRuntimeState* rtc;
+    void* any;
+  } runtime;
+  union {
+    V3DiRuntimeConfig di;
+    V3DoRuntimeConfig dOut;
+    V3AiRuntimeConfig ai;
+    V3SioRuntimeConfig sio;
+    V3MathRuntimeConfig math;
+    V3RtcRuntimeConfig rtc;
+  } config;
+};
+
+V3ScanPlanEntry compileV3ScanPlanEntry(const V3CardConfig& card,
+                                       const RuntimeCardMeta& meta,
+                                       const RuntimeCardMeta* signalMeta,
+                                       uint8_t signalCount,
+                                       const V3RuntimeStoreView& store,
+                                       const V3ScanPlanPins& pins);
+// Emits one entry per card in card-id order. The array order is the scan
+// order: the engine walks entries, not card ids.
+void compileV3ScanPlan(const V3CardConfig* cards, const RuntimeCardMeta* meta,
+                       uint8_t count, const V3RuntimeStoreView& store,
+                       const V3ScanPlanPins& pins, V3ScanPlanEntry* out);
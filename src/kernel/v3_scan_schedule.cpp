@@ -0,0 +1,26 @@
+#include "kernel/v3_scan_schedule.h"
+
+void armV3ScanSchedule(V3ScanSchedule& schedule, uint32_t nowUs,
+                       uint32_t periodUs) {
+  schedule.periodUs = (periodUs == 0) ? 1 : periodUs;
+  schedule.nextDueUs = nowUs + schedule.periodUs;
+  schedule.missedPeriods = 0;
+}
+
+bool takeV3ScanDeadline(V3ScanSchedule& schedule, uint32_t nowUs,
+                        uint32_t& latenessUs) {
+  const int32_t delta = static_cast<int32_t>(nowUs - schedule.nextDueUs);
+  if (delta < 0) return false;
+
+  latenessUs = static_cast<uint32_t>(delta);
+  const uint32_t skipped = latenessUs / schedule.periodUs;
+  schedule.missedPeriods += skipped;
+  schedule.nextDueUs += (skipped + 1) * schedule.periodUs;
+  return true;
+}
+
+uint32_t v3ScanScheduleRemainingUs(const V3ScanSchedule& schedule,
+                                   uint32_t nowUs) {
+  const int32_t delta = static_cast<int32_t>(schedule.nextDueUs - nowUs);
+  return (delta > 0) ? static_cast<uint32_t>(delta) : 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+// Absolute-period scan deadlines on a wrapping microsecond clock. Deadlines
+// advance by whole periods from the armed phase, so wake-up lateness never
+// accumulates into drift.
+struct V3ScanSchedule {
+  uint32_t periodUs;
+  uint32_t nextDueUs;
+  uint32_t missedPeriods;
+};
+
+void armV3ScanSchedule(V3ScanSchedule& schedule, uint32_t nowUs,
+                       uint32_t periodUs);
+// Returns true when the deadline has passed; `latenessUs` is how far past the
+// intended start `nowUs` is. Periods missed entirely are skipped, not replayed.
+bool takeV3ScanDeadline(V3ScanSchedule& schedule, uint32_t nowUs,
+                        uint32_t& latenessUs);
+uint32_t v3ScanScheduleRemainingUs(const V3ScanSchedule& schedule,
+                                   uint32_t nowUs);
@@ -0,0 +1,95 @@
+#include "kernel/v3_timer_index.h"
+
+namespace {
+// Deadlines are compared on a wrapping clock, so every queued deadline must
+// lie within 2^31 ms of the others; callers clamp long waits (see
+// v3ScanPlanEntryNextDeadline) and simply re-queue on an early wake.
+bool dueBefore(const V3TimerIndexView& index, uint8_t a, uint8_t b) {
+  return static_cast<int32_t>(index.dueMs[a] - index.dueMs[b]) < 0;
+}
+
+void placeAt(V3TimerIndexView& index, uint8_t slot, uint8_t cardId) {
+  index.heap[slot] = cardId;
+  index.position[cardId] = slot;
+}
+
+void siftUp(V3TimerIndexView& index, uint8_t slot) {
+  const uint8_t cardId = index.heap[slot];
+  while (slot > 0) {
+    const uint8_t parent = static_cast<uint8_t>((slot - 1) / 2);
+    if (!dueBefore(index, cardId, index.heap[parent])) break;
+    placeAt(index, slot, index.heap[parent]);
+    slot = parent;
+  }
+  placeAt(index, slot, cardId);
+}
+
+void siftDown(V3TimerIndexView& index, uint8_t slot) {
+  const uint8_t cardId = index.heap[slot];
+  for (;;) {
+    const uint16_t left = static_cast<uint16_t>(slot) * 2 + 1;
+    if (left >= index.size) break;
+    uint16_t child = left;
+    const uint16_t right = left + 1;
+    if (right < index.size &&
+        dueBefore(index, index.heap[right], index.heap[left])) {
+      child = right;
+    }
+    if (!dueBefore(index, index.heap[child], cardId)) break;
+    placeAt(index, slot, index.heap[child]);
+    slot = static_cast<uint8_t>(child);
+  }
+  placeAt(index, slot, cardId);
+}
+}  // namespace
+
+void clearV3TimerIndex(V3TimerIndexView& index) {
+  index.size = 0;
+  if (index.position == nullptr) return;
+  for (uint8_t i = 0; i < index.capacity; ++i) {
+    index.position[i] = kV3TimerNotQueued;
+  }
+}
+
+void setV3TimerDue(V3TimerIndexView& index, uint8_t cardId, uint32_t dueMs) {
+  if (cardId >= index.capacity) return;
+  const uint8_t slot = index.position[cardId];
+  index.dueMs[cardId] = dueMs;
+  if (slot == kV3TimerNotQueued) {
+    placeAt(index, index.size, cardId);
+    index.size += 1;
+    siftUp(index, static_cast<uint8_t>(index.size - 1));
+    return;
+  }
+  siftUp(index, slot);
+  siftDown(index, index.position[cardId]);
+}
+
+void removeV3Timer(V3TimerIndexView& index, uint8_t cardId) {
+  if (cardId >= index.capacity) return;
+  const uint8_t slot = index.position[cardId];
+  if (slot == kV3TimerNotQueued) return;
+  index.position[cardId] = kV3TimerNotQueued;
+  index.size -= 1;
+  if (slot == index.size) return;
+  const uint8_t moved = index.heap[index.size];
+  placeAt(index, slot, moved);
+  siftUp(index, slot);
+  siftDown(index, index.position[moved]);
+}
+
+bool peekV3NextTimer(const V3TimerIndexView& index, uint8_t& cardId,
+                     uint32_t& dueMs) {
+  if (index.size == 0) return false;
+  cardId = index.heap[0];
+  dueMs = index.dueMs[cardId];
+  return true;
+}
+
+bool popV3DueTimer(V3TimerIndexView& index, uint32_t nowMs, uint8_t& cardId) {
+  uint32_t dueMs = 0;
+  if (!peekV3NextTimer(index, cardId, dueMs)) return false;
+  if (static_cast<int32_t>(nowMs - dueMs) < 0) return false;
+  removeV3Timer(index, cardId);
+  return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+constexpr uint8_t kV3TimerNotQueued = 255;
+
+// Indexed binary min-heap of per-card deadlines (ms, wrapping clock).
+// Storage is caller-owned: `heap` and `position` hold `capacity` entries,
+// `dueMs` holds one deadline per card id.
+struct V3TimerIndexView {
+  uint8_t* heap;
+  uint8_t* position;
+  uint32_t* dueMs;
+  uint8_t size;
+  uint8_t capacity;
+};
+
+void clearV3TimerIndex(V3TimerIndexView& index);
+void setV3TimerDue(V3TimerIndexView& index, uint8_t cardId, uint32_t dueMs);
+void removeV3Timer(V3TimerIndexView& index, uint8_t cardId);
+bool peekV3NextTimer(const V3TimerIndexView& index, uint8_t& cardId,
+                     uint32_t& dueMs);
+// Pops the earliest timer if it is due at `nowMs`.
+bool popV3DueTimer(V3TimerIndexView& index, uint32_t nowMs, uint8_t& cardId);
@@ -5,17 +5,6 @@
 #include "kernel/v3_condition_rules.h"
 
 namespace {
-logicCardType expectedTypeForCardId(uint8_t id, uint8_t doStart, uint8_t aiStart,
-                                    uint8_t sioStart, uint8_t mathStart,
-                                    uint8_t rtcStart) {
-  if (id < doStart) return DigitalInput;
-  if (id < aiStart) return DigitalOutput;
-  if (id < sioStart) return AnalogInput;
-  if (id < mathStart) return SoftIO;
-  if (id < rtcStart) return MathCard;
-  return RtcCard;
-}
-
 bool mapV3ModeToLegacy(logicCardType type, const char* mode, cardMode& outMode) {
   if (type == DigitalInput) {
     if (std::strcmp(mode, "RISING") == 0) return (outMode = Mode_DI_Rising), true;
@@ -218,18 +207,16 @@ V3CardFamily v3FamilyFromLogicType(logicCardType type) {
 }  // namespace
 
 bool parseV3CardToTyped(JsonObjectConst v3Card, const logicCardType* sourceTypeById,
-                        uint8_t totalCards, uint8_t doStart, uint8_t aiStart,
-                        uint8_t sioStart, uint8_t mathStart, uint8_t rtcStart,
-                        V3CardConfig& out, String& reason) {
+                        const V3CardLayout& layout, V3CardConfig& out,
+                        String& reason) {
+  const uint8_t totalCards = layout.totalCards;
   const uint8_t cardId = v3Card["cardId"] | 255;
   if (cardId >= totalCards) {
     reason = "cardId out of range";
     return false;
   }
   const char* cardType = v3Card["cardType"] | "";
-  const logicCardType expectedType =
-      expectedTypeForCardId(cardId, doStart, aiStart, sioStart, mathStart,
-                            rtcStart);
+  const logicCardType expectedType = v3CardTypeForId(layout, cardId);
   logicCardType parsedType = DigitalInput;
   if (!parseV3CardTypeToken(cardType, parsedType)) {
     reason = "invalid cardType";
@@ -240,6 +227,7 @@ bool parseV3CardToTyped(JsonObjectConst v3Card, const logicCardType* sourceTypeB
     return false;
   }
 
+  out = {};
   out.cardId = cardId;
   out.family = v3FamilyFromLogicType(expectedType);
   out.enabled = v3Card["enabled"] | true;
@@ -257,53 +245,55 @@ bool parseV3CardToTyped(JsonObjectConst v3Card, const logicCardType* sourceTypeB
   }
 
   if (expectedType == DigitalInput) {
-    out.di.channel = cfg["channel"] | cardId;
-    out.di.invert = cfg["invert"] | false;
-    out.di.debounceTimeMs = cfg["debounceTime"] | 0U;
+    V3DiConfig& di = out.asDi();
+    di.channel = cfg["channel"] | cardId;
+    di.invert = cfg["invert"] | false;
+    di.debounceTimeMs = cfg["debounceTime"] | 0U;
     const char* edgeMode = cfg["edgeMode"] | "RISING";
     cardMode diMode = Mode_DI_Rising;
     if (!mapV3ModeToLegacy(expectedType, edgeMode, diMode)) {
       reason = "invalid DI edgeMode";
       return false;
     }
-    out.di.edgeMode = diMode;
+    di.edgeMode = diMode;
     if (!cfg["set"].is<JsonObjectConst>() || !cfg["reset"].is<JsonObjectConst>()) {
       reason = "DI require set and reset blocks";
       return false;
     }
     if (!mapV3ConditionBlock(cfg["set"].as<JsonObjectConst>(), totalCards,
-                             out.di.set.clauseAId, out.di.set.clauseAOperator,
-                             out.di.set.clauseAThreshold, out.di.set.clauseBId,
-                             out.di.set.clauseBOperator,
-                             out.di.set.clauseBThreshold, out.di.set.combiner,
+                             di.set.clauseAId, di.set.clauseAOperator,
+                             di.set.clauseAThreshold, di.set.clauseBId,
+                             di.set.clauseBOperator,
+                             di.set.clauseBThreshold, di.set.combiner,
                              reason, sourceTypeById)) {
       return false;
     }
     if (!mapV3ConditionBlock(cfg["reset"].as<JsonObjectConst>(), totalCards,
-                             out.di.reset.clauseAId, out.di.reset.clauseAOperator,
-                             out.di.reset.clauseAThreshold, out.di.reset.clauseBId,
-                             out.di.reset.clauseBOperator,
-                             out.di.reset.clauseBThreshold,
-                             out.di.reset.combiner, reason, sourceTypeById)) {
+                             di.reset.clauseAId, di.reset.clauseAOperator,
+                             di.reset.clauseAThreshold, di.reset.clauseBId,
+                             di.reset.clauseBOperator,
+                             di.reset.clauseBThreshold,
+                             di.reset.combiner, reason, sourceTypeById)) {
       return false;
     }
     return true;
   }
 
   if (expectedType == AnalogInput) {
+    V3AiConfig& ai = out.asAi();
     JsonObjectConst inputRange = cfg["inputRange"].as<JsonObjectConst>();
     JsonObjectConst outputRange = cfg["outputRange"].as<JsonObjectConst>();
-    out.ai.channel = cfg["channel"] | cardId;
-    out.ai.inputMin = inputRange["min"] | 0U;
-    out.ai.inputMax = inputRange["max"] | 4095U;
+    ai.channel = cfg["channel"] | cardId;
+    ai.inputMin = inputRange["min"] | 0U;
+    ai.inputMax = inputRange["max"] | 4095U;
     const uint32_t emaAlphaX100 = cfg["emaAlpha"] | 100U;
     if (emaAlphaX100 > 100U) {
       reason = "AI emaAlpha out of range";
       return false;
     }
-    out.ai.emaAlphaX100 = emaAlphaX100;
-    out.ai.outputMin = outputRange["min"] | 0U;
-    out.ai.outputMax = outputRange["max"] | 10000U;
+    ai.emaAlphaX100 = emaAlphaX100;
+    ai.outputMin = outputRange["min"] | 0U;
+    ai.outputMax = outputRange["max"] | 10000U;
     return true;
   }
 
@@ -315,53 +305,57 @@ bool parseV3CardToTyped(JsonObjectConst v3Card, const logicCardType* sourceTypeB
       return false;
     }
     if (expectedType == DigitalOutput) {
-      out.dout.channel = cfg["channel"] | cardId;
-      out.dout.mode = outMode;
-      out.dout.delayBeforeOnMs = cfg["delayBeforeON"] | 0U;
-      out.dout.onDurationMs = cfg["onDuration"] | 0U;
-      out.dout.repeatCount = cfg["repeatCount"] | 1U;
+      V3DoConfig& dout = out.asDo();
+      dout.channel = cfg["channel"] | cardId;
+      dout.mode = outMode;
+      dout.delayBeforeOnMs = cfg["delayBeforeON"] | 0U;
+      dout.onDurationMs = cfg["onDuration"] | 0U;
+      dout.repeatCount = cfg["repeatCount"] | 1U;
     } else {
-      out.sio.mode = outMode;
-      out.sio.delayBeforeOnMs = cfg["delayBeforeON"] | 0U;
-      out.sio.onDurationMs = cfg["onDuration"] | 0U;
-      out.sio.repeatCount = cfg["repeatCount"] | 1U;
+      V3SioConfig& sio = out.asSio();
+      sio.mode = outMode;
+      sio.delayBeforeOnMs = cfg["delayBeforeON"] | 0U;
+      sio.onDurationMs = cfg["onDuration"] | 0U;
+      sio.repeatCount = cfg["repeatCount"] | 1U;
     }
     if (!cfg["set"].is<JsonObjectConst>() || !cfg["reset"].is<JsonObjectConst>()) {
       reason = "DO/SIO require set and reset blocks";
       return false;
     }
     if (expectedType == DigitalOutput) {
+      V3DoConfig& dout = out.asDo();
       if (!mapV3ConditionBlock(
-              cfg["set"].as<JsonObjectConst>(), totalCards, out.dout.set.clauseAId,
-              out.dout.set.clauseAOperator, out.dout.set.clauseAThreshold,
-              out.dout.set.clauseBId, out.dout.set.clauseBOperator,
-              out.dout.set.clauseBThreshold, out.dout.set.combiner, reason,
+              cfg["set"].as<JsonObjectConst>(), totalCards, dout.set.clauseAId,
+              dout.set.clauseAOperator, dout.set.clauseAThreshold,
+              dout.set.clauseBId, dout.set.clauseBOperator,
+              dout.set.clauseBThreshold, dout.set.combiner, reason,
               sourceTypeById)) {
         return false;
       }
       if (!mapV3ConditionBlock(
               cfg["reset"].as<JsonObjectConst>(), totalCards,
-              out.dout.reset.clauseAId, out.dout.reset.clauseAOperator,
-              out.dout.reset.clauseAThreshold, out.dout.reset.clauseBId,
-              out.dout.reset.clauseBOperator, out.dout.reset.clauseBThreshold,
-              out.dout.reset.combiner, reason, sourceTypeById)) {
+              dout.reset.clauseAId, dout.reset.clauseAOperator,
+              dout.reset.clauseAThreshold, dout.reset.clauseBId,
+              dout.reset.clauseBOperator, dout.reset.clauseBThreshold,
+              dout.reset.combiner, reason, sourceTypeById)) {
         return false;
       }
     } else {
+      V3SioConfig& sio = out.asSio();
       if (!mapV3ConditionBlock(
-              cfg["set"].as<JsonObjectConst>(), totalCards, out.sio.set.clauseAId,
-              out.sio.set.clauseAOperator, out.sio.set.clauseAThreshold,
-              out.sio.set.clauseBId, out.sio.set.clauseBOperator,
-              out.sio.set.clauseBThreshold, out.sio.set.combiner, reason,
+              cfg["set"].as<JsonObjectConst>(), totalCards, sio.set.clauseAId,
+              sio.set.clauseAOperator, sio.set.clauseAThreshold,
+              sio.set.clauseBId, sio.set.clauseBOperator,
+              sio.set.clauseBThreshold, sio.set.combiner, reason,
               sourceTypeById)) {
         return false;
       }
       if (!mapV3ConditionBlock(
               cfg["reset"].as<JsonObjectConst>(), totalCards,
-              out.sio.reset.clauseAId, out.sio.reset.clauseAOperator,
-              out.sio.reset.clauseAThreshold, out.sio.reset.clauseBId,
-              out.sio.reset.clauseBOperator, out.sio.reset.clauseBThreshold,
-              out.sio.reset.combiner, reason, sourceTypeById)) {
+              sio.reset.clauseAId, sio.reset.clauseAOperator,
+              sio.reset.clauseAThreshold, sio.reset.clauseBId,
+              sio.reset.clauseBOperator, sio.reset.clauseBThreshold,
+              sio.reset.combiner, reason, sourceTypeById)) {
         return false;
       }
     }
@@ -369,20 +363,21 @@ bool parseV3CardToTyped(JsonObjectConst v3Card, const logicCardType* sourceTypeB
   }
 
   if (expectedType == MathCard) {
-    out.math.fallbackValue = cfg["fallbackValue"] | 0U;
+    V3MathConfig& math = out.asMath();
+    math.fallbackValue = cfg["fallbackValue"] | 0U;
     JsonObjectConst standard = cfg["standard"].as<JsonObjectConst>();
     JsonObjectConst inputA = standard["inputA"].as<JsonObjectConst>();
     JsonObjectConst inputB = standard["inputB"].as<JsonObjectConst>();
-    out.math.inputA = inputA["value"] | 0U;
-    out.math.inputB = inputB["value"] | 0U;
-    out.math.clampMin = standard["clampMin"] | 0U;
-    out.math.clampMax = standard["clampMax"] | 0U;
+    math.inputA = inputA["value"] | 0U;
+    math.inputB = inputB["value"] | 0U;
+    math.clampMin = standard["clampMin"] | 0U;
+    math.clampMax = standard["clampMax"] | 0U;
     if (cfg["set"].is<JsonObjectConst>()) {
       if (!mapV3ConditionBlock(
-              cfg["set"].as<JsonObjectConst>(), totalCards, out.math.set.clauseAId,
-              out.math.set.clauseAOperator, out.math.set.clauseAThreshold,
-              out.math.set.clauseBId, out.math.set.clauseBOperator,
-              out.math.set.clauseBThreshold, out.math.set.combiner, reason,
+              cfg["set"].as<JsonObjectConst>(), totalCards, math.set.clauseAId,
+              math.set.clauseAOperator, math.set.clauseAThreshold,
+              math.set.clauseBId, math.set.clauseBOperator,
+              math.set.clauseBThreshold, math.set.combiner, reason,
               sourceTypeById)) {
         return false;
       }
@@ -390,10 +385,10 @@ bool parseV3CardToTyped(JsonObjectConst v3Card, const logicCardType* sourceTypeB
     if (cfg["reset"].is<JsonObjectConst>()) {
       if (!mapV3ConditionBlock(
               cfg["reset"].as<JsonObjectConst>(), totalCards,
-              out.math.reset.clauseAId, out.math.reset.clauseAOperator,
-              out.math.reset.clauseAThreshold, out.math.reset.clauseBId,
-              out.math.reset.clauseBOperator, out.math.reset.clauseBThreshold,
-              out.math.reset.combiner, reason, sourceTypeById)) {
+              math.reset.clauseAId, math.reset.clauseAOperator,
+              math.reset.clauseAThreshold, math.reset.clauseBId,
+              math.reset.clauseBOperator, math.reset.clauseBThreshold,
+              math.reset.combiner, reason, sourceTypeById)) {
         return false;
       }
     }
@@ -401,20 +396,21 @@ bool parseV3CardToTyped(JsonObjectConst v3Card, const logicCardType* sourceTypeB
   }
 
   if (expectedType == RtcCard) {
+    V3RtcConfig& rtc = out.asRtc();
     JsonObjectConst schedule = cfg["schedule"].as<JsonObjectConst>();
-    out.rtc.hasYear = schedule["year"].is<int>() || schedule["year"].is<uint32_t>();
-    out.rtc.hasMonth =
+    rtc.hasYear = schedule["year"].is<int>() || schedule["year"].is<uint32_t>();
+    rtc.hasMonth =
         schedule["month"].is<int>() || schedule["month"].is<uint32_t>();
-    out.rtc.hasDay = schedule["day"].is<int>() || schedule["day"].is<uint32_t>();
-    out.rtc.hasWeekday =
+    rtc.hasDay = schedule["day"].is<int>() || schedule["day"].is<uint32_t>();
+    rtc.hasWeekday =
         schedule["weekday"].is<int>() || schedule["weekday"].is<uint32_t>();
-    out.rtc.year = schedule["year"] | 0;
-    out.rtc.month = schedule["month"] | 0;
-    out.rtc.day = schedule["day"] | 0;
-    out.rtc.weekday = schedule["weekday"] | 0;
-    out.rtc.hour = schedule["hour"] | 0;
-    out.rtc.minute = schedule["minute"] | 0;
-    out.rtc.triggerDurationMs = cfg["triggerDuration"] | 0U;
+    rtc.year = schedule["year"] | 0;
+    rtc.month = schedule["month"] | 0;
+    rtc.day = schedule["day"] | 0;
+    rtc.weekday = schedule["weekday"] | 0;
+    rtc.hour = schedule["hour"] | 0;
+    rtc.minute = schedule["minute"] | 0;
+    rtc.triggerDurationMs = cfg["triggerDuration"] | 0U;
     return true;
   }
 
@@ -3,17 +3,6 @@
 #include <string>
 
 namespace {
-V3CardFamily familyForId(uint8_t id, uint8_t doStart, uint8_t aiStart,
-                         uint8_t sioStart, uint8_t mathStart,
-                         uint8_t rtcStart) {
-  if (id < doStart) return V3CardFamily::DI;
-  if (id < aiStart) return V3CardFamily::DO;
-  if (id < sioStart) return V3CardFamily::AI;
-  if (id < mathStart) return V3CardFamily::SIO;
-  if (id < rtcStart) return V3CardFamily::MATH;
-  return V3CardFamily::RTC;
-}
-
 bool isNumericOp(logicOperator op) {
   return op == Op_GT || op == Op_GTE || op == Op_LT || op == Op_LTE ||
          op == Op_EQ || op == Op_NEQ;
@@ -52,10 +41,9 @@ bool isOperatorAllowedForFamily(V3CardFamily sourceFamily, logicOperator op) {
 }
 }  // namespace
 
-bool validateTypedCardConfigs(const V3CardConfig* cards, uint8_t count,
-                              uint8_t doStart, uint8_t aiStart,
-                              uint8_t sioStart, uint8_t mathStart,
-                              uint8_t rtcStart, std::string& reason) {
+bool validateTypedCardConfigs(const V3CardConfig* cards,
+                              const V3CardLayout& layout, std::string& reason) {
+  const uint8_t count = layout.totalCards;
   if (cards == nullptr) {
     reason = "typed cards missing";
     return false;
@@ -101,55 +89,55 @@ bool validateTypedCardConfigs(const V3CardConfig* cards, uint8_t count,
       return false;
     }
 
-    const V3CardFamily expectedFamily =
-        familyForId(i, doStart, aiStart, sioStart, mathStart, rtcStart);
+    const V3CardFamily expectedFamily = v3CardFamilyForId(layout, i);
     if (card.family != expectedFamily) {
       reason = "typed card family does not match fixed family slot";
       return false;
     }
 
     if (card.family == V3CardFamily::DI) {
-      if (card.di.edgeMode != Mode_DI_Rising &&
-          card.di.edgeMode != Mode_DI_Falling &&
-          card.di.edgeMode != Mode_DI_Change) {
+      const V3DiConfig& di = card.asDi();
+      if (di.edgeMode != Mode_DI_Rising && di.edgeMode != Mode_DI_Falling &&
+          di.edgeMode != Mode_DI_Change) {
         reason = "DI edge mode invalid";
         return false;
       }
-      if (!validateConditionBlock(card.di.set, card.cardId, "di.set")) {
+      if (!validateConditionBlock(di.set, card.cardId, "di.set")) {
         return false;
       }
-      if (!validateConditionBlock(card.di.reset, card.cardId, "di.reset")) {
+      if (!validateConditionBlock(di.reset, card.cardId, "di.reset")) {
         return false;
       }
       continue;
     }
 
     if (card.family == V3CardFamily::DO) {
-      if (card.dout.mode != Mode_DO_Normal &&
-          card.dout.mode != Mode_DO_Immediate &&
-          card.dout.mode != Mode_DO_Gated) {
+      const V3DoConfig& dout = card.asDo();
+      if (dout.mode != Mode_DO_Normal && dout.mode != Mode_DO_Immediate &&
+          dout.mode != Mode_DO_Gated) {
         reason = "DO mode invalid";
         return false;
       }
-      if (!validateConditionBlock(card.dout.set, card.cardId, "do.set")) {
+      if (!validateConditionBlock(dout.set, card.cardId, "do.set")) {
         return false;
       }
-      if (!validateConditionBlock(card.dout.reset, card.cardId, "do.reset")) {
+      if (!validateConditionBlock(dout.reset, card.cardId, "do.reset")) {
         return false;
       }
       continue;
     }
 
     if (card.family == V3CardFamily::AI) {
-      if (card.ai.inputMin > card.ai.inputMax) {
+      const V3AiConfig& ai = card.asAi();
+      if (ai.inputMin > ai.inputMax) {
         reason = "AI input range invalid";
         return false;
       }
-      if (card.ai.outputMin > card.ai.outputMax) {
+      if (ai.outputMin > ai.outputMax) {
         reason = "AI output range invalid";
         return false;
       }
-      if (card.ai.emaAlphaX100 > 100U) {
+      if (ai.emaAlphaX100 > 100U) {
         reason = "AI emaAlpha out of range";
         return false;
       }
@@ -157,49 +145,51 @@ bool validateTypedCardConfigs(const V3CardConfig* cards, uint8_t count,
     }
 
     if (card.family == V3CardFamily::SIO) {
-      if (card.sio.mode != Mode_DO_Normal &&
-          card.sio.mode != Mode_DO_Immediate &&
-          card.sio.mode != Mode_DO_Gated) {
+      const V3SioConfig& sio = card.asSio();
+      if (sio.mode != Mode_DO_Normal && sio.mode != Mode_DO_Immediate &&
+          sio.mode != Mode_DO_Gated) {
         reason = "SIO mode invalid";
         return false;
       }
-      if (!validateConditionBlock(card.sio.set, card.cardId, "sio.set")) {
+      if (!validateConditionBlock(sio.set, card.cardId, "sio.set")) {
         return false;
       }
-      if (!validateConditionBlock(card.sio.reset, card.cardId, "sio.reset")) {
+      if (!validateConditionBlock(sio.reset, card.cardId, "sio.reset")) {
         return false;
       }
       continue;
     }
 
     if (card.family == V3CardFamily::MATH) {
-      if (!validateConditionBlock(card.math.set, card.cardId, "math.set")) {
+      const V3MathConfig& math = card.asMath();
+      if (!validateConditionBlock(math.set, card.cardId, "math.set")) {
         return false;
       }
-      if (!validateConditionBlock(card.math.reset, card.cardId, "math.reset")) {
+      if (!validateConditionBlock(math.reset, card.cardId, "math.reset")) {
         return false;
       }
       continue;
     }
 
     if (card.family == V3CardFamily::RTC) {
-      if (card.rtc.hasMonth && (card.rtc.month < 1 || card.rtc.month > 12)) {
+      const V3RtcConfig& rtc = card.asRtc();
+      if (rtc.hasMonth && (rtc.month < 1 || rtc.month > 12)) {
         reason = "RTC month out of range";
         return false;
       }
-      if (card.rtc.hasDay && (card.rtc.day < 1 || card.rtc.day > 31)) {
+      if (rtc.hasDay && (rtc.day < 1 || rtc.day > 31)) {
         reason = "RTC day out of range";
         return false;
       }
-      if (card.rtc.hasWeekday && card.rtc.weekday > 6) {
+      if (rtc.hasWeekday && rtc.weekday > 6) {
         reason = "RTC weekday out of range";
         return false;
       }
-      if (card.rtc.hour > 23) {
+      if (rtc.hour > 23) {
         reason = "RTC hour out of range";
         return false;
       }
-      if (card.rtc.minute > 59) {
+      if (rtc.minute > 59) {
         reason = "RTC minute out of range";
         return false;
       }
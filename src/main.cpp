@@ -17,6 +17,7 @@
 #include <WebServer.h>
 #include <WebSocketsServer.h>
 #include <WiFi.h>
+#include <esp_timer.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
 #include <freertos/task.h>
@@ -30,6 +31,7 @@
 #include "kernel/legacy_config_validator.h"
 #include "kernel/v3_card_bridge.h"
 #include "kernel/v3_ai_runtime.h"
+#include "kernel/v3_card_profile.h"
 #include "kernel/v3_card_types.h"
 #include "kernel/v3_di_runtime.h"
 #include "kernel/v3_do_runtime.h"
@@ -38,41 +40,60 @@
 #include "kernel/v3_rtc_runtime.h"
 #include "kernel/v3_runtime_store.h"
 #include "kernel/v3_runtime_signals.h"
-#include "kernel/v3_status_runtime.h"
+#include "kernel/v3_incremental_scan.h"
+#include "kernel/v3_scan_plan.h"
+#include "kernel/v3_scan_engine.h"
+#include "kernel/v3_scan_schedule.h"
+#include "kernel/v3_timer_index.h"
+#include "platform/esp32_devkit_profile.h"
+#include "platform/esp32_io_backend.h"
+#include "portal/json_arena.h"
 #include "portal/routes.h"
+#include "runtime/latency_histogram.h"
 #include "runtime/shared_snapshot.h"
 #include "runtime/runtime_card_meta.h"
 #include "runtime/snapshot_card_builder.h"
 #include "runtime/snapshot_json.h"
-#include "storage/v3_config_service.h"
+#include "runtime/snapshot_payload_cache.h"
+#include "runtime/snapshot_publish_gate.h"
+#include "runtime/snapshot_seqlock.h"
+#include "runtime/snapshot_subscription.h"
+#include "runtime/stream_backpressure.h"
 #include "storage/config_lifecycle.h"
+#include "storage/config_workspace.h"
+#include "storage/v3_config_service.h"
 #include "storage/v3_normalizer.h"
 
-const uint8_t DI_Pins[] = {13, 12, 14, 27};  // Digital Input pins
-const uint8_t DO_Pins[] = {26, 25, 33, 32};  // Digital Output pins
-const uint8_t AI_Pins[] = {35, 34};          // Analog Input pins
-const uint8_t SIO_Pins[] = {255, 255, 255, 255};
-// SoftIO has no physical pins, so we can use 255 as a placeholder for "virtual"
-const uint8_t NUM_RTC_SCHED_CHANNELS = 2;
-
-// --- Card counts (can be changed later) ---
-const uint8_t NUM_DI = sizeof(DI_Pins) / sizeof(DI_Pins[0]);
-const uint8_t NUM_DO = sizeof(DO_Pins) / sizeof(DO_Pins[0]);
-const uint8_t NUM_AI = sizeof(AI_Pins) / sizeof(AI_Pins[0]);
-const uint8_t NUM_SIO = sizeof(SIO_Pins) / sizeof(SIO_Pins[0]);
-const uint8_t NUM_MATH = 2;
-const uint8_t NUM_RTC = NUM_RTC_SCHED_CHANNELS;
-
-const uint8_t TOTAL_CARDS =
-    NUM_DI + NUM_DO + NUM_AI + NUM_SIO + NUM_MATH + NUM_RTC;
+using HardwareProfile = FirmwareHardwareProfile;
+const uint8_t* const DI_Pins = HardwareProfile::BoardType::kDiPins;
+const uint8_t* const DO_Pins = HardwareProfile::BoardType::kDoPins;
+const uint8_t* const AI_Pins = HardwareProfile::BoardType::kAiPins;
+
+const uint8_t NUM_DI = HardwareProfile::kDiCount;
+const uint8_t NUM_DO = HardwareProfile::kDoCount;
+const uint8_t NUM_AI = HardwareProfile::kAiCount;
+const uint8_t NUM_SIO = HardwareProfile::kSioCount;
+const uint8_t NUM_MATH = HardwareProfile::kMathCount;
+const uint8_t NUM_RTC = HardwareProfile::kRtcCount;
+const uint8_t NUM_RTC_SCHED_CHANNELS = NUM_RTC;
+
+const uint8_t TOTAL_CARDS = HardwareProfile::kTotalCards;
 struct SharedRuntimeSnapshot : SharedRuntimeSnapshotT<TOTAL_CARDS> {};
 
-const uint8_t DI_START = 0;
-const uint8_t DO_START = DI_START + NUM_DI;
-const uint8_t AI_START = DO_START + NUM_DO;
-const uint8_t SIO_START = AI_START + NUM_AI;
-const uint8_t MATH_START = SIO_START + NUM_SIO;
-const uint8_t RTC_START = MATH_START + NUM_MATH;
+const uint8_t DI_START = HardwareProfile::kDiStart;
+const uint8_t DO_START = HardwareProfile::kDoStart;
+const uint8_t AI_START = HardwareProfile::kAiStart;
+const uint8_t SIO_START = HardwareProfile::kSioStart;
+const uint8_t MATH_START = HardwareProfile::kMathStart;
+const uint8_t RTC_START = HardwareProfile::kRtcStart;
+const V3CardLayout& kCardLayout = HardwareProfile::kLayout;
+static_assert(TOTAL_CARDS <= kV3ConfigContextMaxCards,
+              "hardware profile exceeds config context capacity");
+// Config lifecycle scratch (typed context, baseline and output cards),
+// shared by the portal handlers and boot-time loads; one holder at a time.
+using ConfigWorkspace = V3ConfigWorkspaceT<TOTAL_CARDS>;
+using ConfigWorkspaceLease = V3ConfigWorkspaceLease<TOTAL_CARDS>;
+ConfigWorkspace gConfigWorkspace;
 const char* kConfigPath = "/config.json";
 const char* kStagedConfigPath = "/config_staged.json";
 const char* kLkgConfigPath = "/config_lkg.json";
@@ -93,14 +114,18 @@ const uint32_t USER_WIFI_TIMEOUT_MS = 180000;
 const char* kApiVersion = "2.0";
 const char* kSchemaVersion = "2.0.0";
 
-const LegacyCardProfileLayout kLegacyCardLayout = {
-    TOTAL_CARDS, DO_START, AI_START, SIO_START, MATH_START, RTC_START,
-    DI_Pins,      DO_Pins,  AI_Pins,  SIO_Pins};
+const LegacyCardProfileLayout kLegacyCardLayout = {kCardLayout, DI_Pins,
+                                                   DO_Pins, AI_Pins};
+const V3ScanPlanPins kScanPlanPins = HardwareProfile::scanPlanPins();
 
 #ifndef LOGIC_ENGINE_DEBUG
 #define LOGIC_ENGINE_DEBUG 0
 #endif
 
+#ifndef INCREMENTAL_SCAN
+#define INCREMENTAL_SCAN 1
+#endif
+
 #if LOGIC_ENGINE_DEBUG
 #define LOGIC_DEBUG_PRINTLN(x) Serial.println(x)
 #else
@@ -120,20 +145,37 @@ V3RuntimeStoreView gRuntimeStore = {gDiRuntime, NUM_DI,   gDoRuntime, NUM_DO,
                                     gAiRuntime, NUM_AI,   gSioRuntime, NUM_SIO,
                                     gMathRuntime, NUM_MATH, gRtcRuntime, NUM_RTC};
 V3CardConfig gActiveTypedCards[TOTAL_CARDS] = {};
-V3RuntimeSignal gRuntimeSignals[TOTAL_CARDS] = {};
+V3SignalStorage<TOTAL_CARDS> gSignalStorage = {};
 RuntimeCardMeta gRuntimeCardMeta[TOTAL_CARDS] = {};
+V3ScanPlanEntry gScanPlan[TOTAL_CARDS] = {};
+uint16_t gDependencyOffsets[TOTAL_CARDS + 1] = {};
+uint8_t gDependents[TOTAL_CARDS * kV3MaxSourcesPerCard] = {};
+bool gCardScanDirty[TOTAL_CARDS] = {};
+uint8_t gTimerHeap[TOTAL_CARDS] = {};
+uint8_t gTimerPosition[TOTAL_CARDS] = {};
+uint32_t gTimerDueMs[TOTAL_CARDS] = {};
+uint32_t gCardInputSample[TOTAL_CARDS] = {};
 bool gPrevDISample[TOTAL_CARDS] = {};
 bool gPrevDIPrimed[TOTAL_CARDS] = {};
-bool gCardSetResult[TOTAL_CARDS] = {};
-bool gCardResetResult[TOTAL_CARDS] = {};
-bool gCardResetOverride[TOTAL_CARDS] = {};
-uint32_t gCardEvalCounter[TOTAL_CARDS] = {};
+#if CARD_PROFILING
+V3CardCost gCardCost[TOTAL_CARDS] = {};
+#endif
 
 QueueHandle_t gKernelCommandQueue = nullptr;
 TaskHandle_t gCore0TaskHandle = nullptr;
 TaskHandle_t gCore1TaskHandle = nullptr;
-portMUX_TYPE gSnapshotMux = portMUX_INITIALIZER_UNLOCKED;
-SharedRuntimeSnapshot gSharedSnapshot = {};
+// Single writer: setup() before the engine task starts, then only the
+// engine task. A paused kernel publishes nothing; config apply marks the
+// runtime dirty and the first iteration after resume publishes it.
+// Readers never block the writer.
+V3SnapshotSeqlock<SharedRuntimeSnapshot> gSharedSnapshot = {};
+// Cards and control arrays are rebuilt only when the runtime changed; a
+// metrics-only change carries them forward from the published buffer, at
+// most once per kSnapshotMetricsPublishMs.
+constexpr uint32_t kSnapshotMetricsPublishMs = 250;
+volatile bool gSnapshotRuntimeDirty = true;
+volatile bool gSnapshotMetricsDirty = false;
+SnapshotPublishGate gSnapshotPublishGate = {kSnapshotMetricsPublishMs, 0, 0};
 WebServer gPortalServer(80);
 WebSocketsServer gWsServer(81);
 char gUserSsid[33] = {};
@@ -141,6 +183,48 @@ char gUserPassword[65] = {};
 bool gPortalReconnectRequested = false;
 bool gPortalServerInitialized = false;
 bool gWsServerInitialized = false;
+// WebSocket delta stream (portal task only): patches are diffs against
+// gWsBaseline, the last broadcast frame; keyframes go out on connect,
+// resync request and every kWsKeyframeIntervalMs.
+const uint32_t kWsKeyframeIntervalMs = 10000;
+SharedRuntimeSnapshot gWsBaseline = {};
+bool gWsBaselineValid = false;
+uint32_t gWsLastKeyframeMs = 0;
+// Unsubscribed clients share the full keyframe/patch stream; subscribed
+// clients get per-client frames filtered by their subscription.
+struct WsClientStream {
+  bool connected;
+  bool keyframePending;
+  SnapshotEncoding encoding;
+  bool subscribed;
+  SnapshotSubscriber subscriber;
+};
+WsClientStream gWsClients[WEBSOCKETS_SERVER_CLIENT_MAX] = {};
+// Serialized keyframes shared by /api/snapshot and the WebSocket stream,
+// one reused patch buffer per encoding, and a reused per-client buffer
+// for subscribed frames (portal task only).
+SnapshotPayloadCache gSnapshotPayloadCache = {};
+SnapshotPayload gWsPatchPayload[kSnapshotEncodingCount] = {};
+SnapshotPayload gWsClientPayload = {};
+uint16_t gWsChangedFields[TOTAL_CARDS] = {};
+// Memory for request/response documents of the command, config and
+// WebSocket handlers, reset after each request so those requests no longer
+// fragment the heap. Budgeted in variant pools (1 KB each on the ESP32):
+// a staged save holds the uploaded config and its rebuilt envelope, about
+// 12 pools each for 18 cards at ~80 slots a card, plus one pool each for
+// the extras and the result. The remaining pools and 2 KB cover strings,
+// the pool lists and the body. Larger requests spill to the heap and show
+// up in `heapFallbacks` (/api/settings).
+constexpr size_t kPortalJsonArenaPools = 30;
+constexpr size_t kPortalJsonArenaBytes =
+    jsonArenaBytesFor(kPortalJsonArenaPools, 2048);
+alignas(8) uint8_t gPortalJsonArenaBuffer[kPortalJsonArenaBytes];
+JsonArena gPortalJsonArena(gPortalJsonArenaBuffer, kPortalJsonArenaBytes);
+// Per-client send timing, drops and evictions; reported in `metrics`.
+static_assert(WEBSOCKETS_SERVER_CLIENT_MAX <= kStreamClientsMax,
+              "stream metrics must cover every WebSocket client");
+SnapshotStreamMetrics gStreamMetrics = {};
+uint32_t gWsBaselineStreamRevision = 0;
 volatile bool gKernelPauseRequested = false;
 volatile bool gKernelPaused = false;
 uint32_t gConfigVersionCounter = 1;
@@ -151,7 +235,6 @@ char gSlot2Version[16] = "";
 char gSlot3Version[16] = "";
 
 runMode gRunMode = RUN_NORMAL;
-uint16_t gScanCursor = 0;
 bool gStepRequested = false;
 bool gBreakpointPaused = false;
 bool gTestModeActive = false;
@@ -161,12 +244,47 @@ bool gCardBreakpoint[TOTAL_CARDS] = {};
 bool gCardOutputMask[TOTAL_CARDS] = {};
 inputSourceMode gCardInputSource[TOTAL_CARDS] = {};
 uint32_t gCardForcedAIValue[TOTAL_CARDS] = {};
+
+V3ScanEngine makeScanEngine() {
+  V3ScanEngine engine = {};
+  engine.count = TOTAL_CARDS;
+  engine.plan = gScanPlan;
+  engine.meta = gRuntimeCardMeta;
+  engine.store = gRuntimeStore;
+  engine.signals = makeV3SignalStoreView(gSignalStorage, TOTAL_CARDS);
+  engine.dependencies = {gDependencyOffsets, gDependents, 0};
+  engine.timers = {gTimerHeap, gTimerPosition, gTimerDueMs, 0, TOTAL_CARDS};
+  engine.dirty = gCardScanDirty;
+  engine.inputSample = gCardInputSample;
+  engine.prevDISample = gPrevDISample;
+  engine.prevDIPrimed = gPrevDIPrimed;
+#if CARD_PROFILING
+  engine.cardCost = gCardCost;
+#endif
+  engine.inputSource = gCardInputSource;
+  engine.forcedAIValue = gCardForcedAIValue;
+  engine.outputMask = gCardOutputMask;
+  engine.globalOutputMask = &gGlobalOutputMask;
+  engine.io = makeEsp32IoBackend();
+  return engine;
+}
+
+V3ScanEngine gScanEngine = makeScanEngine();
 uint32_t gScanIntervalMs = kDefaultScanIntervalMs;
 uint32_t gLastCompleteScanUs = 0;
 uint32_t gMaxCompleteScanUs = 0;
 uint32_t gScanBudgetUs = kDefaultScanIntervalMs * 1000;
 uint32_t gScanOverrunCount = 0;
 bool gScanOverrunLast = false;
+uint16_t gScanCardsEvaluatedLast = 0;
+uint16_t gScanCardsSkippedLast = 0;
+uint32_t gIdleScansSkipped = 0;
+V3ScanSchedule gScanSchedule = {};
+uint32_t gScanScheduleIntervalMs = 0;
+esp_timer_handle_t gScanTimer = nullptr;
+LatencyHistogram gScanJitterHistogram = {};
+LatencyHistogram gScanDurationHistogram = {};
+LatencyHistogram gCommandLatencyHistogram = {};
 uint16_t gKernelQueueDepth = 0;
 uint16_t gKernelQueueHighWaterMark = 0;
 uint16_t gKernelQueueCapacity = 0;
@@ -182,16 +300,12 @@ uint32_t gRtcLastEvalMs = 0;
 
 using RtcScheduleChannel = V3RtcScheduleChannel;
 
-RtcScheduleChannel gRtcScheduleChannels[NUM_RTC_SCHED_CHANNELS] = {
-    {false, -1, -1, -1, -1, -1, -1, RTC_START},
-    {false, -1, -1, -1, -1, -1, -1, static_cast<uint8_t>(RTC_START + 1)},
-};
+RtcScheduleChannel gRtcScheduleChannels[NUM_RTC_SCHED_CHANNELS] = {};
 
-bool isOutputMasked(uint8_t cardId);
-uint8_t scanOrderCardIdFromCursor(uint16_t cursor);
 bool connectWiFiWithPolicy();
 bool applyCommand(JsonObjectConst command);
 bool setRtcCardStateCommand(uint8_t cardId, bool state);
+void wakeKernelTask();
 void updateSharedRuntimeSnapshot(uint32_t nowMs, bool incrementSeq);
 void initializeCardArraySafeDefaults(LogicCard* cards);
 void refreshActiveTypedCardsFromLegacy();
@@ -201,18 +315,46 @@ bool deserializeCardsFromArray(JsonArrayConst array, LogicCard* outCards);
 bool validateConfigCardsArray(JsonArrayConst array, String& reason);
 void serviceRtcMinuteScheduler(uint32_t nowMs);
 void syncRuntimeStateFromCards();
+void materializeLegacyCardsFromRuntime();
+void markAllScanCardsDirty();
 void writeConfigResultResponse(int statusCode, bool ok, const char* requestId,
                                const char* errorCode, const String& message,
                                JsonObject* extra = nullptr);
 void serializeCardsToV3Array(const LogicCard* sourceCards, JsonArray& cards);
 void buildV3ConfigEnvelope(const LogicCard* sourceCards, JsonDocument& doc,
                            const char* configId, const char* requestId);
+bool loadCardsIntoWorkspace(const char* path, ConfigWorkspace& workspace);
+
+void sendJsonResponse(int statusCode, const JsonDocument& doc) {
+  char* body = nullptr;
+  const size_t size = serializeJsonToArena(doc, gPortalJsonArena, body);
+  if (body == nullptr) {
+    gPortalServer.send(500, "application/json",
+                       "{\"ok\":false,\"error\":\"INTERNAL_ERROR\"}");
+    return;
+  }
+  gPortalServer.send_P(statusCode, "application/json", body, size);
+  gPortalJsonArena.deallocate(body);
+}
+
+void writeConfigWorkspaceBusyResponse(const char* requestId) {
+  writeConfigResultResponse(503, false, requestId, "BUSY",
+                            "config workspace in use");
+}
+
+void sendWebSocketJson(uint8_t clientNum, const JsonDocument& doc) {
+  char* body = nullptr;
+  const size_t size = serializeJsonToArena(doc, gPortalJsonArena, body);
+  if (body == nullptr) return;
+  gWsServer.sendTXT(clientNum, body, size);
+  gPortalJsonArena.deallocate(body);
+}
 
 void initializeAllCardsSafeDefaults() {
   profileInitializeCardArraySafeDefaults(logicCards, kLegacyCardLayout);
   syncRuntimeStateFromCards();
   refreshRuntimeSignalsFromRuntime(gRuntimeCardMeta, gRuntimeStore,
-                                   gRuntimeSignals, TOTAL_CARDS);
+                                   gScanEngine.signals);
 }
 
 void refreshActiveTypedCardsFromLegacy() {
@@ -234,9 +376,25 @@ void syncRuntimeStateFromCards() {
   refreshActiveTypedCardsFromLegacy();
   syncRuntimeStoreFromTypedCards(logicCards, gActiveTypedCards, TOTAL_CARDS,
                                  gRuntimeStore);
-  refreshRuntimeCardMetaFromTypedCards(gActiveTypedCards, TOTAL_CARDS, DO_START,
-                                       AI_START, SIO_START, MATH_START,
-                                       RTC_START, gRuntimeCardMeta);
+  refreshRuntimeCardMetaFromTypedCards(gActiveTypedCards, TOTAL_CARDS,
+                                       kCardLayout, gRuntimeCardMeta);
+  compileV3ScanPlan(gActiveTypedCards, gRuntimeCardMeta, TOTAL_CARDS,
+                    gRuntimeStore, kScanPlanPins, gScanPlan);
+  buildV3DependencyIndex(gScanPlan, TOTAL_CARDS, gScanEngine.dependencies);
+  clearV3TimerIndex(gScanEngine.timers);
+  markAllScanCardsDirty();
+#if CARD_PROFILING
+  resetV3CardCosts(gCardCost, TOTAL_CARDS);
+#endif
+  materializeLegacyCardsFromRuntime();
+}
+
+// The scan only touches the typed runtime store; the legacy LogicCard view's
+// runtime fields are brought up to date on demand. The store belongs to the
+// kernel task, so call this only before it starts or while it is paused.
+// Config export needs none of it: `logicCards` config fields only change on
+// config apply, with the kernel paused.
+void materializeLegacyCardsFromRuntime() {
   for (uint8_t i = 0; i < TOTAL_CARDS; ++i) {
     mirrorRuntimeStoreCardToLegacyByTyped(logicCards[i], gActiveTypedCards[i],
                                           gRuntimeStore);
@@ -248,16 +406,20 @@ bool saveLogicCardsToLittleFS() {
 }
 
 bool loadLogicCardsFromLittleFS() {
-  LogicCard loaded[TOTAL_CARDS];
-  if (!loadCardsFromPath(kConfigPath, loaded)) return false;
-  memcpy(logicCards, loaded, sizeof(logicCards));
+  ConfigWorkspaceLease lease(gConfigWorkspace);
+  ConfigWorkspace* workspace = lease.get();
+  if (workspace == nullptr) return false;
+  if (!loadCardsIntoWorkspace(kConfigPath, *workspace)) return false;
+  memcpy(logicCards, workspace->cards, sizeof(logicCards));
   syncRuntimeStateFromCards();
   refreshRuntimeSignalsFromRuntime(gRuntimeCardMeta, gRuntimeStore,
-                                   gRuntimeSignals, TOTAL_CARDS);
+                                   gScanEngine.signals);
   return true;
 }
 
 void printLogicCardsJsonToSerial(const char* label) {
+  if (pauseKernelForConfigApply(1000)) materializeLegacyCardsFromRuntime();
+  resumeKernelAfterConfigApply();
   JsonDocument doc;
   JsonArray array = doc.to<JsonArray>();
   for (uint8_t i = 0; i < TOTAL_CARDS; ++i) {
@@ -270,85 +432,40 @@ void printLogicCardsJsonToSerial(const char* label) {
   Serial.println();
 }
 
-void copySharedRuntimeSnapshot(SharedRuntimeSnapshot& outSnapshot) {
-  portENTER_CRITICAL(&gSnapshotMux);
-  outSnapshot = gSharedSnapshot;
-  portEXIT_CRITICAL(&gSnapshotMux);
-}
-
-void appendRuntimeSnapshotCard(JsonArray& cards,
-                               const SharedRuntimeSnapshot& snapshot,
-                               uint8_t cardId) {
-  const RuntimeSnapshotCard& card = snapshot.cards[cardId];
-  JsonObject node = cards.add<JsonObject>();
-  node["id"] = card.id;
-  node["type"] = toString(card.type);
-  node["index"] = card.index;
-  node["familyOrder"] = cardId;
-  node["physicalState"] = card.physicalState;
-  node["logicalState"] = card.logicalState;
-  node["triggerFlag"] = card.triggerFlag;
-  node["state"] = toString(card.state);
-  node["mode"] = toString(card.mode);
-  node["currentValue"] = card.currentValue;
-  node["startOnMs"] = card.startOnMs;
-  node["startOffMs"] = card.startOffMs;
-  node["repeatCounter"] = card.repeatCounter;
-
-  JsonObject forced = node["maskForced"].to<JsonObject>();
-  forced["inputSource"] = toString(snapshot.inputSource[cardId]);
-  forced["forcedAIValue"] = snapshot.forcedAIValue[cardId];
-  forced["outputMaskLocal"] = snapshot.outputMaskLocal[cardId];
-  forced["outputMasked"] =
-      (snapshot.globalOutputMask || snapshot.outputMaskLocal[cardId]);
-  node["breakpointEnabled"] = snapshot.breakpointEnabled[cardId];
-  node["setResult"] = snapshot.setResult[cardId];
-  node["resetResult"] = snapshot.resetResult[cardId];
-  node["resetOverride"] = snapshot.resetOverride[cardId];
-  node["evalCounter"] = snapshot.evalCounter[cardId];
-  JsonObject debug = node["debug"].to<JsonObject>();
-  debug["evalCounter"] = snapshot.evalCounter[cardId];
-  debug["breakpointEnabled"] = snapshot.breakpointEnabled[cardId];
-}
-
-void serializeRuntimeSnapshot(JsonDocument& doc, uint32_t nowMs) {
-  SharedRuntimeSnapshot snapshot = {};
-  copySharedRuntimeSnapshot(snapshot);
+void yieldPortalTask() { taskYIELD(); }
 
-  doc["type"] = "runtime_snapshot";
-  doc["schemaVersion"] = 1;
-  doc["tsMs"] = (snapshot.tsMs == 0) ? nowMs : snapshot.tsMs;
-  doc["scanIntervalMs"] = gScanIntervalMs;
-  doc["lastCompleteScanMs"] =
-      static_cast<double>(snapshot.lastCompleteScanUs) / 1000.0;
-  JsonObject metrics = doc["metrics"].to<JsonObject>();
-  metrics["scanLastUs"] = snapshot.lastCompleteScanUs;
-  metrics["scanMaxUs"] = snapshot.maxCompleteScanUs;
-  metrics["scanBudgetUs"] = snapshot.scanBudgetUs;
-  metrics["scanOverrunLast"] = snapshot.scanOverrunLast;
-  metrics["scanOverrunCount"] = snapshot.scanOverrunCount;
-  metrics["queueDepth"] = snapshot.kernelQueueDepth;
-  metrics["queueHighWaterMark"] = snapshot.kernelQueueHighWaterMark;
-  metrics["queueCapacity"] = snapshot.kernelQueueCapacity;
-  metrics["commandLatencyLastUs"] = snapshot.commandLatencyLastUs;
-  metrics["commandLatencyMaxUs"] = snapshot.commandLatencyMaxUs;
-  metrics["rtcMinuteTickCount"] = snapshot.rtcMinuteTickCount;
-  metrics["rtcIntentEnqueueCount"] = snapshot.rtcIntentEnqueueCount;
-  metrics["rtcIntentEnqueueFailCount"] = snapshot.rtcIntentEnqueueFailCount;
-  metrics["rtcLastEvalMs"] = snapshot.rtcLastEvalMs;
-  doc["runMode"] = toString(snapshot.mode);
-  doc["snapshotSeq"] = snapshot.seq;
-
-  JsonObject testMode = doc["testMode"].to<JsonObject>();
-  testMode["active"] = snapshot.testModeActive;
-  testMode["outputMaskGlobal"] = snapshot.globalOutputMask;
-  testMode["breakpointPaused"] = snapshot.breakpointPaused;
-  testMode["scanCursor"] = snapshot.scanCursor;
-
-  JsonArray cards = doc["cards"].to<JsonArray>();
-  for (uint8_t i = 0; i < TOTAL_CARDS; ++i) {
-    appendRuntimeSnapshotCard(cards, snapshot, scanOrderCardIdFromCursor(i));
+bool copySharedRuntimeSnapshot(SharedRuntimeSnapshot& outSnapshot) {
+  return readV3Snapshot(gSharedSnapshot, outSnapshot, yieldPortalTask);
+}
+
+// Reads only the published snapshot's key, so payload cache hits skip the
+// full snapshot copy.
+bool readSharedSnapshotKey(SnapshotPayloadKey& key) {
+  return readV3SnapshotWith(
+      gSharedSnapshot,
+      [&key](const SharedRuntimeSnapshot& snapshot) {
+        key = snapshotPayloadKey(snapshot);
+      },
+      yieldPortalTask);
+}
+
+const SnapshotPayload* currentSnapshotPayload(SnapshotEncoding encoding) {
+  SnapshotPayloadKey key = {};
+  if (readSharedSnapshotKey(key)) {
+    const SnapshotPayload* cached = findSnapshotPayload(
+        gSnapshotPayloadCache, key, encoding, &gStreamMetrics);
+    if (cached != nullptr) return cached;
   }
+  SharedRuntimeSnapshot snapshot = {};
+  if (!copySharedRuntimeSnapshot(snapshot)) {
+    // The kernel kept lapping the read; the last payload is at most a few
+    // scans old, which beats spinning the portal task.
+    if (!gSnapshotPayloadCache.valid[encoding]) return nullptr;
+    return &gSnapshotPayloadCache.payload[encoding];
+  }
+  return cacheRuntimeSnapshotPayload(gSnapshotPayloadCache, snapshot,
+                                     TOTAL_CARDS, millis(), gScanIntervalMs,
+                                     encoding, &gStreamMetrics);
 }
 
 bool waitForWiFiConnected(uint32_t timeoutMs) {
@@ -437,6 +554,12 @@ void handleHttpGetSettings() {
   doc["wifiConnected"] = (WiFi.status() == WL_CONNECTED);
   doc["wifiIp"] = WiFi.localIP().toString();
   doc["firmwareVersion"] = String(__DATE__) + " " + String(__TIME__);
+  const JsonArenaStats& arena = gPortalJsonArena.stats();
+  JsonObject arenaDoc = doc["portalJsonArena"].to<JsonObject>();
+  arenaDoc["capacity"] = arena.capacity;
+  arenaDoc["highWater"] = arena.highWater;
+  arenaDoc["heapFallbacks"] = arena.heapFallbacks;
+  arenaDoc["requests"] = arena.requests;
 
   String body;
   serializeJson(doc, body);
@@ -503,16 +626,33 @@ void handleHttpReboot() {
   ESP.restart();
 }
 
+SnapshotEncoding requestedSnapshotEncoding() {
+  if (gPortalServer.arg("format") == "msgpack") return SnapshotEncoding_MsgPack;
+  if (gPortalServer.header("Accept").indexOf("application/msgpack") >= 0) {
+    return SnapshotEncoding_MsgPack;
+  }
+  return SnapshotEncoding_Json;
+}
+
 void handleHttpSnapshot() {
-  JsonDocument doc;
-  serializeRuntimeSnapshot(doc, millis());
-  String body;
-  serializeJson(doc, body);
-  gPortalServer.send(200, "application/json", body);
+  const SnapshotEncoding encoding = requestedSnapshotEncoding();
+  const SnapshotPayload* payload = currentSnapshotPayload(encoding);
+  if (payload == nullptr) {
+    gPortalServer.send(503, "application/json",
+                       "{\"ok\":false,\"error\":\"OUT_OF_MEMORY\"}");
+    return;
+  }
+  gPortalServer.send_P(200,
+                       encoding == SnapshotEncoding_MsgPack
+                           ? "application/msgpack"
+                           : "application/json",
+                       reinterpret_cast<const char*>(payload->data),
+                       payload->size);
 }
 
 void handleHttpCommand() {
-  JsonDocument doc;
+  JsonArenaScope scope(gPortalJsonArena);
+  JsonDocument doc(&gPortalJsonArena);
   DeserializationError error = deserializeJson(doc, gPortalServer.arg("plain"));
   if (error || !doc.is<JsonObject>()) {
     gPortalServer.send(400, "application/json",
@@ -542,7 +682,8 @@ void handleHttpGetActiveConfig() {
 }
 
 void handleHttpStagedSaveConfig() {
-  JsonDocument request;
+  JsonArenaScope scope(gPortalJsonArena);
+  JsonDocument request(&gPortalJsonArena);
   DeserializationError parseError =
       deserializeJson(request, gPortalServer.arg("plain"));
   if (parseError || !request.is<JsonObjectConst>()) {
@@ -551,17 +692,21 @@ void handleHttpStagedSaveConfig() {
   }
 
   JsonObjectConst root = request.as<JsonObjectConst>();
-  V3ConfigContext configContext = {};
-  LogicCard baseline[TOTAL_CARDS];
-  initializeCardArraySafeDefaults(baseline);
+  const char* requestId = root["requestId"] | "";
+  ConfigWorkspaceLease lease(gConfigWorkspace);
+  if (lease.get() == nullptr) {
+    writeConfigWorkspaceBusyResponse(requestId);
+    return;
+  }
+  ConfigWorkspace& workspace = *lease.get();
+  V3ConfigContextT<TOTAL_CARDS>& configContext = workspace.context;
+  initializeCardArraySafeDefaults(workspace.baseline);
   String reason;
   const char* errorCode = "VALIDATION_FAILED";
-  const char* requestId = root["requestId"] | "";
-  const V3CardLayout layout = {TOTAL_CARDS, DO_START, AI_START,
-                               SIO_START,  MATH_START, RTC_START};
   if (!normalizeV3ConfigRequestContext(
-          root, layout, kApiVersion, kSchemaVersion, baseline, TOTAL_CARDS,
-          NUM_RTC_SCHED_CHANNELS, configContext, reason, errorCode)) {
+          root, kCardLayout, kApiVersion, kSchemaVersion, workspace.baseline,
+          TOTAL_CARDS, NUM_RTC_SCHED_CHANNELS, configContext, reason,
+          errorCode)) {
     writeConfigResultResponse(400, false, requestId, errorCode, reason);
     return;
   }
@@ -570,18 +715,16 @@ void handleHttpStagedSaveConfig() {
                                      gRtcScheduleChannels,
                                      NUM_RTC_SCHED_CHANNELS);
 
-  LogicCard stagedCards[TOTAL_CARDS];
   if (!buildLegacyCardsFromTypedWithBaseline(
-          configContext.typedCards, configContext.typedCount, baseline,
-          TOTAL_CARDS, stagedCards,
-          reason)) {
+          configContext.typedCards, configContext.typedCount,
+          workspace.baseline, TOTAL_CARDS, workspace.cards, reason)) {
     writeConfigResultResponse(500, false, requestId, "INTERNAL_ERROR",
                               reason);
     return;
   }
 
-  JsonDocument stagedDoc;
-  buildV3ConfigEnvelope(stagedCards, stagedDoc, "staged", requestId);
+  JsonDocument stagedDoc(&gPortalJsonArena);
+  buildV3ConfigEnvelope(workspace.cards, stagedDoc, "staged", requestId);
 
   if (!writeJsonToPath(kStagedConfigPath, stagedDoc)) {
     writeConfigResultResponse(500, false, requestId, "COMMIT_FAILED",
@@ -589,17 +732,23 @@ void handleHttpStagedSaveConfig() {
     return;
   }
 
-  JsonDocument extras;
+  JsonDocument extras(&gPortalJsonArena);
   extras["stagedVersion"] = "staged";
   JsonObject extrasObj = extras.as<JsonObject>();
   writeConfigResultResponse(200, true, requestId, nullptr, "", &extrasObj);
 }
 
 void handleHttpStagedValidateConfig() {
-  JsonDocument source;
-  V3ConfigContext configContext = {};
-  LogicCard baseline[TOTAL_CARDS];
-  initializeCardArraySafeDefaults(baseline);
+  JsonArenaScope scope(gPortalJsonArena);
+  ConfigWorkspaceLease lease(gConfigWorkspace);
+  if (lease.get() == nullptr) {
+    writeConfigWorkspaceBusyResponse("");
+    return;
+  }
+  ConfigWorkspace& workspace = *lease.get();
+  V3ConfigContextT<TOTAL_CARDS>& configContext = workspace.context;
+  initializeCardArraySafeDefaults(workspace.baseline);
+  JsonDocument source(&gPortalJsonArena);
   String reason;
   const char* requestId = "";
 
@@ -614,11 +763,10 @@ void handleHttpStagedValidateConfig() {
     JsonObjectConst root = source.as<JsonObjectConst>();
     requestId = root["requestId"] | "";
     const char* errorCode = "VALIDATION_FAILED";
-    const V3CardLayout layout = {TOTAL_CARDS, DO_START, AI_START,
-                                 SIO_START,  MATH_START, RTC_START};
     if (!normalizeV3ConfigRequestContext(
-            root, layout, kApiVersion, kSchemaVersion, baseline, TOTAL_CARDS,
-            NUM_RTC_SCHED_CHANNELS, configContext, reason, errorCode)) {
+            root, kCardLayout, kApiVersion, kSchemaVersion, workspace.baseline,
+            TOTAL_CARDS, NUM_RTC_SCHED_CHANNELS, configContext, reason,
+            errorCode)) {
       writeConfigResultResponse(400, false, requestId, errorCode, reason);
       return;
     }
@@ -636,11 +784,10 @@ void handleHttpStagedValidateConfig() {
     JsonObjectConst root = source.as<JsonObjectConst>();
     requestId = root["requestId"] | "";
     const char* errorCode = "VALIDATION_FAILED";
-    const V3CardLayout layout = {TOTAL_CARDS, DO_START, AI_START,
-                                 SIO_START,  MATH_START, RTC_START};
     if (!normalizeV3ConfigRequestContext(
-            root, layout, kApiVersion, kSchemaVersion, baseline, TOTAL_CARDS,
-            NUM_RTC_SCHED_CHANNELS, configContext, reason, errorCode)) {
+            root, kCardLayout, kApiVersion, kSchemaVersion, workspace.baseline,
+            TOTAL_CARDS, NUM_RTC_SCHED_CHANNELS, configContext, reason,
+            errorCode)) {
       writeConfigResultResponse(400, false, requestId, errorCode, reason);
       return;
     }
@@ -650,7 +797,7 @@ void handleHttpStagedValidateConfig() {
                                        NUM_RTC_SCHED_CHANNELS);
   }
 
-  JsonDocument extras;
+  JsonDocument extras(&gPortalJsonArena);
   JsonObject validation = extras["validation"].to<JsonObject>();
   validation["errors"].to<JsonArray>();
   validation["warnings"].to<JsonArray>();
@@ -674,13 +821,13 @@ void writeHistoryHead(JsonObject& head) {
   head["slot3Version"] = gSlot3Version;
 }
 
-bool commitCards(const V3ConfigContext& configContext, String& reason) {
-  LogicCard baseline[TOTAL_CARDS];
-  initializeCardArraySafeDefaults(baseline);
-  LogicCard nextCards[TOTAL_CARDS];
+// Builds the next cards from `workspace.context` into `workspace.cards`.
+bool commitCards(ConfigWorkspace& workspace, String& reason) {
+  initializeCardArraySafeDefaults(workspace.baseline);
+  LogicCard* nextCards = workspace.cards;
   if (!buildLegacyCardsFromTypedWithBaseline(
-          configContext.typedCards, configContext.typedCount, baseline,
-          TOTAL_CARDS, nextCards, reason)) {
+          workspace.context.typedCards, workspace.context.typedCount,
+          workspace.baseline, TOTAL_CARDS, nextCards, reason)) {
     return false;
   }
 
@@ -705,7 +852,12 @@ bool commitCards(const V3ConfigContext& configContext, String& reason) {
 }
 
 bool commitLegacyCards(JsonArrayConst cards, String& reason) {
-  LogicCard nextCards[TOTAL_CARDS];
+  ConfigWorkspaceLease lease(gConfigWorkspace);
+  if (lease.get() == nullptr) {
+    reason = "config workspace in use";
+    return false;
+  }
+  LogicCard* nextCards = lease.get()->cards;
   if (!deserializeCardsFromArray(cards, nextCards)) {
     reason = "failed to parse cards";
     return false;
@@ -732,10 +884,16 @@ bool commitLegacyCards(JsonArrayConst cards, String& reason) {
 }
 
 void handleHttpCommitConfig() {
-  JsonDocument sourceDoc;
-  V3ConfigContext configContext = {};
-  LogicCard baseline[TOTAL_CARDS];
-  initializeCardArraySafeDefaults(baseline);
+  JsonArenaScope scope(gPortalJsonArena);
+  ConfigWorkspaceLease lease(gConfigWorkspace);
+  if (lease.get() == nullptr) {
+    writeConfigWorkspaceBusyResponse("");
+    return;
+  }
+  ConfigWorkspace& workspace = *lease.get();
+  V3ConfigContextT<TOTAL_CARDS>& configContext = workspace.context;
+  initializeCardArraySafeDefaults(workspace.baseline);
+  JsonDocument sourceDoc(&gPortalJsonArena);
   String reason;
   const char* requestId = "";
   const bool hasInlinePayload =
@@ -751,11 +909,10 @@ void handleHttpCommitConfig() {
     JsonObjectConst root = sourceDoc.as<JsonObjectConst>();
     requestId = root["requestId"] | "";
     const char* errorCode = "VALIDATION_FAILED";
-    const V3CardLayout layout = {TOTAL_CARDS, DO_START, AI_START,
-                                 SIO_START,  MATH_START, RTC_START};
     if (!normalizeV3ConfigRequestContext(
-            root, layout, kApiVersion, kSchemaVersion, baseline, TOTAL_CARDS,
-            NUM_RTC_SCHED_CHANNELS, configContext, reason, errorCode)) {
+            root, kCardLayout, kApiVersion, kSchemaVersion, workspace.baseline,
+            TOTAL_CARDS, NUM_RTC_SCHED_CHANNELS, configContext, reason,
+            errorCode)) {
       writeConfigResultResponse(400, false, requestId, errorCode, reason);
       return;
     }
@@ -773,11 +930,10 @@ void handleHttpCommitConfig() {
     JsonObjectConst root = sourceDoc.as<JsonObjectConst>();
     requestId = root["requestId"] | "";
     const char* errorCode = "VALIDATION_FAILED";
-    const V3CardLayout layout = {TOTAL_CARDS, DO_START, AI_START,
-                                 SIO_START,  MATH_START, RTC_START};
     if (!normalizeV3ConfigRequestContext(
-            root, layout, kApiVersion, kSchemaVersion, baseline, TOTAL_CARDS,
-            NUM_RTC_SCHED_CHANNELS, configContext, reason, errorCode)) {
+            root, kCardLayout, kApiVersion, kSchemaVersion, workspace.baseline,
+            TOTAL_CARDS, NUM_RTC_SCHED_CHANNELS, configContext, reason,
+            errorCode)) {
       writeConfigResultResponse(400, false, requestId, errorCode, reason);
       return;
     }
@@ -787,12 +943,12 @@ void handleHttpCommitConfig() {
                                        NUM_RTC_SCHED_CHANNELS);
   }
 
-  if (!commitCards(configContext, reason)) {
+  if (!commitCards(workspace, reason)) {
     writeConfigResultResponse(500, false, requestId, "COMMIT_FAILED", reason);
     return;
   }
 
-  JsonDocument extras;
+  JsonDocument extras(&gPortalJsonArena);
   extras["activeVersion"] = gActiveVersion;
   JsonObject head = extras["historyHead"].to<JsonObject>();
   writeHistoryHead(head);
@@ -802,7 +958,8 @@ void handleHttpCommitConfig() {
 }
 
 void handleHttpRestoreConfig() {
-  JsonDocument request;
+  JsonArenaScope scope(gPortalJsonArena);
+  JsonDocument request(&gPortalJsonArena);
   DeserializationError parseError =
       deserializeJson(request, gPortalServer.arg("plain"));
   if (parseError || !request.is<JsonObjectConst>()) {
@@ -827,7 +984,7 @@ void handleHttpRestoreConfig() {
     return;
   }
 
-  JsonDocument doc;
+  JsonDocument doc(&gPortalJsonArena);
   if (!readJsonFromPath(restorePath, doc) || !doc.is<JsonArrayConst>()) {
     writeConfigErrorResponse(500, "RESTORE_FAILED",
                              "failed to load restore source");
@@ -844,15 +1001,13 @@ void handleHttpRestoreConfig() {
     return;
   }
 
-  JsonDocument response;
+  JsonDocument response(&gPortalJsonArena);
   response["ok"] = true;
   response["restoredFrom"] = source;
   response["activeVersion"] = gActiveVersion;
   response["requiresRestart"] = false;
   response["error"] = nullptr;
-  String body;
-  serializeJson(response, body);
-  gPortalServer.send(200, "application/json", body);
+  sendJsonResponse(200, response);
 }
 
 void initPortalServer() {
@@ -878,6 +1033,9 @@ void initPortalServer() {
   gPortalServer.on("/api/settings/reboot", HTTP_POST, handleHttpReboot);
   gPortalServer.on("/favicon.ico", HTTP_GET,
                    []() { gPortalServer.send(204, "text/plain", ""); });
+  // /api/snapshot negotiates MessagePack through Accept.
+  static const char* kCollectedHeaders[] = {"Accept"};
+  gPortalServer.collectHeaders(kCollectedHeaders, 1);
   gPortalServer.begin();
   gPortalServerInitialized = true;
   Serial.println("Portal HTTP server started on :80");
@@ -885,21 +1043,64 @@ void initPortalServer() {
 
 void handlePortalServerLoop() { gPortalServer.handleClient(); }
 
+void handleWebSocketSubscription(uint8_t clientNum, JsonObjectConst message,
+                                 bool subscribe) {
+  WsClientStream& client = gWsClients[clientNum];
+  SnapshotSubscription subscription = {};
+  const char* errorField = nullptr;
+  const bool ok =
+      !subscribe ||
+      parseSnapshotSubscription(message, kCardLayout, subscription, errorField);
+  if (ok) {
+    client.subscribed = subscribe;
+    resetSnapshotSubscriber(client.subscriber, subscription);
+    client.keyframePending = true;
+  }
+
+  JsonDocument result(&gPortalJsonArena);
+  result["type"] = "subscribe_result";
+  result["schemaVersion"] = 1;
+  result["ok"] = ok;
+  if (!ok) {
+    JsonObject err = result["error"].to<JsonObject>();
+    err["code"] = "INVALID_REQUEST";
+    err["field"] = errorField;
+  } else {
+    result["error"] = nullptr;
+  }
+  sendWebSocketJson(clientNum, result);
+}
+
 void handleWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t* payload,
                           size_t length) {
+  if (clientNum >= WEBSOCKETS_SERVER_CLIENT_MAX) return;
   if (type == WStype_CONNECTED) {
     IPAddress ip = gWsServer.remoteIP(clientNum);
     Serial.printf("WS client connected #%u from %u.%u.%u.%u\n", clientNum,
                   ip[0], ip[1], ip[2], ip[3]);
+    // The connect payload is the request URL; `?encoding=msgpack` selects
+    // binary snapshot frames for this client.
+    WsClientStream& client = gWsClients[clientNum];
+    client = {};
+    client.connected = true;
+    resetStreamClient(gStreamMetrics, clientNum, true);
+    client.keyframePending = true;
+    client.encoding =
+        strstr(reinterpret_cast<const char*>(payload), "encoding=msgpack")
+            ? SnapshotEncoding_MsgPack
+            : SnapshotEncoding_Json;
     return;
   }
   if (type == WStype_DISCONNECTED) {
     Serial.printf("WS client disconnected #%u\n", clientNum);
+    gWsClients[clientNum] = {};
+    resetStreamClient(gStreamMetrics, clientNum, false);
     return;
   }
   if (type != WStype_TEXT) return;
 
-  JsonDocument doc;
+  JsonArenaScope scope(gPortalJsonArena);
+  JsonDocument doc(&gPortalJsonArena);
   DeserializationError error =
       deserializeJson(doc, reinterpret_cast<const char*>(payload), length);
   if (error || !doc.is<JsonObject>()) {
@@ -911,6 +1112,15 @@ void handleWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t* payload,
 
   JsonObjectConst root = doc.as<JsonObjectConst>();
   const char* typeStr = root["type"] | "";
+  if (strcmp(typeStr, "resync") == 0) {
+    gWsClients[clientNum].keyframePending = true;
+    return;
+  }
+  if (strcmp(typeStr, "subscribe") == 0 ||
+      strcmp(typeStr, "unsubscribe") == 0) {
+    handleWebSocketSubscription(clientNum, root, typeStr[0] == 's');
+    return;
+  }
   if (strcmp(typeStr, "command") != 0) {
     gWsServer.sendTXT(clientNum,
                       "{\"type\":\"command_result\",\"ok\":false,"
@@ -921,7 +1131,7 @@ void handleWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t* payload,
   const char* requestId = root["requestId"] | "";
   bool ok = applyCommand(root);
 
-  JsonDocument result;
+  JsonDocument result(&gPortalJsonArena);
   result["type"] = "command_result";
   result["schemaVersion"] = 1;
   result["requestId"] = requestId;
@@ -932,9 +1142,7 @@ void handleWebSocketEvent(uint8_t clientNum, WStype_t type, uint8_t* payload,
   } else {
     result["error"] = nullptr;
   }
-  String body;
-  serializeJson(result, body);
-  gWsServer.sendTXT(clientNum, body);
+  sendWebSocketJson(clientNum, result);
 }
 
 void initWebSocketServer() {
@@ -947,27 +1155,165 @@ void initWebSocketServer() {
 
 void handleWebSocketLoop() { gWsServer.loop(); }
 
+// Sends block the portal task, so each one is timed for backpressure.
+void sendWebSocketPayload(uint8_t clientNum, const SnapshotPayload& payload,
+                          SnapshotEncoding encoding) {
+  const uint32_t startUs = micros();
+  const bool ok = encoding == SnapshotEncoding_MsgPack
+                      ? gWsServer.sendBIN(clientNum, payload.data, payload.size)
+                      : gWsServer.sendTXT(clientNum, payload.data, payload.size);
+  recordStreamSend(gStreamMetrics, clientNum, kStreamBackpressureDefaults, ok,
+                   micros() - startUs, millis());
+}
+
+void evictLaggingWebSocketClients(uint32_t nowMs) {
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+    if (!streamClientShouldEvict(gStreamMetrics, i,
+                                 kStreamBackpressureDefaults, nowMs)) {
+      continue;
+    }
+    Serial.printf("WS client #%u evicted: lagging\n", i);
+    recordStreamEviction(gStreamMetrics, i);
+    gWsClients[i] = {};
+    gWsServer.disconnect(i);
+  }
+}
+
+// Per-client frames for subscribed clients. Changes against gWsBaseline
+// accumulate per client until its rate allows a frame, so each patch
+// covers everything subscribed since that client's previous frame.
+void publishSubscribedSnapshotFrames(const SharedRuntimeSnapshot& snapshot,
+                                     uint32_t nowMs, bool periodicKeyframe) {
+  bool anySubscribed = false;
+  for (const WsClientStream& client : gWsClients) {
+    if (client.connected && client.subscribed) anySubscribed = true;
+  }
+  if (!anySubscribed) return;
+
+  for (uint8_t i = 0; i < TOTAL_CARDS; ++i) {
+    gWsChangedFields[i] =
+        gWsBaselineValid
+            ? runtimeSnapshotCardChangedFields(gWsBaseline, snapshot, i)
+            : kSnapshotCardFieldsAll;
+  }
+  const bool metricsChanged =
+      !gWsBaselineValid ||
+      runtimeSnapshotMetricsChanged(gWsBaseline, snapshot) ||
+      gStreamMetrics.revision != gWsBaselineStreamRevision;
+  const bool headerChanged =
+      !gWsBaselineValid || runtimeSnapshotHeaderChanged(gWsBaseline, snapshot);
+  const SnapshotPayloadKey key = snapshotPayloadKey(snapshot);
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+    WsClientStream& client = gWsClients[i];
+    if (!client.connected || !client.subscribed) continue;
+    SnapshotSubscriber& subscriber = client.subscriber;
+    if (periodicKeyframe || client.keyframePending) subscriber.hasBase = false;
+    accumulateSnapshotSubscriberChanges(subscriber, gWsChangedFields,
+                                        TOTAL_CARDS, metricsChanged,
+                                        headerChanged);
+    // A lagging subscriber keeps accumulating, so its next frame merges
+    // everything it skipped.
+    if (!snapshotSubscriberDue(subscriber, nowMs)) continue;
+    if (!streamClientMaySend(gStreamMetrics, i, nowMs)) continue;
+    JsonDocument doc;
+    serializeSubscribedSnapshotFrame(doc, snapshot, TOTAL_CARDS, nowMs,
+                                     gScanIntervalMs, subscriber,
+                                     client.encoding, &gStreamMetrics);
+    if (!encodeSnapshotPayload(doc, client.encoding, gWsClientPayload)) {
+      continue;
+    }
+    client.keyframePending = false;
+    sendWebSocketPayload(i, gWsClientPayload, client.encoding);
+    markSnapshotSubscriberSent(subscriber, key, nowMs);
+  }
+}
+
 void publishRuntimeSnapshotWebSocket() {
   static uint32_t lastPublishMs = 0;
-  static uint32_t lastSeq = 0;
 
-  SharedRuntimeSnapshot snapshot = {};
-  copySharedRuntimeSnapshot(snapshot);
   uint32_t nowMs = millis();
-
-  bool hasUpdate = (snapshot.seq != lastSeq);
+  evictLaggingWebSocketClients(nowMs);
+  bool keyframeRequested = false;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+    const WsClientStream& client = gWsClients[i];
+    if (!client.connected || !client.keyframePending) continue;
+    if (!streamClientBackingOff(gStreamMetrics, i, nowMs)) {
+      keyframeRequested = true;
+    }
+  }
+  SnapshotPayloadKey publishedKey = {};
+  bool hasUpdate = !gWsBaselineValid ||
+                   !readSharedSnapshotKey(publishedKey) ||
+                   publishedKey.seq != gWsBaseline.seq;
   bool dueHeartbeat = (nowMs - lastPublishMs) >= 1000;
-  if (!hasUpdate && !dueHeartbeat) return;
+  if (!hasUpdate && !dueHeartbeat && !keyframeRequested) return;
   if ((nowMs - lastPublishMs) < 200 && hasUpdate) return;
 
-  JsonDocument doc;
-  serializeRuntimeSnapshot(doc, nowMs);
-  String payload;
-  serializeJson(doc, payload);
-  gWsServer.broadcastTXT(payload);
+  SharedRuntimeSnapshot snapshot = {};
+  // Lapped by the kernel: skip this round, the next portal loop retries.
+  if (!copySharedRuntimeSnapshot(snapshot)) return;
+  const bool periodicKeyframe =
+      !gWsBaselineValid || (nowMs - gWsLastKeyframeMs) >= kWsKeyframeIntervalMs;
+  if (periodicKeyframe) gWsLastKeyframeMs = nowMs;
+  const uint32_t streamRevision = gStreamMetrics.revision;
+
+  // Each payload is serialized at most once per encoding; keyframes come
+  // from the cache HTTP reads share, patches from a reused buffer. Clients
+  // due a keyframe (connect, resync, periodic) get one in place of a patch.
+  // A lagging client skips frames and then resumes with a keyframe, so it
+  // always receives the newest state.
+  for (uint8_t e = 0; e < kSnapshotEncodingCount; ++e) {
+    const SnapshotEncoding encoding = static_cast<SnapshotEncoding>(e);
+    bool wantKeyframe = false;
+    bool wantPatch = false;
+    for (const WsClientStream& client : gWsClients) {
+      if (!client.connected || client.subscribed) continue;
+      if (client.encoding != encoding) continue;
+      if (periodicKeyframe || client.keyframePending) {
+        wantKeyframe = true;
+      } else {
+        wantPatch = true;
+      }
+    }
+    const SnapshotPayload* keyframe =
+        wantKeyframe ? cacheRuntimeSnapshotPayload(
+                           gSnapshotPayloadCache, snapshot, TOTAL_CARDS, nowMs,
+                           gScanIntervalMs, encoding, &gStreamMetrics)
+                     : nullptr;
+    const SnapshotPayload* patch = nullptr;
+    if (wantPatch) {
+      JsonDocument doc;
+      serializeRuntimeSnapshotPatch(doc, gWsBaseline, snapshot, TOTAL_CARDS,
+                                    nowMs, gScanIntervalMs, encoding,
+                                    &gStreamMetrics, gWsBaselineStreamRevision);
+      if (encodeSnapshotPayload(doc, encoding, gWsPatchPayload[e])) {
+        patch = &gWsPatchPayload[e];
+      }
+    }
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; ++i) {
+      WsClientStream& client = gWsClients[i];
+      if (!client.connected || client.subscribed) continue;
+      if (client.encoding != encoding) continue;
+      if (!streamClientMaySend(gStreamMetrics, i, nowMs)) {
+        client.keyframePending = true;
+        continue;
+      }
+      if (periodicKeyframe || client.keyframePending) {
+        if (keyframe == nullptr) continue;
+        client.keyframePending = false;
+        sendWebSocketPayload(i, *keyframe, encoding);
+      } else if (patch != nullptr) {
+        sendWebSocketPayload(i, *patch, encoding);
+      }
+    }
+  }
 
+  publishSubscribedSnapshotFrames(snapshot, nowMs, periodicKeyframe);
+
+  gWsBaseline = snapshot;
+  gWsBaselineValid = true;
+  gWsBaselineStreamRevision = streamRevision;
   lastPublishMs = nowMs;
-  lastSeq = snapshot.seq;
 }
 
 void configureHardwarePinsSafeState() {
@@ -983,9 +1329,11 @@ void configureHardwarePinsSafeState() {
 void bootstrapCardsFromStorage() {
   // Keep factory baseline aligned with current firmware defaults.
   {
-    LogicCard factoryCards[TOTAL_CARDS];
-    initializeCardArraySafeDefaults(factoryCards);
-    saveCardsToPath(kFactoryConfigPath, factoryCards);
+    ConfigWorkspaceLease lease(gConfigWorkspace);
+    if (lease.get() != nullptr) {
+      initializeCardArraySafeDefaults(lease.get()->cards);
+      saveCardsToPath(kFactoryConfigPath, lease.get()->cards);
+    }
   }
 
   initializeAllCardsSafeDefaults();
@@ -1037,7 +1385,7 @@ void initializeRuntimeControlState() {
 
   gRunMode = RUN_NORMAL;
   gScanIntervalMs = kDefaultScanIntervalMs;
-  gScanCursor = 0;
+  gScanEngine.cursor = 0;
   gStepRequested = false;
   gBreakpointPaused = false;
   gTestModeActive = false;
@@ -1048,11 +1396,10 @@ void initializeRuntimeControlState() {
     gCardInputSource[i] = InputSource_Real;
     gCardForcedAIValue[i] = 0;
   }
-}
-
-bool isOutputMasked(uint8_t cardId) {
-  if (!isDigitalOutputCard(cardId)) return false;
-  return gGlobalOutputMask || gCardOutputMask[cardId];
+  for (uint8_t i = 0; i < NUM_RTC_SCHED_CHANNELS; ++i) {
+    gRtcScheduleChannels[i] = {false, -1, -1, -1, -1, -1, -1,
+                               static_cast<uint8_t>(RTC_START + i)};
+  }
 }
 
 bool setRunModeCommand(runMode mode) {
@@ -1229,55 +1576,55 @@ void serializeCardsToV3Array(const LogicCard* sourceCards, JsonArray& cards) {
 
     JsonObject cfg = v3["config"].to<JsonObject>();
     if (typed.family == V3CardFamily::DI) {
+      const V3DiConfig& di = typed.asDi();
       v3["cardType"] = "DI";
-      cfg["channel"] = typed.di.channel;
-      cfg["invert"] = typed.di.invert;
-      cfg["debounceTime"] = typed.di.debounceTimeMs;
-      if (typed.di.edgeMode == Mode_DI_Falling) {
+      cfg["channel"] = di.channel;
+      cfg["invert"] = di.invert;
+      cfg["debounceTime"] = di.debounceTimeMs;
+      if (di.edgeMode == Mode_DI_Falling) {
         cfg["edgeMode"] = "FALLING";
-      } else if (typed.di.edgeMode == Mode_DI_Change) {
+      } else if (di.edgeMode == Mode_DI_Change) {
         cfg["edgeMode"] = "CHANGE";
       } else {
         cfg["edgeMode"] = "RISING";
       }
       JsonObject set = cfg["set"].to<JsonObject>();
-      writeV3ConditionBlock(
-          set, typed.cardId, typed.di.set.clauseAId,
-          typed.di.set.clauseAOperator, typed.di.set.clauseAThreshold,
-          typed.di.set.clauseBId, typed.di.set.clauseBOperator,
-          typed.di.set.clauseBThreshold, typed.di.set.combiner);
+      writeV3ConditionBlock(set, typed.cardId, di.set.clauseAId,
+                            di.set.clauseAOperator, di.set.clauseAThreshold,
+                            di.set.clauseBId, di.set.clauseBOperator,
+                            di.set.clauseBThreshold, di.set.combiner);
       JsonObject reset = cfg["reset"].to<JsonObject>();
-      writeV3ConditionBlock(
-          reset, typed.cardId, typed.di.reset.clauseAId,
-          typed.di.reset.clauseAOperator, typed.di.reset.clauseAThreshold,
-          typed.di.reset.clauseBId, typed.di.reset.clauseBOperator,
-          typed.di.reset.clauseBThreshold, typed.di.reset.combiner);
+      writeV3ConditionBlock(reset, typed.cardId, di.reset.clauseAId,
+                            di.reset.clauseAOperator, di.reset.clauseAThreshold,
+                            di.reset.clauseBId, di.reset.clauseBOperator,
+                            di.reset.clauseBThreshold, di.reset.combiner);
       cfg["counterVisible"] = true;
       continue;
     }
 
     if (typed.family == V3CardFamily::AI) {
+      const V3AiConfig& ai = typed.asAi();
       v3["cardType"] = "AI";
-      cfg["channel"] = typed.ai.channel;
+      cfg["channel"] = ai.channel;
       cfg["engineeringUnit"] = "raw";
       JsonObject inRange = cfg["inputRange"].to<JsonObject>();
-      inRange["min"] = typed.ai.inputMin;
-      inRange["max"] = typed.ai.inputMax;
+      inRange["min"] = ai.inputMin;
+      inRange["max"] = ai.inputMax;
       JsonObject clampRange = cfg["clampRange"].to<JsonObject>();
-      clampRange["min"] = typed.ai.inputMin;
-      clampRange["max"] = typed.ai.inputMax;
+      clampRange["min"] = ai.inputMin;
+      clampRange["max"] = ai.inputMax;
       JsonObject outRange = cfg["outputRange"].to<JsonObject>();
-      outRange["min"] = typed.ai.outputMin;
-      outRange["max"] = typed.ai.outputMax;
-      cfg["emaAlpha"] = typed.ai.emaAlphaX100;
+      outRange["min"] = ai.outputMin;
+      outRange["max"] = ai.outputMax;
+      cfg["emaAlpha"] = ai.emaAlphaX100;
       continue;
     }
 
     if (typed.family == V3CardFamily::DO || typed.family == V3CardFamily::SIO) {
-      v3["cardType"] = (typed.family == V3CardFamily::DO) ? "DO" : "SIO";
-      if (typed.family == V3CardFamily::DO) cfg["channel"] = typed.dout.channel;
-      cardMode mode =
-          (typed.family == V3CardFamily::DO) ? typed.dout.mode : typed.sio.mode;
+      const bool isDo = typed.family == V3CardFamily::DO;
+      v3["cardType"] = isDo ? "DO" : "SIO";
+      if (isDo) cfg["channel"] = typed.asDo().channel;
+      const cardMode mode = isDo ? typed.asDo().mode : typed.asSio().mode;
       if (mode == Mode_DO_Immediate) {
         cfg["mode"] = "Immediate";
       } else if (mode == Mode_DO_Gated) {
@@ -1285,44 +1632,33 @@ void serializeCardsToV3Array(const LogicCard* sourceCards, JsonArray& cards) {
       } else {
         cfg["mode"] = "Normal";
       }
-      if (typed.family == V3CardFamily::DO) {
-        cfg["delayBeforeON"] = typed.dout.delayBeforeOnMs;
-        cfg["onDuration"] = typed.dout.onDurationMs;
-        cfg["repeatCount"] = typed.dout.repeatCount;
+      if (isDo) {
+        const V3DoConfig& dout = typed.asDo();
+        cfg["delayBeforeON"] = dout.delayBeforeOnMs;
+        cfg["onDuration"] = dout.onDurationMs;
+        cfg["repeatCount"] = dout.repeatCount;
       } else {
-        cfg["delayBeforeON"] = typed.sio.delayBeforeOnMs;
-        cfg["onDuration"] = typed.sio.onDurationMs;
-        cfg["repeatCount"] = typed.sio.repeatCount;
+        const V3SioConfig& sio = typed.asSio();
+        cfg["delayBeforeON"] = sio.delayBeforeOnMs;
+        cfg["onDuration"] = sio.onDurationMs;
+        cfg["repeatCount"] = sio.repeatCount;
       }
+      const V3ConditionBlock& setBlock =
+          isDo ? typed.asDo().set : typed.asSio().set;
+      const V3ConditionBlock& resetBlock =
+          isDo ? typed.asDo().reset : typed.asSio().reset;
       JsonObject set = cfg["set"].to<JsonObject>();
-      if (typed.family == V3CardFamily::DO) {
-        writeV3ConditionBlock(
-            set, typed.cardId, typed.dout.set.clauseAId,
-            typed.dout.set.clauseAOperator, typed.dout.set.clauseAThreshold,
-            typed.dout.set.clauseBId, typed.dout.set.clauseBOperator,
-            typed.dout.set.clauseBThreshold, typed.dout.set.combiner);
-      } else {
-        writeV3ConditionBlock(
-            set, typed.cardId, typed.sio.set.clauseAId,
-            typed.sio.set.clauseAOperator, typed.sio.set.clauseAThreshold,
-            typed.sio.set.clauseBId, typed.sio.set.clauseBOperator,
-            typed.sio.set.clauseBThreshold, typed.sio.set.combiner);
-      }
+      writeV3ConditionBlock(set, typed.cardId, setBlock.clauseAId,
+                            setBlock.clauseAOperator, setBlock.clauseAThreshold,
+                            setBlock.clauseBId, setBlock.clauseBOperator,
+                            setBlock.clauseBThreshold, setBlock.combiner);
       JsonObject reset = cfg["reset"].to<JsonObject>();
-      if (typed.family == V3CardFamily::DO) {
-        writeV3ConditionBlock(
-            reset, typed.cardId, typed.dout.reset.clauseAId,
-            typed.dout.reset.clauseAOperator, typed.dout.reset.clauseAThreshold,
-            typed.dout.reset.clauseBId, typed.dout.reset.clauseBOperator,
-            typed.dout.reset.clauseBThreshold, typed.dout.reset.combiner);
-      } else {
-        writeV3ConditionBlock(
-            reset, typed.cardId, typed.sio.reset.clauseAId,
-            typed.sio.reset.clauseAOperator, typed.sio.reset.clauseAThreshold,
-            typed.sio.reset.clauseBId, typed.sio.reset.clauseBOperator,
-            typed.sio.reset.clauseBThreshold, typed.sio.reset.combiner);
-      }
-      if (typed.family == V3CardFamily::SIO) {
+      writeV3ConditionBlock(
+          reset, typed.cardId, resetBlock.clauseAId, resetBlock.clauseAOperator,
+          resetBlock.clauseAThreshold, resetBlock.clauseBId,
+          resetBlock.clauseBOperator, resetBlock.clauseBThreshold,
+          resetBlock.combiner);
+      if (!isDo) {
         JsonObject policy = cfg["writePolicy"].to<JsonObject>();
         JsonArray roles = policy["allowedRoles"].to<JsonArray>();
         roles.add("OPERATOR");
@@ -1333,48 +1669,49 @@ void serializeCardsToV3Array(const LogicCard* sourceCards, JsonArray& cards) {
     }
 
     if (typed.family == V3CardFamily::MATH) {
+      const V3MathConfig& math = typed.asMath();
       v3["cardType"] = "MATH";
       cfg["mode"] = "Mode_Standard_Pipeline";
       JsonObject set = cfg["set"].to<JsonObject>();
-      writeV3ConditionBlock(
-          set, typed.cardId, typed.math.set.clauseAId,
-          typed.math.set.clauseAOperator, typed.math.set.clauseAThreshold,
-          typed.math.set.clauseBId, typed.math.set.clauseBOperator,
-          typed.math.set.clauseBThreshold, typed.math.set.combiner);
+      writeV3ConditionBlock(set, typed.cardId, math.set.clauseAId,
+                            math.set.clauseAOperator, math.set.clauseAThreshold,
+                            math.set.clauseBId, math.set.clauseBOperator,
+                            math.set.clauseBThreshold, math.set.combiner);
       JsonObject reset = cfg["reset"].to<JsonObject>();
-      writeV3ConditionBlock(
-          reset, typed.cardId, typed.math.reset.clauseAId,
-          typed.math.reset.clauseAOperator, typed.math.reset.clauseAThreshold,
-          typed.math.reset.clauseBId, typed.math.reset.clauseBOperator,
-          typed.math.reset.clauseBThreshold, typed.math.reset.combiner);
-      cfg["fallbackValue"] = typed.math.fallbackValue;
+      writeV3ConditionBlock(reset, typed.cardId, math.reset.clauseAId,
+                            math.reset.clauseAOperator,
+                            math.reset.clauseAThreshold, math.reset.clauseBId,
+                            math.reset.clauseBOperator,
+                            math.reset.clauseBThreshold, math.reset.combiner);
+      cfg["fallbackValue"] = math.fallbackValue;
       JsonObject standard = cfg["standard"].to<JsonObject>();
       JsonObject inputA = standard["inputA"].to<JsonObject>();
       inputA["sourceMode"] = "CONSTANT";
-      inputA["value"] = typed.math.inputA;
+      inputA["value"] = math.inputA;
       JsonObject inputB = standard["inputB"].to<JsonObject>();
       inputB["sourceMode"] = "CONSTANT";
-      inputB["value"] = typed.math.inputB;
+      inputB["value"] = math.inputB;
       standard["operator"] = "ADD";
       standard["rateLimit"] = 0;
-      standard["clampMin"] = typed.math.clampMin;
-      standard["clampMax"] = typed.math.clampMax;
-      standard["scaleMin"] = typed.math.clampMin;
-      standard["scaleMax"] = typed.math.clampMax;
+      standard["clampMin"] = math.clampMin;
+      standard["clampMax"] = math.clampMax;
+      standard["scaleMin"] = math.clampMin;
+      standard["scaleMax"] = math.clampMax;
       standard["emaAlpha"] = 100;
       cfg["pid"] = nullptr;
       continue;
     }
 
     v3["cardType"] = "RTC";
+    const V3RtcConfig& rtc = typed.asRtc();
     JsonObject schedule = cfg["schedule"].to<JsonObject>();
-    if (typed.rtc.hasYear) schedule["year"] = typed.rtc.year;
-    if (typed.rtc.hasMonth) schedule["month"] = typed.rtc.month;
-    if (typed.rtc.hasDay) schedule["day"] = typed.rtc.day;
-    if (typed.rtc.hasWeekday) schedule["weekday"] = typed.rtc.weekday;
-    schedule["hour"] = typed.rtc.hour;
-    schedule["minute"] = typed.rtc.minute;
-    cfg["triggerDuration"] = typed.rtc.triggerDurationMs;
+    if (rtc.hasYear) schedule["year"] = rtc.year;
+    if (rtc.hasMonth) schedule["month"] = rtc.month;
+    if (rtc.hasDay) schedule["day"] = rtc.day;
+    if (rtc.hasWeekday) schedule["weekday"] = rtc.weekday;
+    schedule["hour"] = rtc.hour;
+    schedule["minute"] = rtc.minute;
+    cfg["triggerDuration"] = rtc.triggerDurationMs;
   }
 }
 
@@ -1418,9 +1755,7 @@ bool deserializeCardsFromArray(JsonArrayConst array, LogicCard* outCards) {
 }
 
 bool validateConfigCardsArray(JsonArrayConst array, String& reason) {
-  return validateLegacyConfigCardsArray(array, TOTAL_CARDS, DO_START, AI_START,
-                                        SIO_START, MATH_START, RTC_START,
-                                        reason);
+  return validateLegacyConfigCardsArray(array, kCardLayout, reason);
 }
 
 bool writeJsonToPath(const char* path, JsonDocument& doc) {
@@ -1480,24 +1815,24 @@ bool saveCardsToPath(const char* path, const LogicCard* sourceCards) {
   return writeJsonToPath(path, doc);
 }
 
-bool loadCardsFromPath(const char* path, LogicCard* outCards) {
+// Loads `path` into `workspace.cards`, using the rest of the workspace as
+// scratch.
+bool loadCardsIntoWorkspace(const char* path, ConfigWorkspace& workspace) {
   JsonDocument doc;
   if (!readJsonFromPath(path, doc)) return false;
   if (doc.is<JsonArrayConst>()) {
-    return deserializeCardsFromArray(doc.as<JsonArrayConst>(), outCards);
+    return deserializeCardsFromArray(doc.as<JsonArrayConst>(),
+                                     workspace.cards);
   }
   if (!doc.is<JsonObjectConst>()) return false;
-  V3ConfigContext configContext = {};
-  LogicCard baseline[TOTAL_CARDS];
-  initializeCardArraySafeDefaults(baseline);
+  V3ConfigContextT<TOTAL_CARDS>& configContext = workspace.context;
+  initializeCardArraySafeDefaults(workspace.baseline);
   String reason;
   const char* errorCode = "VALIDATION_FAILED";
-  const V3CardLayout layout = {TOTAL_CARDS, DO_START, AI_START,
-                               SIO_START,  MATH_START, RTC_START};
   if (!normalizeV3ConfigRequestContext(
-          doc.as<JsonObjectConst>(), layout, kApiVersion, kSchemaVersion,
-          baseline, TOTAL_CARDS, NUM_RTC_SCHED_CHANNELS, configContext, reason,
-          errorCode)) {
+          doc.as<JsonObjectConst>(), kCardLayout, kApiVersion, kSchemaVersion,
+          workspace.baseline, TOTAL_CARDS, NUM_RTC_SCHED_CHANNELS,
+          configContext, reason, errorCode)) {
     return false;
   }
   applyRtcScheduleChannelsFromConfig(configContext.rtcChannels,
@@ -1505,8 +1840,16 @@ bool loadCardsFromPath(const char* path, LogicCard* outCards) {
                                      gRtcScheduleChannels,
                                      NUM_RTC_SCHED_CHANNELS);
   return buildLegacyCardsFromTypedWithBaseline(
-      configContext.typedCards, configContext.typedCount, baseline, TOTAL_CARDS,
-      outCards, reason);
+      configContext.typedCards, configContext.typedCount, workspace.baseline,
+      TOTAL_CARDS, workspace.cards, reason);
+}
+
+bool loadCardsFromPath(const char* path, LogicCard* outCards) {
+  ConfigWorkspaceLease lease(gConfigWorkspace);
+  if (lease.get() == nullptr) return false;
+  if (!loadCardsIntoWorkspace(path, *lease.get())) return false;
+  memcpy(outCards, lease.get()->cards, sizeof(lease.get()->cards));
+  return true;
 }
 
 bool copyFileIfExists(const char* srcPath, const char* dstPath) {
@@ -1539,6 +1882,7 @@ void formatVersion(char* out, size_t outSize, uint32_t version) {
 
 bool pauseKernelForConfigApply(uint32_t timeoutMs) {
   gKernelPauseRequested = true;
+  wakeKernelTask();
   uint32_t start = millis();
   while (!gKernelPaused && (millis() - start) < timeoutMs) {
     vTaskDelay(pdMS_TO_TICKS(2));
@@ -1546,7 +1890,10 @@ bool pauseKernelForConfigApply(uint32_t timeoutMs) {
   return gKernelPaused;
 }
 
-void resumeKernelAfterConfigApply() { gKernelPauseRequested = false; }
+void resumeKernelAfterConfigApply() {
+  gKernelPauseRequested = false;
+  wakeKernelTask();
+}
 
 void rotateHistoryVersions() {
   strncpy(gSlot3Version, gSlot2Version, sizeof(gSlot3Version) - 1);
@@ -1567,10 +1914,10 @@ bool applyCardsAsActiveConfig(const LogicCard* newCards) {
   memcpy(logicCards, newCards, sizeof(logicCards));
   syncRuntimeStateFromCards();
   refreshRuntimeSignalsFromRuntime(gRuntimeCardMeta, gRuntimeStore,
-                                   gRuntimeSignals, TOTAL_CARDS);
+                                   gScanEngine.signals);
   memset(gPrevDISample, 0, sizeof(gPrevDISample));
   memset(gPrevDIPrimed, 0, sizeof(gPrevDIPrimed));
-  updateSharedRuntimeSnapshot(millis(), false);
+  gSnapshotRuntimeDirty = true;
   resumeKernelAfterConfigApply();
   return true;
 }
@@ -1607,7 +1954,8 @@ void writeConfigErrorResponse(int statusCode, const char* code,
 void writeConfigResultResponse(int statusCode, bool ok, const char* requestId,
                                const char* errorCode, const String& message,
                                JsonObject* extra) {
-  JsonDocument doc;
+  JsonArenaScope scope(gPortalJsonArena);
+  JsonDocument doc(&gPortalJsonArena);
   doc["apiVersion"] = kApiVersion;
   doc["requestId"] = requestId;
   doc["status"] = ok ? "SUCCESS" : "FAILURE";
@@ -1623,9 +1971,7 @@ void writeConfigResultResponse(int statusCode, bool ok, const char* requestId,
       doc[kv.key()] = kv.value();
     }
   }
-  String body;
-  serializeJson(doc, body);
-  gPortalServer.send(statusCode, "application/json", body);
+  sendJsonResponse(statusCode, doc);
 }
 
 bool requestStepCommand() {
@@ -1686,43 +2032,52 @@ bool setInputForceCommand(uint8_t cardId, inputSourceMode mode,
   return true;
 }
 
+// Starts a fresh measurement window for scan/command timing metrics.
+bool resetTimingStatsCommand() {
+  resetLatencyHistogram(gScanDurationHistogram);
+  resetLatencyHistogram(gCommandLatencyHistogram);
+  resetLatencyHistogram(gScanJitterHistogram);
+  gMaxCompleteScanUs = 0;
+  gScanOverrunCount = 0;
+  gCommandLatencyMaxUs = 0;
+  gKernelQueueHighWaterMark = gKernelQueueDepth;
+#if CARD_PROFILING
+  resetV3CardCosts(gCardCost, TOTAL_CARDS);
+#endif
+  return true;
+}
+
 bool setRtcCardStateCommand(uint8_t cardId, bool state) {
   if (cardId >= TOTAL_CARDS) return false;
   const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
   if (cfgCard == nullptr || cfgCard->family != V3CardFamily::RTC) return false;
-  LogicCard& card = logicCards[cardId];
   if (cardId < RTC_START) return false;
   const uint8_t rtcIndex = static_cast<uint8_t>(cardId - RTC_START);
   V3RtcRuntimeState* runtime = runtimeRtcStateAt(rtcIndex, gRuntimeStore);
   if (runtime == nullptr) return false;
 
-  runtime->logicalState = state;
-  runtime->physicalState = state;
-  runtime->triggerFlag = state;  // one-minute assertion edge for condition logic
-  runtime->currentValue = state ? 1U : 0U;
-  if (state) {
-    runtime->triggerStartMs = millis();
-  }
-  if (!state) {
-    runtime->triggerFlag = false;
-    runtime->triggerStartMs = 0;
-  }
-  mirrorRuntimeStoreCardToLegacyByTyped(card, *cfgCard, gRuntimeStore);
-  refreshRuntimeSignalAt(gRuntimeCardMeta, gRuntimeStore, gRuntimeSignals,
-                         TOTAL_CARDS, cardId);
+  applyV3RtcCardState(*runtime, state, millis());
+  refreshRuntimeSignalAt(gRuntimeCardMeta, gRuntimeStore, gScanEngine.signals,
+                         cardId);
   return true;
 }
 
+void wakeKernelTask() {
+  if (gCore0TaskHandle != nullptr) xTaskNotifyGive(gCore0TaskHandle);
+}
+
 bool enqueueKernelCommand(const KernelCommand& command) {
   if (gKernelCommandQueue == nullptr) return false;
   KernelCommand commandToQueue = command;
   commandToQueue.enqueuedUs = micros();
   bool queued = xQueueSend(gKernelCommandQueue, &commandToQueue, 0) == pdTRUE;
+  if (queued) wakeKernelTask();
   gKernelQueueDepth =
       static_cast<uint16_t>(uxQueueMessagesWaiting(gKernelCommandQueue));
   if (gKernelQueueDepth > gKernelQueueHighWaterMark) {
     gKernelQueueHighWaterMark = gKernelQueueDepth;
   }
+  gSnapshotMetricsDirty = true;
   return queued;
 }
 
@@ -1745,6 +2100,8 @@ bool applyKernelCommand(const KernelCommand& command) {
       return setGlobalOutputMaskCommand(command.flag);
     case KernelCmd_SetRtcCardState:
       return setRtcCardStateCommand(command.cardId, command.flag);
+    case KernelCmd_ResetTimingStats:
+      return resetTimingStatsCommand();
     default:
       return false;
   }
@@ -1758,118 +2115,82 @@ void processKernelCommandQueue() {
     uint32_t latencyUs = nowUs - command.enqueuedUs;
     gCommandLatencyLastUs = latencyUs;
     if (latencyUs > gCommandLatencyMaxUs) gCommandLatencyMaxUs = latencyUs;
+    recordLatencySample(gCommandLatencyHistogram, latencyUs);
     applyKernelCommand(command);
+    markAllScanCardsDirty();
+    gSnapshotRuntimeDirty = true;
   }
-  gKernelQueueDepth =
+  const uint16_t queueDepth =
       static_cast<uint16_t>(uxQueueMessagesWaiting(gKernelCommandQueue));
+  if (queueDepth != gKernelQueueDepth) gSnapshotMetricsDirty = true;
+  gKernelQueueDepth = queueDepth;
   if (gKernelQueueDepth > gKernelQueueHighWaterMark) {
     gKernelQueueHighWaterMark = gKernelQueueDepth;
   }
 }
 
 void updateSharedRuntimeSnapshot(uint32_t nowMs, bool incrementSeq) {
-  portENTER_CRITICAL(&gSnapshotMux);
-  if (incrementSeq) gSharedSnapshot.seq += 1;
-  gSharedSnapshot.tsMs = nowMs;
-  gSharedSnapshot.lastCompleteScanUs = gLastCompleteScanUs;
-  gSharedSnapshot.maxCompleteScanUs = gMaxCompleteScanUs;
-  gSharedSnapshot.scanBudgetUs = gScanBudgetUs;
-  gSharedSnapshot.scanOverrunCount = gScanOverrunCount;
-  gSharedSnapshot.scanOverrunLast = gScanOverrunLast;
-  gSharedSnapshot.kernelQueueDepth = gKernelQueueDepth;
-  gSharedSnapshot.kernelQueueHighWaterMark = gKernelQueueHighWaterMark;
-  gSharedSnapshot.kernelQueueCapacity = gKernelQueueCapacity;
-  gSharedSnapshot.commandLatencyLastUs = gCommandLatencyLastUs;
-  gSharedSnapshot.commandLatencyMaxUs = gCommandLatencyMaxUs;
-  gSharedSnapshot.rtcMinuteTickCount = gRtcMinuteTickCount;
-  gSharedSnapshot.rtcIntentEnqueueCount = gRtcIntentEnqueueCount;
-  gSharedSnapshot.rtcIntentEnqueueFailCount = gRtcIntentEnqueueFailCount;
-  gSharedSnapshot.rtcLastEvalMs = gRtcLastEvalMs;
-  gSharedSnapshot.mode = gRunMode;
-  gSharedSnapshot.testModeActive = gTestModeActive;
-  gSharedSnapshot.globalOutputMask = gGlobalOutputMask;
-  gSharedSnapshot.breakpointPaused = gBreakpointPaused;
-  gSharedSnapshot.scanCursor = gScanCursor;
-  buildRuntimeSnapshotCards(gRuntimeCardMeta, TOTAL_CARDS, gRuntimeStore,
-                            gSharedSnapshot.cards);
-  memcpy(gSharedSnapshot.inputSource, gCardInputSource,
-         sizeof(gCardInputSource));
-  memcpy(gSharedSnapshot.forcedAIValue, gCardForcedAIValue,
-         sizeof(gCardForcedAIValue));
-  memcpy(gSharedSnapshot.outputMaskLocal, gCardOutputMask,
-         sizeof(gCardOutputMask));
-  memcpy(gSharedSnapshot.breakpointEnabled, gCardBreakpoint,
-         sizeof(gCardBreakpoint));
-  memcpy(gSharedSnapshot.setResult, gCardSetResult, sizeof(gCardSetResult));
-  memcpy(gSharedSnapshot.resetResult, gCardResetResult,
-         sizeof(gCardResetResult));
-  memcpy(gSharedSnapshot.resetOverride, gCardResetOverride,
-         sizeof(gCardResetOverride));
-  memcpy(gSharedSnapshot.evalCounter, gCardEvalCounter,
-         sizeof(gCardEvalCounter));
-  portEXIT_CRITICAL(&gSnapshotMux);
-}
-
-uint8_t scanOrderCardIdFromCursor(uint16_t cursor) {
-  return static_cast<uint8_t>((TOTAL_CARDS == 0) ? 0 : (cursor % TOTAL_CARDS));
-}
-
-bool evalOperator(const V3RuntimeSignal& target, logicOperator op,
-                  uint32_t threshold) {
-  switch (op) {
-    case Op_AlwaysTrue:
-      return true;
-    case Op_AlwaysFalse:
-      return false;
-    case Op_LogicalTrue:
-      return target.logicalState;
-    case Op_LogicalFalse:
-      return !target.logicalState;
-    case Op_PhysicalOn:
-      return target.physicalState;
-    case Op_PhysicalOff:
-      return !target.physicalState;
-    case Op_Triggered:
-      return target.triggerFlag;
-    case Op_TriggerCleared:
-      return !target.triggerFlag;
-    case Op_GT:
-      return target.currentValue > threshold;
-    case Op_LT:
-      return target.currentValue < threshold;
-    case Op_EQ:
-      return target.currentValue == threshold;
-    case Op_NEQ:
-      return target.currentValue != threshold;
-    case Op_GTE:
-      return target.currentValue >= threshold;
-    case Op_LTE:
-      return target.currentValue <= threshold;
-    case Op_Running:
-      return isMissionRunning(target.type, target.state);
-    case Op_Finished:
-      return isMissionFinished(target.type, target.state);
-    case Op_Stopped:
-      return isMissionStopped(target.type, target.state);
-    default:
-      return false;
+  if (incrementSeq) gSnapshotRuntimeDirty = true;
+  const SnapshotPublishKind kind =
+      takeSnapshotPublish(gSnapshotPublishGate, gSnapshotRuntimeDirty,
+                          gSnapshotMetricsDirty, nowMs);
+  if (kind == SnapshotPublish_None) return;
+  const bool rebuildCards = (kind == SnapshotPublish_Full);
+  gSnapshotRuntimeDirty = false;
+  gSnapshotMetricsDirty = false;
+
+  const SharedRuntimeSnapshot& published =
+      publishedV3Snapshot(gSharedSnapshot);
+  const uint32_t seq = published.seq + (incrementSeq ? 1U : 0U);
+  SharedRuntimeSnapshot& snapshot = beginV3SnapshotWrite(gSharedSnapshot);
+  if (!rebuildCards) snapshot = published;
+  snapshot.seq = seq;
+  snapshot.tsMs = nowMs;
+  snapshot.lastCompleteScanUs = gLastCompleteScanUs;
+  snapshot.maxCompleteScanUs = gMaxCompleteScanUs;
+  snapshot.scanBudgetUs = gScanBudgetUs;
+  snapshot.scanOverrunCount = gScanOverrunCount;
+  snapshot.scanOverrunLast = gScanOverrunLast;
+  snapshot.scanCardsEvaluatedLast = gScanCardsEvaluatedLast;
+  snapshot.scanCardsSkippedLast = gScanCardsSkippedLast;
+  snapshot.idleScansSkipped = gIdleScansSkipped;
+  snapshot.snapshotRebuildsAvoided = gSnapshotPublishGate.rebuildsAvoided;
+  snapshot.scanJitterP50Us =
+      latencyHistogramQuantileUs(gScanJitterHistogram, 5000);
+  snapshot.scanJitterP99Us =
+      latencyHistogramQuantileUs(gScanJitterHistogram, 9900);
+  snapshot.scanJitterMaxUs = gScanJitterHistogram.maxUs;
+  snapshot.scanDurationHistogram = gScanDurationHistogram;
+  snapshot.commandLatencyHistogram = gCommandLatencyHistogram;
+  snapshot.kernelQueueDepth = gKernelQueueDepth;
+  snapshot.kernelQueueHighWaterMark = gKernelQueueHighWaterMark;
+  snapshot.kernelQueueCapacity = gKernelQueueCapacity;
+  snapshot.commandLatencyLastUs = gCommandLatencyLastUs;
+  snapshot.commandLatencyMaxUs = gCommandLatencyMaxUs;
+  snapshot.rtcMinuteTickCount = gRtcMinuteTickCount;
+  snapshot.rtcIntentEnqueueCount = gRtcIntentEnqueueCount;
+  snapshot.rtcIntentEnqueueFailCount = gRtcIntentEnqueueFailCount;
+  snapshot.rtcLastEvalMs = gRtcLastEvalMs;
+  snapshot.mode = gRunMode;
+  snapshot.testModeActive = gTestModeActive;
+  snapshot.globalOutputMask = gGlobalOutputMask;
+  snapshot.breakpointPaused = gBreakpointPaused;
+  snapshot.scanCursor = gScanEngine.cursor;
+  if (rebuildCards) {
+    buildRuntimeSnapshotCards(gRuntimeCardMeta, TOTAL_CARDS, gRuntimeStore,
+                              snapshot.cards);
+    memcpy(snapshot.inputSource, gCardInputSource, sizeof(gCardInputSource));
+    memcpy(snapshot.forcedAIValue, gCardForcedAIValue,
+           sizeof(gCardForcedAIValue));
+    memcpy(snapshot.outputMaskLocal, gCardOutputMask, sizeof(gCardOutputMask));
+    memcpy(snapshot.breakpointEnabled, gCardBreakpoint,
+           sizeof(gCardBreakpoint));
+    snapshot.signals = gSignalStorage;
+#if CARD_PROFILING
+    memcpy(snapshot.cardCost, gCardCost, sizeof(gCardCost));
+#endif
   }
-}
-
-bool evalCondition(uint8_t aId, logicOperator aOp, uint32_t aTh, uint8_t bId,
-                   logicOperator bOp, uint32_t bTh, combineMode combine) {
-  const V3RuntimeSignal* aSignal = (aId < TOTAL_CARDS) ? &gRuntimeSignals[aId] : nullptr;
-  bool aResult =
-      (aSignal != nullptr) ? evalOperator(*aSignal, aOp, aTh) : false;
-  if (combine == Combine_None) return aResult;
-
-  const V3RuntimeSignal* bSignal = (bId < TOTAL_CARDS) ? &gRuntimeSignals[bId] : nullptr;
-  bool bResult =
-      (bSignal != nullptr) ? evalOperator(*bSignal, bOp, bTh) : false;
-
-  if (combine == Combine_AND) return aResult && bResult;
-  if (combine == Combine_OR) return aResult || bResult;
-  return false;
+  publishV3SnapshotWrite(gSharedSnapshot);
 }
 
 const V3CardConfig* activeTypedCardConfig(uint8_t cardId) {
@@ -1877,267 +2198,11 @@ const V3CardConfig* activeTypedCardConfig(uint8_t cardId) {
   return &gActiveTypedCards[cardId];
 }
 
-bool evalTypedConditionBlock(const V3ConditionBlock& block) {
-  return evalCondition(block.clauseAId, block.clauseAOperator,
-                       block.clauseAThreshold, block.clauseBId,
-                       block.clauseBOperator, block.clauseBThreshold,
-                       block.combiner);
-}
-
-void processDICard(uint8_t cardId, uint32_t nowMs) {
-  if (cardId >= TOTAL_CARDS) return;
-  const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
-  if (cfgCard == nullptr || cfgCard->family != V3CardFamily::DI) return;
-  const V3DiConfig& cfgTyped = cfgCard->di;
-  LogicCard& card = logicCards[cardId];
-  V3DiRuntimeState* runtime = runtimeDiStateAt(cfgTyped.channel, gRuntimeStore);
-  if (runtime == nullptr) return;
-
-  bool sample = false;
-  inputSourceMode sourceMode = InputSource_Real;
-  sourceMode = gCardInputSource[cardId];
-  uint8_t hwPin = 255;
-  if (cfgTyped.channel < NUM_DI) hwPin = DI_Pins[cfgTyped.channel];
-
-  if (sourceMode == InputSource_ForcedHigh) {
-    sample = true;
-  } else if (sourceMode == InputSource_ForcedLow) {
-    sample = false;
-  } else if (hwPin != 255) {
-    sample = (digitalRead(hwPin) == HIGH);
-  }
-  if (cfgTyped.invert) sample = !sample;
-
-  const bool setCondition = evalTypedConditionBlock(cfgTyped.set);
-  const bool resetCondition = evalTypedConditionBlock(cfgTyped.reset);
-
-  V3DiRuntimeConfig cfg = {};
-  cfg.debounceTimeMs = cfgTyped.debounceTimeMs;
-  cfg.edgeMode = cfgTyped.edgeMode;
-
-  V3DiStepInput in = {};
-  in.nowMs = nowMs;
-  in.sample = sample;
-  in.setCondition = setCondition;
-  in.resetCondition = resetCondition;
-  in.prevSample = gPrevDISample[cardId];
-  in.prevSampleValid = gPrevDIPrimed[cardId];
-
-  V3DiStepOutput out = {};
-  runV3DiStep(cfg, *runtime, in, out);
-
-  mirrorRuntimeStoreCardToLegacyByTyped(card, *cfgCard, gRuntimeStore);
-
-  gPrevDISample[cardId] = out.nextPrevSample;
-  gPrevDIPrimed[cardId] = out.nextPrevSampleValid;
-  gCardSetResult[cardId] = out.setResult;
-  gCardResetResult[cardId] = out.resetResult;
-  gCardResetOverride[cardId] = out.resetOverride;
-}
-
-void processAICard(uint8_t cardId) {
-  if (cardId >= TOTAL_CARDS) return;
-  const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
-  if (cfgCard == nullptr || cfgCard->family != V3CardFamily::AI) return;
-  const V3AiConfig& cfgTyped = cfgCard->ai;
-  LogicCard& card = logicCards[cardId];
-  V3AiRuntimeState* runtime = runtimeAiStateAt(cfgTyped.channel, gRuntimeStore);
-  if (runtime == nullptr) return;
-  gCardSetResult[cardId] = false;
-  gCardResetResult[cardId] = false;
-  gCardResetOverride[cardId] = false;
-  uint32_t raw = 0;
-  inputSourceMode sourceMode = InputSource_Real;
-  sourceMode = gCardInputSource[cardId];
-
-  if (sourceMode == InputSource_ForcedValue) {
-    raw = gCardForcedAIValue[cardId];
-  } else if (cfgTyped.channel < NUM_AI) {
-    raw = static_cast<uint32_t>(analogRead(AI_Pins[cfgTyped.channel]));
-  }
-
-  V3AiRuntimeConfig cfg = {};
-  cfg.inputMin = cfgTyped.inputMin;
-  cfg.inputMax = cfgTyped.inputMax;
-  cfg.outputMin = cfgTyped.outputMin;
-  cfg.outputMax = cfgTyped.outputMax;
-  cfg.emaAlphaX1000 = cfgTyped.emaAlphaX100 * 10U;
-
-  V3AiStepInput in = {};
-  in.rawSample = raw;
-
-  runV3AiStep(cfg, *runtime, in);
-
-  mirrorRuntimeStoreCardToLegacyByTyped(card, *cfgCard, gRuntimeStore);
-}
-
-void processDOCard(uint8_t cardId, uint32_t nowMs, bool driveHardware) {
-  if (cardId >= TOTAL_CARDS) return;
-  const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
-  if (cfgCard == nullptr || cfgCard->family != V3CardFamily::DO) return;
-  const V3DoConfig& cfgTyped = cfgCard->dout;
-  LogicCard& card = logicCards[cardId];
-  V3DoRuntimeState* runtime = runtimeDoStateAt(cfgTyped.channel, gRuntimeStore);
-  if (runtime == nullptr) return;
-
-  const bool setCondition = evalTypedConditionBlock(cfgTyped.set);
-  const bool resetCondition = evalTypedConditionBlock(cfgTyped.reset);
-  gCardSetResult[cardId] = setCondition;
-  gCardResetResult[cardId] = resetCondition;
-  gCardResetOverride[cardId] = setCondition && resetCondition;
-
-  V3DoRuntimeConfig cfg = {};
-  cfg.mode = cfgTyped.mode;
-  cfg.delayBeforeOnMs = cfgTyped.delayBeforeOnMs;
-  cfg.onDurationMs = cfgTyped.onDurationMs;
-  cfg.repeatCount = cfgTyped.repeatCount;
-
-  V3DoStepInput in = {};
-  in.nowMs = nowMs;
-  in.setCondition = setCondition;
-  in.resetCondition = resetCondition;
-
-  V3DoStepOutput out = {};
-  runV3DoStep(cfg, *runtime, in, out);
-
-  mirrorRuntimeStoreCardToLegacyByTyped(card, *cfgCard, gRuntimeStore);
-  uint8_t hwPin = 255;
-  if (cfgTyped.channel < NUM_DO) hwPin = DO_Pins[cfgTyped.channel];
-  if (driveHardware && hwPin != 255 && !isOutputMasked(cardId)) {
-    digitalWrite(hwPin, out.effectiveOutput ? HIGH : LOW);
-  }
-}
-
-void processSIOCard(uint8_t cardId, uint32_t nowMs) {
-  if (cardId >= TOTAL_CARDS) return;
-  const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
-  if (cfgCard == nullptr || cfgCard->family != V3CardFamily::SIO) return;
-  const V3SioConfig& cfgTyped = cfgCard->sio;
-  LogicCard& card = logicCards[cardId];
-  if (cardId < SIO_START) return;
-  V3SioRuntimeState* runtime =
-      runtimeSioStateAt(static_cast<uint8_t>(cardId - SIO_START), gRuntimeStore);
-  if (runtime == nullptr) return;
-
-  const bool setCondition = evalTypedConditionBlock(cfgTyped.set);
-  const bool resetCondition = evalTypedConditionBlock(cfgTyped.reset);
-  gCardSetResult[cardId] = setCondition;
-  gCardResetResult[cardId] = resetCondition;
-  gCardResetOverride[cardId] = setCondition && resetCondition;
-
-  V3SioRuntimeConfig cfg = {};
-  cfg.mode = cfgTyped.mode;
-  cfg.delayBeforeOnMs = cfgTyped.delayBeforeOnMs;
-  cfg.onDurationMs = cfgTyped.onDurationMs;
-  cfg.repeatCount = cfgTyped.repeatCount;
-
-  V3SioStepInput in = {};
-  in.nowMs = nowMs;
-  in.setCondition = setCondition;
-  in.resetCondition = resetCondition;
-
-  V3SioStepOutput out = {};
-  runV3SioStep(cfg, *runtime, in, out);
-
-  mirrorRuntimeStoreCardToLegacyByTyped(card, *cfgCard, gRuntimeStore);
-}
-
-void processMathCard(uint8_t cardId) {
-  if (cardId >= TOTAL_CARDS) return;
-  const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
-  if (cfgCard == nullptr || cfgCard->family != V3CardFamily::MATH) return;
-  const V3MathConfig& cfgTyped = cfgCard->math;
-  LogicCard& card = logicCards[cardId];
-  if (cardId < MATH_START) return;
-  V3MathRuntimeState* runtime = runtimeMathStateAt(
-      static_cast<uint8_t>(cardId - MATH_START), gRuntimeStore);
-  if (runtime == nullptr) return;
-
-  const bool setCondition = evalTypedConditionBlock(cfgTyped.set);
-  const bool resetCondition = evalTypedConditionBlock(cfgTyped.reset);
-  gCardSetResult[cardId] = setCondition;
-  gCardResetResult[cardId] = resetCondition;
-  gCardResetOverride[cardId] = setCondition && resetCondition;
-
-  V3MathRuntimeConfig cfg = {};
-  cfg.inputA = cfgTyped.inputA;
-  cfg.inputB = cfgTyped.inputB;
-  cfg.fallbackValue = cfgTyped.fallbackValue;
-  cfg.clampMin = cfgTyped.clampMin;
-  cfg.clampMax = cfgTyped.clampMax;
-  cfg.clampEnabled = (cfgTyped.clampMax >= cfgTyped.clampMin);
-
-  V3MathStepInput in = {};
-  in.setCondition = setCondition;
-  in.resetCondition = resetCondition;
-
-  V3MathStepOutput out = {};
-  runV3MathStep(cfg, *runtime, in, out);
-
-  mirrorRuntimeStoreCardToLegacyByTyped(card, *cfgCard, gRuntimeStore);
-}
-
-void processRtcCard(uint8_t cardId, uint32_t nowMs) {
-  if (cardId >= TOTAL_CARDS) return;
-  const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
-  if (cfgCard == nullptr || cfgCard->family != V3CardFamily::RTC) return;
-  const V3RtcConfig& cfgTyped = cfgCard->rtc;
-  LogicCard& card = logicCards[cardId];
-  if (cardId < RTC_START) return;
-  V3RtcRuntimeState* runtime =
-      runtimeRtcStateAt(static_cast<uint8_t>(cardId - RTC_START), gRuntimeStore);
-  if (runtime == nullptr) return;
-  gCardSetResult[cardId] = false;
-  gCardResetResult[cardId] = false;
-  gCardResetOverride[cardId] = false;
-
-  V3RtcRuntimeConfig cfg = {};
-  cfg.triggerDurationMs = cfgTyped.triggerDurationMs;
-
-  V3RtcStepInput in = {};
-  in.nowMs = nowMs;
-
-  runV3RtcStep(cfg, *runtime, in);
-
-  mirrorRuntimeStoreCardToLegacyByTyped(card, *cfgCard, gRuntimeStore);
-}
-
-void processCardById(uint8_t cardId, uint32_t nowMs) {
-  if (cardId >= TOTAL_CARDS) return;
-  const V3CardConfig* cfgCard = activeTypedCardConfig(cardId);
-  if (cfgCard == nullptr) return;
-  switch (cfgCard->family) {
-    case V3CardFamily::DI:
-      processDICard(cardId, nowMs);
-      return;
-    case V3CardFamily::AI:
-      processAICard(cardId);
-      return;
-    case V3CardFamily::SIO:
-      processSIOCard(cardId, nowMs);
-      return;
-    case V3CardFamily::DO:
-      processDOCard(cardId, nowMs, true);
-      return;
-    case V3CardFamily::MATH:
-      processMathCard(cardId);
-      return;
-    case V3CardFamily::RTC:
-      processRtcCard(cardId, nowMs);
-      return;
-    default:
-      return;
-  }
-}
+void markAllScanCardsDirty() { markAllV3ScanCardsDirty(gScanEngine); }
 
 void processOneScanOrderedCard(uint32_t nowMs, bool honorBreakpoints) {
-  uint8_t cardId = scanOrderCardIdFromCursor(gScanCursor);
-  processCardById(cardId, nowMs);
-  refreshRuntimeSignalAt(gRuntimeCardMeta, gRuntimeStore, gRuntimeSignals,
-                         TOTAL_CARDS, cardId);
-  gCardEvalCounter[cardId] += 1;
-
-  gScanCursor = static_cast<uint16_t>((gScanCursor + 1) % TOTAL_CARDS);
+  const bool evaluateAll = !INCREMENTAL_SCAN || gRunMode == RUN_STEP;
+  const uint8_t cardId = runV3ScanCursorCard(gScanEngine, nowMs, evaluateAll);
 
   if (honorBreakpoints && gRunMode == RUN_BREAKPOINT &&
       gCardBreakpoint[cardId]) {
@@ -2146,6 +2211,10 @@ void processOneScanOrderedCard(uint32_t nowMs, bool honorBreakpoints) {
 }
 
 bool runFullScanCycle(uint32_t nowMs, bool honorBreakpoints) {
+  if (gScanEngine.cursor == 0) {
+    gScanEngine.cardsEvaluated = 0;
+    gScanEngine.cardsSkipped = 0;
+  }
   for (uint8_t i = 0; i < TOTAL_CARDS; ++i) {
     processOneScanOrderedCard(nowMs, honorBreakpoints);
     if (gBreakpointPaused) return false;
@@ -2153,29 +2222,49 @@ bool runFullScanCycle(uint32_t nowMs, bool honorBreakpoints) {
   return true;
 }
 
-void runEngineIteration(uint32_t nowMs, uint32_t& lastScanMs) {
-  processKernelCommandQueue();
+void onScanTimerDeadline(void* arg) {
+  (void)arg;
+  wakeKernelTask();
+}
+
+void armScanSchedule(uint32_t nowUs, uint32_t intervalMs) {
+  gScanScheduleIntervalMs = intervalMs;
+  armV3ScanSchedule(gScanSchedule, nowUs, intervalMs * 1000);
+  if (gScanTimer == nullptr) return;
+  esp_timer_stop(gScanTimer);
+  esp_timer_start_periodic(gScanTimer, static_cast<uint64_t>(intervalMs) * 1000);
+}
+
+void runEngineIteration(uint32_t nowUs) {
+  // While paused, core1 owns the runtime store: leave queued commands and
+  // the snapshot alone until resume.
   if (gKernelPauseRequested) {
     gKernelPaused = true;
-    updateSharedRuntimeSnapshot(nowMs, false);
     return;
   }
   gKernelPaused = false;
-  if (lastScanMs == 0) {
-    lastScanMs = nowMs;
-  }
+  const uint32_t nowMs = millis();
+  processKernelCommandQueue();
 
   uint32_t scanInterval = gScanIntervalMs;
   gScanBudgetUs = scanInterval * 1000;
-  if ((nowMs - lastScanMs) < scanInterval) {
+  if (scanInterval != gScanScheduleIntervalMs) {
+    armScanSchedule(nowUs, scanInterval);
+    gSnapshotMetricsDirty = true;
+  }
+  uint32_t scanLatenessUs = 0;
+  if (!takeV3ScanDeadline(gScanSchedule, nowUs, scanLatenessUs)) {
     updateSharedRuntimeSnapshot(nowMs, false);
     return;
   }
-  lastScanMs += scanInterval;
+  recordLatencySample(gScanJitterHistogram, scanLatenessUs);
+  gSnapshotMetricsDirty = true;
 
   if (gRunMode == RUN_STEP) {
     if (gStepRequested) {
+      sampleV3ScanInputs(gScanEngine);
       processOneScanOrderedCard(nowMs, false);
+      latchV3ScanOutputs(gScanEngine);
       gStepRequested = false;
       updateSharedRuntimeSnapshot(nowMs, true);
       return;
@@ -2189,16 +2278,33 @@ void runEngineIteration(uint32_t nowMs, uint32_t& lastScanMs) {
     return;
   }
 
+  sampleV3ScanInputs(gScanEngine);
+  markV3DueTimerCards(gScanEngine, nowMs);
+  // Nothing changed and no timer expired: the scan would be a fixpoint, so
+  // skip it and leave the snapshot sequence untouched.
+  if (INCREMENTAL_SCAN && gRunMode == RUN_NORMAL && gScanEngine.cursor == 0 &&
+      !anyV3ScanCardDirty(gScanEngine)) {
+    gIdleScansSkipped += 1;
+    gScanCardsEvaluatedLast = 0;
+    gScanCardsSkippedLast = TOTAL_CARDS;
+    updateSharedRuntimeSnapshot(nowMs, false);
+    return;
+  }
+
   uint32_t scanStartUs = micros();
   bool completedFullScan = runFullScanCycle(nowMs, gRunMode == RUN_BREAKPOINT);
+  latchV3ScanOutputs(gScanEngine);
   uint32_t scanEndUs = micros();
   if (completedFullScan) {
     gLastCompleteScanUs = (scanEndUs - scanStartUs);
     if (gLastCompleteScanUs > gMaxCompleteScanUs) {
       gMaxCompleteScanUs = gLastCompleteScanUs;
     }
+    recordLatencySample(gScanDurationHistogram, gLastCompleteScanUs);
     gScanOverrunLast = (gLastCompleteScanUs > gScanBudgetUs);
     if (gScanOverrunLast) gScanOverrunCount += 1;
+    gScanCardsEvaluatedLast = gScanEngine.cardsEvaluated;
+    gScanCardsSkippedLast = gScanEngine.cardsSkipped;
   }
   updateSharedRuntimeSnapshot(nowMs, true);
 }
@@ -2225,6 +2331,7 @@ void serviceRtcMinuteScheduler(uint32_t nowMs) {
   gRtcLastMinuteKey = minuteKey;
   gRtcMinuteTickCount += 1;
   gRtcLastEvalMs = nowMs;
+  gSnapshotMetricsDirty = true;
 
   // Default RTC schedule outputs to false each minute; matching channels
   // re-assert true so downstream conditions can reference RTC cards directly.
@@ -2272,10 +2379,14 @@ void serviceRtcMinuteScheduler(uint32_t nowMs) {
 
 void core0EngineTask(void* param) {
   (void)param;
-  uint32_t lastScanMs = 0;
+  armScanSchedule(micros(), gScanIntervalMs);
   for (;;) {
-    runEngineIteration(millis(), lastScanMs);
-    vTaskDelay(pdMS_TO_TICKS(1));
+    runEngineIteration(micros());
+    // Woken by the scan timer at the deadline or by command/pause requests;
+    // the tick timeout only backstops a missing timer notification.
+    const uint32_t remainingUs =
+        v3ScanScheduleRemainingUs(gScanSchedule, micros());
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(remainingUs / 1000) + 2);
   }
 }
 
@@ -2347,6 +2458,17 @@ void setup() {
 
   updateSharedRuntimeSnapshot(millis(), false);
 
+  resetLatencyHistogram(gScanJitterHistogram);
+  resetLatencyHistogram(gScanDurationHistogram);
+  resetLatencyHistogram(gCommandLatencyHistogram);
+  esp_timer_create_args_t scanTimerArgs = {};
+  scanTimerArgs.callback = &onScanTimerDeadline;
+  scanTimerArgs.name = "scan_deadline";
+  if (esp_timer_create(&scanTimerArgs, &gScanTimer) != ESP_OK) {
+    Serial.println("Failed to create scan deadline timer");
+    gScanTimer = nullptr;
+  }
+
   xTaskCreatePinnedToCore(core0EngineTask, "core0_engine", 8192, nullptr, 3,
                           &gCore0TaskHandle, 0);
   xTaskCreatePinnedToCore(core1PortalTask, "core1_portal", 8192, nullptr, 1,
@@ -2437,5 +2559,10 @@ bool applyCommand(JsonObjectConst command) {
     return enqueueKernelCommand(kernelCommand);
   }
 
+  if (strcmp(name, "reset_timing_stats") == 0) {
+    kernelCommand.type = KernelCmd_ResetTimingStats;
+    return enqueueKernelCommand(kernelCommand);
+  }
+
   return false;
 }
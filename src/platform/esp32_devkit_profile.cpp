@@ -0,0 +1,5 @@
+#include "platform/esp32_devkit_profile.h"
+
+constexpr uint8_t Esp32DevkitV1Board::kDiPins[];
+constexpr uint8_t Esp32DevkitV1Board::kDoPins[];
+constexpr uint8_t Esp32DevkitV1Board::kAiPins[];
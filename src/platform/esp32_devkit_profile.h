@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/v3_hardware_profile.h"
+
+// ESP32 DOIT DevKit V1 (`[env:esp32doit-devkit-v1]`): GPIO channel lists
+// and family capacities of the shipped firmware build.
+struct Esp32DevkitV1Board {
+  static constexpr uint8_t kDiPins[] = {13, 12, 14, 27};
+  static constexpr uint8_t kDoPins[] = {26, 25, 33, 32};
+  static constexpr uint8_t kAiPins[] = {35, 34};
+  static constexpr uint8_t kDiCapacity = sizeof(kDiPins);
+  static constexpr uint8_t kDoCapacity = sizeof(kDoPins);
+  static constexpr uint8_t kAiCapacity = sizeof(kAiPins);
+  static constexpr uint8_t kSioCapacity = 4;
+  static constexpr uint8_t kMathCapacity = 2;
+  static constexpr uint8_t kRtcCapacity = 2;
+};
+
+using FirmwareHardwareProfile = V3HardwareProfile<Esp32DevkitV1Board>;
@@ -0,0 +1,37 @@
+#include "platform/esp32_io_backend.h"
+
+#include <Arduino.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+
+namespace {
+// GPIO0-31 live in the IN/OUT registers, GPIO32-39 in IN1/OUT1.
+uint64_t esp32ReadDigitalInputs(void* context) {
+  (void)context;
+  return static_cast<uint64_t>(REG_READ(GPIO_IN_REG)) |
+         (static_cast<uint64_t>(REG_READ(GPIO_IN1_REG) & 0xFFU) << 32);
+}
+
+uint32_t esp32ReadAnalogInput(void* context, uint8_t pin) {
+  (void)context;
+  return static_cast<uint32_t>(analogRead(pin));
+}
+
+void esp32WriteDigitalOutputs(void* context, uint64_t setMask,
+                              uint64_t clearMask) {
+  (void)context;
+  REG_WRITE(GPIO_OUT_W1TS_REG, static_cast<uint32_t>(setMask));
+  REG_WRITE(GPIO_OUT_W1TC_REG, static_cast<uint32_t>(clearMask));
+  REG_WRITE(GPIO_OUT1_W1TS_REG, static_cast<uint32_t>(setMask >> 32));
+  REG_WRITE(GPIO_OUT1_W1TC_REG, static_cast<uint32_t>(clearMask >> 32));
+}
+}  // namespace
+
+V3IoBackend makeEsp32IoBackend() {
+  V3IoBackend backend = {};
+  backend.context = nullptr;
+  backend.readDigitalInputs = &esp32ReadDigitalInputs;
+  backend.readAnalogInput = &esp32ReadAnalogInput;
+  backend.writeDigitalOutputs = &esp32WriteDigitalOutputs;
+  return backend;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "kernel/v3_io_backend.h"
+
+// Direct GPIO register access (IN/IN1, OUT_W1TS/W1TC, OUT1_W1TS/W1TC) plus
+// the Arduino ADC driver for analog inputs.
+V3IoBackend makeEsp32IoBackend();
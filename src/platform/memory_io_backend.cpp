@@ -0,0 +1,28 @@
+#include "platform/memory_io_backend.h"
+
+namespace {
+uint64_t memoryReadDigitalInputs(void* context) {
+  return static_cast<MemoryIoBackendState*>(context)->inputLevels;
+}
+
+uint32_t memoryReadAnalogInput(void* context, uint8_t pin) {
+  if (pin >= kMemoryIoAnalogPins) return 0;
+  return static_cast<MemoryIoBackendState*>(context)->analogValues[pin];
+}
+
+void memoryWriteDigitalOutputs(void* context, uint64_t setMask,
+                               uint64_t clearMask) {
+  MemoryIoBackendState* state = static_cast<MemoryIoBackendState*>(context);
+  state->outputLevels = (state->outputLevels | setMask) & ~clearMask;
+  state->outputWriteCount += 1;
+}
+}  // namespace
+
+V3IoBackend makeMemoryIoBackend(MemoryIoBackendState& state) {
+  V3IoBackend backend = {};
+  backend.context = &state;
+  backend.readDigitalInputs = &memoryReadDigitalInputs;
+  backend.readAnalogInput = &memoryReadAnalogInput;
+  backend.writeDigitalOutputs = &memoryWriteDigitalOutputs;
+  return backend;
+}
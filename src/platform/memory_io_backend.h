@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "kernel/v3_io_backend.h"
+
+constexpr uint8_t kMemoryIoAnalogPins = 64;
+
+// In-memory pin state for native builds, tests and benchmarks. Tests set
+// `inputLevels` / `analogValues` and observe `outputLevels`.
+struct MemoryIoBackendState {
+  uint64_t inputLevels;
+  uint64_t outputLevels;
+  uint32_t analogValues[kMemoryIoAnalogPins];
+  uint32_t outputWriteCount;
+};
+
+V3IoBackend makeMemoryIoBackend(MemoryIoBackendState& state);
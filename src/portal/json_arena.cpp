@@ -0,0 +1,116 @@
+#include "portal/json_arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+constexpr size_t kBlockHeader = kJsonArenaBlockHeader;
+
+size_t alignedSize(size_t size) {
+  return (size + 7U) & ~static_cast<size_t>(7U);
+}
+
+size_t& blockSize(void* ptr) {
+  return *reinterpret_cast<size_t*>(static_cast<uint8_t*>(ptr) -
+                                    kBlockHeader);
+}
+}  // namespace
+
+JsonArena::JsonArena(uint8_t* buffer, size_t capacity)
+    : buffer_(buffer), capacity_(capacity), top_(0), depth_(0), stats_() {
+  stats_.capacity = static_cast<uint32_t>(capacity);
+}
+
+bool JsonArena::owns(const void* ptr) const {
+  const uint8_t* p = static_cast<const uint8_t*>(ptr);
+  return p >= buffer_ && p < buffer_ + capacity_;
+}
+
+void* JsonArena::allocateFromHeap(size_t size) {
+  uint8_t* block = static_cast<uint8_t*>(malloc(kBlockHeader + size));
+  if (block == nullptr) return nullptr;
+  stats_.heapFallbacks += 1;
+  stats_.heapBytesLive += static_cast<uint32_t>(size);
+  void* ptr = block + kBlockHeader;
+  blockSize(ptr) = size;
+  return ptr;
+}
+
+void* JsonArena::allocate(size_t size) {
+  const size_t need = kBlockHeader + alignedSize(size);
+  if (need > capacity_ - top_) return allocateFromHeap(size);
+  void* ptr = buffer_ + top_ + kBlockHeader;
+  blockSize(ptr) = size;
+  top_ += need;
+  stats_.used = static_cast<uint32_t>(top_);
+  if (stats_.used > stats_.highWater) stats_.highWater = stats_.used;
+  return ptr;
+}
+
+void JsonArena::deallocate(void* ptr) {
+  if (ptr == nullptr) return;
+  if (!owns(ptr)) {
+    stats_.heapBytesLive -= static_cast<uint32_t>(blockSize(ptr));
+    free(static_cast<uint8_t*>(ptr) - kBlockHeader);
+    return;
+  }
+  const size_t start = static_cast<uint8_t*>(ptr) - buffer_ - kBlockHeader;
+  if (start + kBlockHeader + alignedSize(blockSize(ptr)) == top_) {
+    top_ = start;
+    stats_.used = static_cast<uint32_t>(top_);
+  }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize) {
+  if (ptr == nullptr) return allocate(newSize);
+  const size_t oldSize = blockSize(ptr);
+  if (!owns(ptr)) {
+    uint8_t* block = static_cast<uint8_t*>(
+        realloc(static_cast<uint8_t*>(ptr) - kBlockHeader,
+                kBlockHeader + newSize));
+    if (block == nullptr) return nullptr;
+    stats_.heapBytesLive += static_cast<uint32_t>(newSize);
+    stats_.heapBytesLive -= static_cast<uint32_t>(oldSize);
+    void* moved = block + kBlockHeader;
+    blockSize(moved) = newSize;
+    return moved;
+  }
+
+  const size_t start = static_cast<uint8_t*>(ptr) - buffer_ - kBlockHeader;
+  const bool newest = start + kBlockHeader + alignedSize(oldSize) == top_;
+  if (newest && kBlockHeader + alignedSize(newSize) <= capacity_ - start) {
+    blockSize(ptr) = newSize;
+    top_ = start + kBlockHeader + alignedSize(newSize);
+    stats_.used = static_cast<uint32_t>(top_);
+    if (stats_.used > stats_.highWater) stats_.highWater = stats_.used;
+    return ptr;
+  }
+  // An older block keeps its size so it still pops once the blocks above
+  // it are freed; until then the slack is not reusable.
+  if (newSize <= oldSize) return ptr;
+  void* moved = allocate(newSize);
+  if (moved == nullptr) return nullptr;
+  memcpy(moved, ptr, oldSize);
+  deallocate(ptr);
+  return moved;
+}
+
+void JsonArena::enter() { depth_ += 1; }
+
+void JsonArena::leave() {
+  if (depth_ == 0) return;
+  depth_ -= 1;
+  if (depth_ != 0) return;
+  top_ = 0;
+  stats_.used = 0;
+  stats_.requests += 1;
+}
+
+size_t serializeJsonToArena(const JsonDocument& doc, JsonArena& arena,
+                            char*& out) {
+  const size_t size = measureJson(doc);
+  char* buffer = static_cast<char*>(arena.allocate(size + 1));
+  out = buffer;
+  if (buffer == nullptr) return 0;
+  return serializeJson(doc, buffer, size + 1);
+}
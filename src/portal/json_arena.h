@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ArduinoJson.h>
+
+// Portal request memory. `used` returns to zero when the outermost
+// request scope ends; `highWater` is the most any request needed and
+// `heapFallbacks` counts allocations that did not fit and went to the heap.
+struct JsonArenaStats {
+  uint32_t capacity;
+  uint32_t used;
+  uint32_t highWater;
+  uint32_t heapFallbacks;
+  uint32_t heapBytesLive;
+  uint32_t requests;
+};
+
+// Every arena block is preceded by its size; 8 keeps payloads 8-byte
+// aligned.
+constexpr size_t kJsonArenaBlockHeader = 8;
+
+// ArduinoJson 7 allocates variants in pools of ARDUINOJSON_POOL_CAPACITY
+// two-pointer slots: 1 KB on the ESP32, 4 KB on a 64-bit host. An object
+// member takes two slots (key and value); past ARDUINOJSON_INITIAL_POOL_COUNT
+// pools the pool list itself is allocated and doubled.
+constexpr size_t kJsonPoolBytes = ARDUINOJSON_POOL_CAPACITY * 2 * sizeof(void*);
+
+// Arena size for `pools` variant pools plus `extraBytes` for strings, the
+// pool list and the serialized body.
+constexpr size_t jsonArenaBytesFor(size_t pools, size_t extraBytes) {
+  return pools * (kJsonArenaBlockHeader + kJsonPoolBytes) + extraBytes;
+}
+
+// Bump allocator behind the JsonDocuments of one portal request.
+// Only the newest block is freed or resized in place, which covers
+// ArduinoJson's string builders. Freeing or shrinking any older block (a
+// document destroyed before a later one, `shrinkToFit()` on a pool after
+// its strings) reclaims nothing until the outermost `leave()`, so a request
+// needs room for every document it ever holds. Growing an older block
+// copies it to the top. Allocations that do not fit fall back to the heap
+// instead of failing and are counted in `heapFallbacks`.
+class JsonArena : public ArduinoJson::Allocator {
+ public:
+  JsonArena(uint8_t* buffer, size_t capacity);
+
+  void* allocate(size_t size) override;
+  void deallocate(void* ptr) override;
+  void* reallocate(void* ptr, size_t newSize) override;
+
+  // Scopes nest (a WebSocket event may answer through a helper that opens
+  // its own); only the outermost `leave()` resets the arena.
+  void enter();
+  void leave();
+
+  const JsonArenaStats& stats() const { return stats_; }
+
+ private:
+  bool owns(const void* ptr) const;
+  void* allocateFromHeap(size_t size);
+
+  uint8_t* buffer_;
+  size_t capacity_;
+  size_t top_;
+  uint8_t depth_;
+  JsonArenaStats stats_;
+};
+
+// Request scope; declare it before any arena-backed JsonDocument so the
+// documents are destroyed first.
+class JsonArenaScope {
+ public:
+  explicit JsonArenaScope(JsonArena& arena) : arena_(arena) { arena_.enter(); }
+  ~JsonArenaScope() { arena_.leave(); }
+  JsonArenaScope(const JsonArenaScope&) = delete;
+  JsonArenaScope& operator=(const JsonArenaScope&) = delete;
+
+ private:
+  JsonArena& arena_;
+};
+
+// Serializes `doc` as JSON text into arena memory (NUL-terminated), so
+// response bodies need no `String`. Returns the length, or 0 with `out`
+// null when no memory was available. Release `out` with
+// `arena.deallocate()` once sent: a body that spilled to the heap is not
+// reclaimed by the request scope.
+size_t serializeJsonToArena(const JsonDocument& doc, JsonArena& arena,
+                            char*& out);
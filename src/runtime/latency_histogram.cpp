@@ -0,0 +1,64 @@
+#include "runtime/latency_histogram.h"
+
+namespace {
+constexpr uint8_t kExactBuckets = 16;
+constexpr uint8_t kSubBucketBits = 3;
+constexpr uint8_t kSubBuckets = 1U << kSubBucketBits;
+constexpr uint32_t kMaxTrackedUs = (1UL << 24) - 1;
+
+uint8_t highestBit(uint32_t value) {
+  return static_cast<uint8_t>(31 - __builtin_clz(value));
+}
+}  // namespace
+
+void resetLatencyHistogram(LatencyHistogram& histogram) {
+  for (uint8_t i = 0; i < kLatencyHistogramBuckets; ++i) histogram.counts[i] = 0;
+  histogram.total = 0;
+  histogram.maxUs = 0;
+}
+
+uint8_t latencyHistogramBucketFor(uint32_t valueUs) {
+  if (valueUs < kExactBuckets) return static_cast<uint8_t>(valueUs);
+  if (valueUs > kMaxTrackedUs) valueUs = kMaxTrackedUs;
+  const uint8_t exponent = highestBit(valueUs);
+  const uint8_t mantissa = static_cast<uint8_t>(
+      (valueUs >> (exponent - kSubBucketBits)) & (kSubBuckets - 1));
+  return static_cast<uint8_t>(kExactBuckets + (exponent - 4) * kSubBuckets +
+                              mantissa);
+}
+
+uint32_t latencyHistogramBucketUpperUs(uint8_t bucket) {
+  if (bucket < kExactBuckets) return bucket;
+  if (bucket >= kLatencyHistogramBuckets) bucket = kLatencyHistogramBuckets - 1;
+  const uint8_t exponent =
+      static_cast<uint8_t>((bucket - kExactBuckets) / kSubBuckets + 4);
+  const uint32_t mantissa = (bucket - kExactBuckets) % kSubBuckets;
+  const uint8_t shift = static_cast<uint8_t>(exponent - kSubBucketBits);
+  const uint32_t lower = (kSubBuckets + mantissa) << shift;
+  return lower + (1UL << shift) - 1;
+}
+
+void recordLatencySample(LatencyHistogram& histogram, uint32_t valueUs) {
+  histogram.counts[latencyHistogramBucketFor(valueUs)] += 1;
+  histogram.total += 1;
+  if (valueUs > histogram.maxUs) histogram.maxUs = valueUs;
+}
+
+uint32_t latencyHistogramQuantileUs(const LatencyHistogram& histogram,
+                                    uint16_t quantileX10000) {
+  if (histogram.total == 0) return 0;
+  if (quantileX10000 > 10000) quantileX10000 = 10000;
+  uint64_t rank =
+      (static_cast<uint64_t>(histogram.total) * quantileX10000 + 9999) / 10000;
+  if (rank == 0) rank = 1;
+
+  uint64_t seen = 0;
+  for (uint8_t i = 0; i < kLatencyHistogramBuckets; ++i) {
+    seen += histogram.counts[i];
+    if (seen >= rank) {
+      const uint32_t upper = latencyHistogramBucketUpperUs(i);
+      return (upper < histogram.maxUs) ? upper : histogram.maxUs;
+    }
+  }
+  return histogram.maxUs;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+// Log-linear histogram for microsecond latencies: exact below 16 us, then
+// 8 sub-buckets per power of two (<= 12.5% bucket width) up to 2^24 us.
+// Larger samples land in the last bucket; `maxUs` keeps the exact maximum.
+constexpr uint8_t kLatencyHistogramBuckets = 176;
+
+struct LatencyHistogram {
+  uint32_t counts[kLatencyHistogramBuckets];
+  uint32_t total;
+  uint32_t maxUs;
+};
+
+void resetLatencyHistogram(LatencyHistogram& histogram);
+void recordLatencySample(LatencyHistogram& histogram, uint32_t valueUs);
+uint8_t latencyHistogramBucketFor(uint32_t valueUs);
+uint32_t latencyHistogramBucketUpperUs(uint8_t bucket);
+// `quantileX10000` is the quantile in basis points (5000 = p50, 9990 = p99.9).
+// Returns the upper bound of the bucket holding that rank, capped at `maxUs`.
+uint32_t latencyHistogramQuantileUs(const LatencyHistogram& histogram,
+                                    uint16_t quantileX10000);
@@ -4,6 +4,7 @@
 
 #include "kernel/card_model.h"
 #include "kernel/v3_card_types.h"
+#include "kernel/v3_card_layout.h"
 
 struct RuntimeCardMeta {
   uint8_t id;
@@ -12,6 +13,7 @@ struct RuntimeCardMeta {
   cardMode mode;
 };
 
-void refreshRuntimeCardMetaFromTypedCards(
-    const V3CardConfig* cards, uint8_t count, uint8_t doStart, uint8_t aiStart,
-    uint8_t sioStart, uint8_t mathStart, uint8_t rtcStart, RuntimeCardMeta* out);
+void refreshRuntimeCardMetaFromTypedCards(const V3CardConfig* cards,
+                                          uint8_t count,
+                                          const V3CardLayout& layout,
+                                          RuntimeCardMeta* out);
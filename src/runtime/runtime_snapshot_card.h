@@ -4,16 +4,13 @@
 
 #include "kernel/card_model.h"
 
+// Per-card fields not held in the signal store; flags, state and value are
+// published through `SharedRuntimeSnapshotT::signals`.
 struct RuntimeSnapshotCard {
   uint8_t id;
   logicCardType type;
   uint8_t index;
-  bool logicalState;
-  bool physicalState;
-  bool triggerFlag;
-  cardState state;
   cardMode mode;
-  uint32_t currentValue;
   uint32_t startOnMs;
   uint32_t startOffMs;
   uint32_t repeatCounter;
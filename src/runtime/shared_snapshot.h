@@ -4,6 +4,9 @@
 #include <stdint.h>
 
 #include "control/command_dto.h"
+#include "kernel/v3_card_profile.h"
+#include "kernel/v3_runtime_signals.h"
+#include "runtime/latency_histogram.h"
 #include "runtime/runtime_snapshot_card.h"
 
 template <size_t N>
@@ -15,6 +18,15 @@ struct SharedRuntimeSnapshotT {
   uint32_t scanBudgetUs;
   uint32_t scanOverrunCount;
   bool scanOverrunLast;
+  uint16_t scanCardsEvaluatedLast;
+  uint16_t scanCardsSkippedLast;
+  uint32_t idleScansSkipped;
+  uint32_t snapshotRebuildsAvoided;
+  uint32_t scanJitterP50Us;
+  uint32_t scanJitterP99Us;
+  uint32_t scanJitterMaxUs;
+  LatencyHistogram scanDurationHistogram;
+  LatencyHistogram commandLatencyHistogram;
   uint16_t kernelQueueDepth;
   uint16_t kernelQueueHighWaterMark;
   uint16_t kernelQueueCapacity;
@@ -30,12 +42,12 @@ struct SharedRuntimeSnapshotT {
   bool breakpointPaused;
   uint16_t scanCursor;
   RuntimeSnapshotCard cards[N];
+  V3SignalStorage<N> signals;
   inputSourceMode inputSource[N];
   uint32_t forcedAIValue[N];
   bool outputMaskLocal[N];
   bool breakpointEnabled[N];
-  bool setResult[N];
-  bool resetResult[N];
-  bool resetOverride[N];
-  uint32_t evalCounter[N];
+#if CARD_PROFILING
+  V3CardCost cardCost[N];
+#endif
 };
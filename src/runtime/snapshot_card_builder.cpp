@@ -12,11 +12,6 @@ RuntimeSnapshotCard buildRuntimeSnapshotCard(const RuntimeCardMeta& meta,
     case DigitalInput: {
       const V3DiRuntimeState* runtime = runtimeDiStateAt(meta.index, store);
       if (runtime != nullptr) {
-        out.logicalState = runtime->logicalState;
-        out.physicalState = runtime->physicalState;
-        out.triggerFlag = runtime->triggerFlag;
-        out.state = runtime->state;
-        out.currentValue = runtime->currentValue;
         out.startOnMs = runtime->startOnMs;
         out.startOffMs = runtime->startOffMs;
         out.repeatCounter = runtime->repeatCounter;
@@ -26,11 +21,6 @@ RuntimeSnapshotCard buildRuntimeSnapshotCard(const RuntimeCardMeta& meta,
     case DigitalOutput: {
       const V3DoRuntimeState* runtime = runtimeDoStateAt(meta.index, store);
       if (runtime != nullptr) {
-        out.logicalState = runtime->logicalState;
-        out.physicalState = runtime->physicalState;
-        out.triggerFlag = runtime->triggerFlag;
-        out.state = runtime->state;
-        out.currentValue = runtime->currentValue;
         out.startOnMs = runtime->startOnMs;
         out.startOffMs = runtime->startOffMs;
         out.repeatCounter = runtime->repeatCounter;
@@ -39,47 +29,22 @@ RuntimeSnapshotCard buildRuntimeSnapshotCard(const RuntimeCardMeta& meta,
     }
     case AnalogInput: {
       const V3AiRuntimeState* runtime = runtimeAiStateAt(meta.index, store);
-      if (runtime != nullptr) {
-        out.state = runtime->state;
-        out.mode = runtime->mode;
-        out.currentValue = runtime->currentValue;
-      }
+      if (runtime != nullptr) out.mode = runtime->mode;
       break;
     }
     case SoftIO: {
       const V3SioRuntimeState* runtime = runtimeSioStateAt(meta.index, store);
       if (runtime != nullptr) {
-        out.logicalState = runtime->logicalState;
-        out.physicalState = runtime->physicalState;
-        out.triggerFlag = runtime->triggerFlag;
-        out.state = runtime->state;
-        out.currentValue = runtime->currentValue;
         out.startOnMs = runtime->startOnMs;
         out.startOffMs = runtime->startOffMs;
         out.repeatCounter = runtime->repeatCounter;
       }
       break;
     }
-    case MathCard: {
-      const V3MathRuntimeState* runtime = runtimeMathStateAt(meta.index, store);
-      if (runtime != nullptr) {
-        out.logicalState = runtime->logicalState;
-        out.physicalState = runtime->physicalState;
-        out.triggerFlag = runtime->triggerFlag;
-        out.state = runtime->state;
-        out.currentValue = runtime->currentValue;
-      }
-      break;
-    }
     case RtcCard: {
       const V3RtcRuntimeState* runtime = runtimeRtcStateAt(meta.index, store);
       if (runtime != nullptr) {
-        out.logicalState = runtime->logicalState;
-        out.physicalState = runtime->physicalState;
-        out.triggerFlag = runtime->triggerFlag;
-        out.state = runtime->state;
         out.mode = runtime->mode;
-        out.currentValue = runtime->currentValue;
         out.startOnMs = runtime->triggerStartMs;
       }
       break;
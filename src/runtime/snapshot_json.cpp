@@ -0,0 +1,35 @@
+#include "runtime/snapshot_json.h"
+
+void serializeLatencyHistogram(JsonObject out,
+                               const LatencyHistogram& histogram) {
+  out["count"] = histogram.total;
+  out["p50Us"] = latencyHistogramQuantileUs(histogram, 5000);
+  out["p90Us"] = latencyHistogramQuantileUs(histogram, 9000);
+  out["p99Us"] = latencyHistogramQuantileUs(histogram, 9900);
+  out["p999Us"] = latencyHistogramQuantileUs(histogram, 9990);
+  out["maxUs"] = histogram.maxUs;
+  JsonArray buckets = out["buckets"].to<JsonArray>();
+  for (uint8_t i = 0; i < kLatencyHistogramBuckets; ++i) {
+    if (histogram.counts[i] == 0) continue;
+    JsonArray bucket = buckets.add<JsonArray>();
+    bucket.add(latencyHistogramBucketUpperUs(i));
+    bucket.add(histogram.counts[i]);
+  }
+}
+
+void serializeSnapshotStreamMetrics(JsonObject metrics,
+                                    const SnapshotStreamMetrics& stream) {
+  metrics["wsEvictions"] = stream.evictions;
+  JsonArray clients = metrics["wsClients"].to<JsonArray>();
+  for (uint8_t i = 0; i < kStreamClientsMax; ++i) {
+    if (!stream.connected[i]) continue;
+    const StreamClientLag& lag = stream.clients[i];
+    JsonObject client = clients.add<JsonObject>();
+    client["client"] = i;
+    client["lagging"] = lag.lagging;
+    client["lastSendUs"] = lag.lastSendUs;
+    client["maxSendUs"] = lag.maxSendUs;
+    client["framesDropped"] = lag.framesDropped;
+    client["sendFailures"] = lag.sendFailures;
+  }
+}
@@ -1,12 +1,325 @@
 #pragma once
 
 #include <ArduinoJson.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#include "kernel/enum_codec.h"
+#include "runtime/latency_histogram.h"
+#include "runtime/shared_snapshot.h"
+#include "runtime/stream_backpressure.h"
+
+// Wire encoding, negotiated per HTTP request and per WebSocket client.
+// MessagePack documents carry enum fields as their integer values
+// (declaration order) instead of `toString(...)` names.
+enum SnapshotEncoding : uint8_t {
+  SnapshotEncoding_Json,
+  SnapshotEncoding_MsgPack
+};
+
+// Card node field groups; `id` is always written. Subscriptions select
+// groups, full documents write all of them.
+enum SnapshotCardField : uint16_t {
+  CardField_Identity = 1U << 0,  // type, index, familyOrder
+  CardField_Signals = 1U << 1,   // physicalState, logicalState, triggerFlag
+  CardField_State = 1U << 2,     // state, mode
+  CardField_Value = 1U << 3,     // currentValue
+  CardField_Timing = 1U << 4,    // startOnMs, startOffMs, repeatCounter
+  CardField_Control = 1U << 5,   // maskForced, breakpointEnabled
+  CardField_Debug = 1U << 6      // condition results, evalCounter, debug
+};
+constexpr uint16_t kSnapshotCardFieldsAll = 0x7F;
 
 struct SharedRuntimeSnapshot;
 
-void copySharedRuntimeSnapshot(SharedRuntimeSnapshot& outSnapshot);
-void appendRuntimeSnapshotCard(JsonArray& cards,
-                               const SharedRuntimeSnapshot& snapshot,
-                               uint8_t cardId);
-void serializeRuntimeSnapshot(JsonDocument& doc, uint32_t nowMs);
+// False when the kernel kept lapping the read; `outSnapshot` is then unusable.
+bool copySharedRuntimeSnapshot(SharedRuntimeSnapshot& outSnapshot);
+
+// Percentiles plus the non-empty buckets as [upperUs, count] pairs.
+void serializeLatencyHistogram(JsonObject out,
+                               const LatencyHistogram& histogram);
+// `wsEvictions` plus one `wsClients` entry per connected client.
+void serializeSnapshotStreamMetrics(JsonObject metrics,
+                                    const SnapshotStreamMetrics& stream);
+
+template <typename E>
+void setSnapshotEnum(JsonObject node, const char* key, E value,
+                     SnapshotEncoding encoding) {
+  if (encoding == SnapshotEncoding_MsgPack) {
+    node[key] = static_cast<uint8_t>(value);
+  } else {
+    node[key] = toString(value);
+  }
+}
+
+template <size_t N>
+void appendRuntimeSnapshotCard(
+    JsonArray& cards, const SharedRuntimeSnapshotT<N>& snapshot,
+    uint8_t cardId, SnapshotEncoding encoding = SnapshotEncoding_Json,
+    uint16_t fields = kSnapshotCardFieldsAll) {
+  const RuntimeSnapshotCard& card = snapshot.cards[cardId];
+  const V3SignalStorage<N>& signals = snapshot.signals;
+  JsonObject node = cards.add<JsonObject>();
+  node["id"] = card.id;
+  if ((fields & CardField_Identity) != 0) {
+    setSnapshotEnum(node, "type", card.type, encoding);
+    node["index"] = card.index;
+    node["familyOrder"] = cardId;
+  }
+  if ((fields & CardField_Signals) != 0) {
+    node["physicalState"] = v3SignalBit(signals.physical, cardId);
+    node["logicalState"] = v3SignalBit(signals.logical, cardId);
+    node["triggerFlag"] = v3SignalBit(signals.trigger, cardId);
+  }
+  if ((fields & CardField_State) != 0) {
+    setSnapshotEnum(node, "state",
+                    static_cast<cardState>(signals.state[cardId]), encoding);
+    setSnapshotEnum(node, "mode", card.mode, encoding);
+  }
+  if ((fields & CardField_Value) != 0) {
+    node["currentValue"] = signals.currentValue[cardId];
+  }
+  if ((fields & CardField_Timing) != 0) {
+    node["startOnMs"] = card.startOnMs;
+    node["startOffMs"] = card.startOffMs;
+    node["repeatCounter"] = card.repeatCounter;
+  }
+  if ((fields & CardField_Control) != 0) {
+    JsonObject forced = node["maskForced"].to<JsonObject>();
+    setSnapshotEnum(forced, "inputSource", snapshot.inputSource[cardId],
+                    encoding);
+    forced["forcedAIValue"] = snapshot.forcedAIValue[cardId];
+    forced["outputMaskLocal"] = snapshot.outputMaskLocal[cardId];
+    forced["outputMasked"] =
+        (snapshot.globalOutputMask || snapshot.outputMaskLocal[cardId]);
+    node["breakpointEnabled"] = snapshot.breakpointEnabled[cardId];
+  }
+  if ((fields & CardField_Debug) == 0) return;
+  node["setResult"] = v3SignalBit(signals.setResult, cardId);
+  node["resetResult"] = v3SignalBit(signals.resetResult, cardId);
+  node["resetOverride"] = v3SignalBit(signals.resetOverride, cardId);
+  node["evalCounter"] = signals.evalCounter[cardId];
+  JsonObject debug = node["debug"].to<JsonObject>();
+  debug["evalCounter"] = signals.evalCounter[cardId];
+  debug["breakpointEnabled"] = snapshot.breakpointEnabled[cardId];
+#if CARD_PROFILING
+  const V3CardCost& cost = snapshot.cardCost[cardId];
+  JsonObject costNode = debug["cost"].to<JsonObject>();
+  costNode["lastCycles"] = cost.lastTicks;
+  costNode["maxCycles"] = cost.maxTicks;
+  costNode["totalCycles"] = cost.totalTicks;
+  costNode["samples"] = cost.samples;
+#endif
+}
+
+template <size_t N>
+void serializeRuntimeSnapshotMetrics(JsonObject metrics,
+                                     const SharedRuntimeSnapshotT<N>& snapshot) {
+  metrics["scanLastUs"] = snapshot.lastCompleteScanUs;
+  metrics["scanMaxUs"] = snapshot.maxCompleteScanUs;
+  metrics["scanBudgetUs"] = snapshot.scanBudgetUs;
+  metrics["scanOverrunLast"] = snapshot.scanOverrunLast;
+  metrics["scanOverrunCount"] = snapshot.scanOverrunCount;
+  metrics["scanCardsEvaluated"] = snapshot.scanCardsEvaluatedLast;
+  metrics["scanCardsSkipped"] = snapshot.scanCardsSkippedLast;
+  metrics["idleScansSkipped"] = snapshot.idleScansSkipped;
+  metrics["snapshotRebuildsAvoided"] = snapshot.snapshotRebuildsAvoided;
+  metrics["scanJitterP50Us"] = snapshot.scanJitterP50Us;
+  metrics["scanJitterP99Us"] = snapshot.scanJitterP99Us;
+  metrics["scanJitterMaxUs"] = snapshot.scanJitterMaxUs;
+  metrics["queueDepth"] = snapshot.kernelQueueDepth;
+  metrics["queueHighWaterMark"] = snapshot.kernelQueueHighWaterMark;
+  metrics["queueCapacity"] = snapshot.kernelQueueCapacity;
+  metrics["commandLatencyLastUs"] = snapshot.commandLatencyLastUs;
+  metrics["commandLatencyMaxUs"] = snapshot.commandLatencyMaxUs;
+  serializeLatencyHistogram(metrics["scanHistogram"].to<JsonObject>(),
+                            snapshot.scanDurationHistogram);
+  serializeLatencyHistogram(
+      metrics["commandLatencyHistogram"].to<JsonObject>(),
+      snapshot.commandLatencyHistogram);
+  metrics["rtcMinuteTickCount"] = snapshot.rtcMinuteTickCount;
+  metrics["rtcIntentEnqueueCount"] = snapshot.rtcIntentEnqueueCount;
+  metrics["rtcIntentEnqueueFailCount"] = snapshot.rtcIntentEnqueueFailCount;
+  metrics["rtcLastEvalMs"] = snapshot.rtcLastEvalMs;
+}
+
+template <size_t N>
+void serializeRuntimeSnapshotTestMode(
+    JsonObject testMode, const SharedRuntimeSnapshotT<N>& snapshot) {
+  testMode["active"] = snapshot.testModeActive;
+  testMode["outputMaskGlobal"] = snapshot.globalOutputMask;
+  testMode["breakpointPaused"] = snapshot.breakpointPaused;
+  testMode["scanCursor"] = snapshot.scanCursor;
+}
+
+// Full `runtime_snapshot` document for `cardCount` cards in card-id order.
+// Shared by the firmware endpoints and the native benchmarks; `stream`
+// adds the portal's WebSocket counters to `metrics`.
+template <size_t N>
+void serializeRuntimeSnapshotDocument(
+    JsonDocument& doc, const SharedRuntimeSnapshotT<N>& snapshot,
+    uint8_t cardCount, uint32_t nowMs, uint32_t scanIntervalMs,
+    SnapshotEncoding encoding = SnapshotEncoding_Json,
+    const SnapshotStreamMetrics* stream = nullptr) {
+  doc["type"] = "runtime_snapshot";
+  doc["schemaVersion"] = 1;
+  doc["tsMs"] = (snapshot.tsMs == 0) ? nowMs : snapshot.tsMs;
+  doc["scanIntervalMs"] = scanIntervalMs;
+  doc["lastCompleteScanMs"] =
+      static_cast<double>(snapshot.lastCompleteScanUs) / 1000.0;
+  JsonObject metrics = doc["metrics"].to<JsonObject>();
+  serializeRuntimeSnapshotMetrics(metrics, snapshot);
+  if (stream != nullptr) serializeSnapshotStreamMetrics(metrics, *stream);
+  setSnapshotEnum(doc.as<JsonObject>(), "runMode", snapshot.mode, encoding);
+  doc["snapshotSeq"] = snapshot.seq;
+  serializeRuntimeSnapshotTestMode(doc["testMode"].to<JsonObject>(), snapshot);
+
+  JsonArray cards = doc["cards"].to<JsonArray>();
+  for (uint8_t i = 0; i < cardCount && i < N; ++i) {
+    appendRuntimeSnapshotCard(cards, snapshot, i, encoding);
+  }
+}
+
+template <size_t N>
+bool runtimeSnapshotMetricsChanged(const SharedRuntimeSnapshotT<N>& previous,
+                                   const SharedRuntimeSnapshotT<N>& next) {
+  return previous.lastCompleteScanUs != next.lastCompleteScanUs ||
+         previous.maxCompleteScanUs != next.maxCompleteScanUs ||
+         previous.scanBudgetUs != next.scanBudgetUs ||
+         previous.scanOverrunCount != next.scanOverrunCount ||
+         previous.scanOverrunLast != next.scanOverrunLast ||
+         previous.scanCardsEvaluatedLast != next.scanCardsEvaluatedLast ||
+         previous.scanCardsSkippedLast != next.scanCardsSkippedLast ||
+         previous.idleScansSkipped != next.idleScansSkipped ||
+         previous.snapshotRebuildsAvoided != next.snapshotRebuildsAvoided ||
+         previous.scanJitterP50Us != next.scanJitterP50Us ||
+         previous.scanJitterP99Us != next.scanJitterP99Us ||
+         previous.scanJitterMaxUs != next.scanJitterMaxUs ||
+         memcmp(&previous.scanDurationHistogram, &next.scanDurationHistogram,
+                sizeof(LatencyHistogram)) != 0 ||
+         memcmp(&previous.commandLatencyHistogram,
+                &next.commandLatencyHistogram, sizeof(LatencyHistogram)) != 0 ||
+         previous.kernelQueueDepth != next.kernelQueueDepth ||
+         previous.kernelQueueHighWaterMark != next.kernelQueueHighWaterMark ||
+         previous.kernelQueueCapacity != next.kernelQueueCapacity ||
+         previous.commandLatencyLastUs != next.commandLatencyLastUs ||
+         previous.commandLatencyMaxUs != next.commandLatencyMaxUs ||
+         previous.rtcMinuteTickCount != next.rtcMinuteTickCount ||
+         previous.rtcIntentEnqueueCount != next.rtcIntentEnqueueCount ||
+         previous.rtcIntentEnqueueFailCount != next.rtcIntentEnqueueFailCount ||
+         previous.rtcLastEvalMs != next.rtcLastEvalMs;
+}
+
+// Field groups whose `appendRuntimeSnapshotCard(...)` output differs for
+// the card; `outputMasked` follows the global mask.
+template <size_t N>
+uint16_t runtimeSnapshotCardChangedFields(
+    const SharedRuntimeSnapshotT<N>& previous,
+    const SharedRuntimeSnapshotT<N>& next, uint8_t cardId) {
+  const RuntimeSnapshotCard& a = previous.cards[cardId];
+  const RuntimeSnapshotCard& b = next.cards[cardId];
+  const V3SignalStorage<N>& sa = previous.signals;
+  const V3SignalStorage<N>& sb = next.signals;
+  uint16_t changed = 0;
+  if (a.id != b.id || a.type != b.type || a.index != b.index) {
+    changed |= CardField_Identity;
+  }
+  if (v3SignalBit(sa.logical, cardId) != v3SignalBit(sb.logical, cardId) ||
+      v3SignalBit(sa.physical, cardId) != v3SignalBit(sb.physical, cardId) ||
+      v3SignalBit(sa.trigger, cardId) != v3SignalBit(sb.trigger, cardId)) {
+    changed |= CardField_Signals;
+  }
+  if (a.mode != b.mode || sa.state[cardId] != sb.state[cardId]) {
+    changed |= CardField_State;
+  }
+  if (sa.currentValue[cardId] != sb.currentValue[cardId]) {
+    changed |= CardField_Value;
+  }
+  if (a.startOnMs != b.startOnMs || a.startOffMs != b.startOffMs ||
+      a.repeatCounter != b.repeatCounter) {
+    changed |= CardField_Timing;
+  }
+  if (previous.inputSource[cardId] != next.inputSource[cardId] ||
+      previous.forcedAIValue[cardId] != next.forcedAIValue[cardId] ||
+      previous.outputMaskLocal[cardId] != next.outputMaskLocal[cardId] ||
+      previous.breakpointEnabled[cardId] != next.breakpointEnabled[cardId] ||
+      previous.globalOutputMask != next.globalOutputMask) {
+    changed |= CardField_Control;
+  }
+  if (v3SignalBit(sa.setResult, cardId) != v3SignalBit(sb.setResult, cardId) ||
+      v3SignalBit(sa.resetResult, cardId) !=
+          v3SignalBit(sb.resetResult, cardId) ||
+      v3SignalBit(sa.resetOverride, cardId) !=
+          v3SignalBit(sb.resetOverride, cardId) ||
+      sa.evalCounter[cardId] != sb.evalCounter[cardId] ||
+      previous.breakpointEnabled[cardId] != next.breakpointEnabled[cardId]) {
+    changed |= CardField_Debug;
+  }
+#if CARD_PROFILING
+  if (memcmp(&previous.cardCost[cardId], &next.cardCost[cardId],
+             sizeof(V3CardCost)) != 0) {
+    changed |= CardField_Debug;
+  }
+#endif
+  return changed;
+}
+
+template <size_t N>
+bool runtimeSnapshotCardChanged(const SharedRuntimeSnapshotT<N>& previous,
+                                const SharedRuntimeSnapshotT<N>& next,
+                                uint8_t cardId) {
+  return runtimeSnapshotCardChangedFields(previous, next, cardId) != 0;
+}
+
+// True when a top-level field outside `metrics` and `cards` differs.
+template <size_t N>
+bool runtimeSnapshotHeaderChanged(const SharedRuntimeSnapshotT<N>& previous,
+                                  const SharedRuntimeSnapshotT<N>& next) {
+  return previous.mode != next.mode ||
+         previous.testModeActive != next.testModeActive ||
+         previous.globalOutputMask != next.globalOutputMask ||
+         previous.breakpointPaused != next.breakpointPaused ||
+         previous.scanCursor != next.scanCursor;
+}
+
+// `runtime_patch` from `previous` to `next`: header and test-mode fields
+// always, `metrics` only when a metric changed, and full card nodes only
+// for changed cards. `baseSnapshotSeq`/`baseTsMs` name the frame it
+// applies to. A `stream` whose revision moved past `baseStreamRevision`
+// also counts as a metric change. Returns the number of cards included.
+template <size_t N>
+uint8_t serializeRuntimeSnapshotPatch(
+    JsonDocument& doc, const SharedRuntimeSnapshotT<N>& previous,
+    const SharedRuntimeSnapshotT<N>& next, uint8_t cardCount, uint32_t nowMs,
+    uint32_t scanIntervalMs,
+    SnapshotEncoding encoding = SnapshotEncoding_Json,
+    const SnapshotStreamMetrics* stream = nullptr,
+    uint32_t baseStreamRevision = 0) {
+  doc["type"] = "runtime_patch";
+  doc["schemaVersion"] = 1;
+  doc["baseSnapshotSeq"] = previous.seq;
+  doc["baseTsMs"] = previous.tsMs;
+  doc["tsMs"] = (next.tsMs == 0) ? nowMs : next.tsMs;
+  doc["scanIntervalMs"] = scanIntervalMs;
+  doc["lastCompleteScanMs"] =
+      static_cast<double>(next.lastCompleteScanUs) / 1000.0;
+  if (runtimeSnapshotMetricsChanged(previous, next) ||
+      (stream != nullptr && stream->revision != baseStreamRevision)) {
+    JsonObject metrics = doc["metrics"].to<JsonObject>();
+    serializeRuntimeSnapshotMetrics(metrics, next);
+    if (stream != nullptr) serializeSnapshotStreamMetrics(metrics, *stream);
+  }
+  setSnapshotEnum(doc.as<JsonObject>(), "runMode", next.mode, encoding);
+  doc["snapshotSeq"] = next.seq;
+  serializeRuntimeSnapshotTestMode(doc["testMode"].to<JsonObject>(), next);
+
+  JsonArray cards = doc["cards"].to<JsonArray>();
+  uint8_t changed = 0;
+  for (uint8_t i = 0; i < cardCount && i < N; ++i) {
+    if (!runtimeSnapshotCardChanged(previous, next, i)) continue;
+    appendRuntimeSnapshotCard(cards, next, i, encoding);
+    changed += 1;
+  }
+  return changed;
+}
@@ -0,0 +1,55 @@
+#include "runtime/snapshot_payload_cache.h"
+
+#include <new>
+
+bool reserveSnapshotPayload(SnapshotPayload& payload, size_t capacity) {
+  if (capacity <= payload.capacity) return true;
+  uint8_t* grown = new (std::nothrow) uint8_t[capacity];
+  if (grown == nullptr) return false;
+  delete[] payload.data;
+  payload.data = grown;
+  payload.capacity = capacity;
+  return true;
+}
+
+void releaseSnapshotPayload(SnapshotPayload& payload) {
+  delete[] payload.data;
+  payload = {};
+}
+
+bool encodeSnapshotPayload(const JsonDocument& doc, SnapshotEncoding encoding,
+                           SnapshotPayload& payload) {
+  payload.size = 0;
+  if (encoding == SnapshotEncoding_MsgPack) {
+    const size_t size = measureMsgPack(doc);
+    if (!reserveSnapshotPayload(payload, size)) return false;
+    payload.size = serializeMsgPack(doc, payload.data, payload.capacity);
+    return true;
+  }
+  // serializeJson terminates the output when there is room for it.
+  const size_t size = measureJson(doc);
+  if (!reserveSnapshotPayload(payload, size + 1)) return false;
+  payload.size = serializeJson(doc, reinterpret_cast<char*>(payload.data),
+                               payload.capacity);
+  return true;
+}
+
+const SnapshotPayload* findSnapshotPayload(
+    SnapshotPayloadCache& cache, const SnapshotPayloadKey& key,
+    SnapshotEncoding encoding, const SnapshotStreamMetrics* stream) {
+  const uint32_t streamRevision = stream != nullptr ? stream->revision : 0;
+  if (!cache.valid[encoding] || cache.key[encoding].seq != key.seq ||
+      cache.key[encoding].tsMs != key.tsMs ||
+      cache.streamRevision[encoding] != streamRevision) {
+    return nullptr;
+  }
+  cache.hits += 1;
+  return &cache.payload[encoding];
+}
+
+void releaseSnapshotPayloadCache(SnapshotPayloadCache& cache) {
+  for (uint8_t i = 0; i < kSnapshotEncodingCount; ++i) {
+    releaseSnapshotPayload(cache.payload[i]);
+  }
+  cache = {};
+}
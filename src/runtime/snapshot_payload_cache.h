@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "runtime/snapshot_json.h"
+
+// Serialized document bytes in a grow-only heap buffer, so re-encoding a
+// same-sized document reuses the allocation. JSON payloads are not
+// NUL-terminated within `size`.
+struct SnapshotPayload {
+  uint8_t* data;
+  size_t size;
+  size_t capacity;
+};
+
+// Identifies a published snapshot. Metrics-only publishes keep `seq` but
+// advance `tsMs`, so both are needed.
+struct SnapshotPayloadKey {
+  uint32_t seq;
+  uint32_t tsMs;
+};
+
+constexpr uint8_t kSnapshotEncodingCount = 2;
+
+// Last serialized `runtime_snapshot` per encoding, shared by HTTP reads and
+// WebSocket keyframes. Single-owner (the portal task); no locking.
+struct SnapshotPayloadCache {
+  SnapshotPayload payload[kSnapshotEncodingCount];
+  SnapshotPayloadKey key[kSnapshotEncodingCount];
+  uint32_t streamRevision[kSnapshotEncodingCount];
+  bool valid[kSnapshotEncodingCount];
+  uint32_t hits;
+  uint32_t misses;
+};
+
+// Grows the buffer without preserving its bytes; false when it could not.
+bool reserveSnapshotPayload(SnapshotPayload& payload, size_t capacity);
+void releaseSnapshotPayload(SnapshotPayload& payload);
+// Returns false (and leaves `payload.size` at 0) on allocation failure.
+bool encodeSnapshotPayload(const JsonDocument& doc, SnapshotEncoding encoding,
+                           SnapshotPayload& payload);
+
+// Returns the cached payload for `key` (counting a hit), or null. A
+// payload built with stream metrics also needs their revision to match.
+const SnapshotPayload* findSnapshotPayload(
+    SnapshotPayloadCache& cache, const SnapshotPayloadKey& key,
+    SnapshotEncoding encoding, const SnapshotStreamMetrics* stream = nullptr);
+void releaseSnapshotPayloadCache(SnapshotPayloadCache& cache);
+
+template <size_t N>
+SnapshotPayloadKey snapshotPayloadKey(
+    const SharedRuntimeSnapshotT<N>& snapshot) {
+  return {snapshot.seq, snapshot.tsMs};
+}
+
+// Returns the cached document for `snapshot`, serializing it only when the
+// key or encoding slot moved on. Null on allocation failure.
+template <size_t N>
+const SnapshotPayload* cacheRuntimeSnapshotPayload(
+    SnapshotPayloadCache& cache, const SharedRuntimeSnapshotT<N>& snapshot,
+    uint8_t cardCount, uint32_t nowMs, uint32_t scanIntervalMs,
+    SnapshotEncoding encoding, const SnapshotStreamMetrics* stream = nullptr) {
+  const SnapshotPayloadKey key = snapshotPayloadKey(snapshot);
+  const SnapshotPayload* cached =
+      findSnapshotPayload(cache, key, encoding, stream);
+  if (cached != nullptr) return cached;
+  cache.misses += 1;
+  cache.valid[encoding] = false;
+  JsonDocument doc;
+  serializeRuntimeSnapshotDocument(doc, snapshot, cardCount, nowMs,
+                                   scanIntervalMs, encoding, stream);
+  if (!encodeSnapshotPayload(doc, encoding, cache.payload[encoding])) {
+    return nullptr;
+  }
+  cache.key[encoding] = key;
+  cache.streamRevision[encoding] = stream != nullptr ? stream->revision : 0;
+  cache.valid[encoding] = true;
+  return &cache.payload[encoding];
+}
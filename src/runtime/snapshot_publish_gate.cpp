@@ -0,0 +1,17 @@
+#include "runtime/snapshot_publish_gate.h"
+
+SnapshotPublishKind takeSnapshotPublish(SnapshotPublishGate& gate,
+                                        bool runtimeDirty, bool metricsDirty,
+                                        uint32_t nowMs) {
+  if (runtimeDirty) {
+    gate.lastPublishMs = nowMs;
+    return SnapshotPublish_Full;
+  }
+  if (!metricsDirty) return SnapshotPublish_None;
+  if ((nowMs - gate.lastPublishMs) < gate.metricsIntervalMs) {
+    return SnapshotPublish_None;
+  }
+  gate.lastPublishMs = nowMs;
+  gate.rebuildsAvoided += 1;
+  return SnapshotPublish_Metrics;
+}
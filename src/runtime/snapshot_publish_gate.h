@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+// What one kernel wake publishes. Runtime changes (scan, kernel command,
+// config apply) publish at once with rebuilt cards. Metrics alone change
+// on nearly every wake (each deadline records a jitter sample), so they
+// are coalesced to one publish per `metricsIntervalMs`; that publish
+// carries cards forward from the published buffer.
+enum SnapshotPublishKind : uint8_t {
+  SnapshotPublish_None = 0,
+  SnapshotPublish_Metrics,
+  SnapshotPublish_Full
+};
+
+// `rebuildsAvoided` counts metrics-only publishes, i.e. publishes that
+// went out without rebuilding cards. Wakes that publish nothing are not
+// counted.
+struct SnapshotPublishGate {
+  uint32_t metricsIntervalMs;
+  uint32_t lastPublishMs;
+  uint32_t rebuildsAvoided;
+};
+
+// The caller clears its dirty flags unless this returns None; a held-back
+// metrics change stays dirty until the interval allows it out.
+SnapshotPublishKind takeSnapshotPublish(SnapshotPublishGate& gate,
+                                        bool runtimeDirty, bool metricsDirty,
+                                        uint32_t nowMs);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+// Single-writer, multi-reader snapshot publication without locks. The
+// writer fills a back buffer and flips `front`; each buffer has its own
+// sequence (odd while being written), so a reader copying the front buffer
+// only retries when the writer laps it by `Buffers - 1` publishes.
+// T must be trivially copyable.
+template <typename T, uint8_t Buffers = 3>
+struct V3SnapshotSeqlock {
+  static_assert(Buffers >= 2, "seqlock needs a back buffer");
+  T buffers[Buffers];
+  std::atomic<uint32_t> bufferSeq[Buffers];
+  std::atomic<uint8_t> front;
+  uint8_t writing;
+};
+
+// Writer side. Only one writer may be active; the front buffer stays
+// readable (and writer-visible via publishedV3Snapshot) until publish.
+template <typename T, uint8_t Buffers>
+const T& publishedV3Snapshot(const V3SnapshotSeqlock<T, Buffers>& lock) {
+  return lock.buffers[lock.front.load(std::memory_order_relaxed)];
+}
+
+template <typename T, uint8_t Buffers>
+T& beginV3SnapshotWrite(V3SnapshotSeqlock<T, Buffers>& lock) {
+  const uint8_t back = static_cast<uint8_t>(
+      (lock.front.load(std::memory_order_relaxed) + 1U) % Buffers);
+  lock.writing = back;
+  const uint32_t seq = lock.bufferSeq[back].load(std::memory_order_relaxed);
+  lock.bufferSeq[back].store(seq + 1U, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  return lock.buffers[back];
+}
+
+template <typename T, uint8_t Buffers>
+void publishV3SnapshotWrite(V3SnapshotSeqlock<T, Buffers>& lock) {
+  const uint8_t back = lock.writing;
+  const uint32_t seq = lock.bufferSeq[back].load(std::memory_order_relaxed);
+  lock.bufferSeq[back].store(seq + 1U, std::memory_order_release);
+  lock.front.store(back, std::memory_order_release);
+}
+
+// Reader side: begin, copy lock.buffers[index], then validate.
+template <typename T, uint8_t Buffers>
+uint32_t beginV3SnapshotRead(const V3SnapshotSeqlock<T, Buffers>& lock,
+                             uint8_t& index) {
+  index = lock.front.load(std::memory_order_acquire);
+  return lock.bufferSeq[index].load(std::memory_order_acquire);
+}
+
+template <typename T, uint8_t Buffers>
+bool endV3SnapshotRead(const V3SnapshotSeqlock<T, Buffers>& lock,
+                       uint8_t index, uint32_t seq) {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return (seq & 1U) == 0 &&
+         lock.bufferSeq[index].load(std::memory_order_relaxed) == seq;
+}
+
+template <typename T, uint8_t Buffers>
+bool tryReadV3Snapshot(const V3SnapshotSeqlock<T, Buffers>& lock, T& out) {
+  uint8_t index = 0;
+  const uint32_t seq = beginV3SnapshotRead(lock, index);
+  if ((seq & 1U) != 0) return false;
+  out = lock.buffers[index];
+  return endV3SnapshotRead(lock, index, seq);
+}
+
+// A reader only loses when the writer laps it, so retries are rare and
+// bounded: every kV3SnapshotReadSpins failed attempts it calls `yield`
+// (firmware passes a taskYIELD wrapper) so other tasks on its core run, and
+// after kV3SnapshotReadAttempts it gives up. On false the copied bytes are
+// torn and must not be used; the caller falls back to older data.
+using V3SnapshotReadYield = void (*)();
+constexpr uint8_t kV3SnapshotReadSpins = 4;
+constexpr uint8_t kV3SnapshotReadAttempts = 32;
+
+// Runs `copy(const T&)` on the front buffer until it sees a consistent one.
+template <typename T, uint8_t Buffers, typename Copy>
+bool readV3SnapshotWith(const V3SnapshotSeqlock<T, Buffers>& lock, Copy copy,
+                        V3SnapshotReadYield yield = nullptr) {
+  for (uint8_t attempt = 1; attempt <= kV3SnapshotReadAttempts; ++attempt) {
+    uint8_t index = 0;
+    const uint32_t seq = beginV3SnapshotRead(lock, index);
+    if ((seq & 1U) == 0) {
+      copy(lock.buffers[index]);
+      if (endV3SnapshotRead(lock, index, seq)) return true;
+    }
+    if (yield != nullptr && attempt % kV3SnapshotReadSpins == 0) yield();
+  }
+  return false;
+}
+
+template <typename T, uint8_t Buffers>
+bool readV3Snapshot(const V3SnapshotSeqlock<T, Buffers>& lock, T& out,
+                    V3SnapshotReadYield yield = nullptr) {
+  return readV3SnapshotWith(
+      lock, [&out](const T& snapshot) { out = snapshot; }, yield);
+}
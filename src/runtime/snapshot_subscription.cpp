@@ -0,0 +1,140 @@
+#include "runtime/snapshot_subscription.h"
+
+#include <string.h>
+
+#include "kernel/v3_condition_rules.h"
+
+namespace {
+struct FieldToken {
+  const char* name;
+  uint16_t field;
+};
+
+const FieldToken kFieldTokens[] = {
+    {"identity", CardField_Identity}, {"signals", CardField_Signals},
+    {"state", CardField_State},       {"value", CardField_Value},
+    {"timing", CardField_Timing},     {"control", CardField_Control},
+    {"debug", CardField_Debug}};
+
+bool parseFieldToken(const char* token, uint16_t& out) {
+  if (token == nullptr) return false;
+  for (const FieldToken& entry : kFieldTokens) {
+    if (strcmp(token, entry.name) != 0) continue;
+    out = entry.field;
+    return true;
+  }
+  return false;
+}
+
+bool anyBitSet(const uint32_t* words) {
+  for (uint16_t w = 0; w < kSnapshotSubscriptionWords; ++w) {
+    if (words[w] != 0) return true;
+  }
+  return false;
+}
+}  // namespace
+
+bool parseSnapshotSubscription(JsonObjectConst message,
+                               const V3CardLayout& layout,
+                               SnapshotSubscription& out,
+                               const char*& errorField) {
+  out = {};
+  errorField = nullptr;
+  JsonVariantConst cards = message["cards"];
+  JsonVariantConst families = message["families"];
+  if (cards.isNull() && families.isNull()) {
+    for (uint8_t id = 0; id < layout.totalCards; ++id) {
+      setV3SignalBit(out.cards, id, true);
+    }
+  }
+  if (!cards.isNull()) {
+    if (!cards.is<JsonArrayConst>()) return (errorField = "cards"), false;
+    for (JsonVariantConst id : cards.as<JsonArrayConst>()) {
+      if (!id.is<uint8_t>() || id.as<uint8_t>() >= layout.totalCards) {
+        return (errorField = "cards"), false;
+      }
+      setV3SignalBit(out.cards, id.as<uint8_t>(), true);
+    }
+  }
+  if (!families.isNull()) {
+    if (!families.is<JsonArrayConst>()) {
+      return (errorField = "families"), false;
+    }
+    for (JsonVariantConst token : families.as<JsonArrayConst>()) {
+      logicCardType type;
+      if (!parseV3CardTypeToken(token.as<const char*>(), type)) {
+        return (errorField = "families"), false;
+      }
+      for (uint8_t id = 0; id < layout.totalCards; ++id) {
+        if (v3CardTypeForId(layout, id) == type) {
+          setV3SignalBit(out.cards, id, true);
+        }
+      }
+    }
+  }
+
+  JsonVariantConst fields = message["fields"];
+  out.fields = fields.isNull() ? kSnapshotCardFieldsAll : 0;
+  if (!fields.isNull()) {
+    if (!fields.is<JsonArrayConst>()) return (errorField = "fields"), false;
+    for (JsonVariantConst token : fields.as<JsonArrayConst>()) {
+      uint16_t field = 0;
+      if (!parseFieldToken(token.as<const char*>(), field)) {
+        return (errorField = "fields"), false;
+      }
+      out.fields |= field;
+    }
+  }
+
+  out.metrics = message["metrics"] | true;
+  JsonVariantConst rate = message["maxRateHz"];
+  if (!rate.isNull()) {
+    if (!rate.is<float>()) return (errorField = "maxRateHz"), false;
+    const float hz = rate.as<float>();
+    out.minIntervalMs = hz > 0.0f ? static_cast<uint32_t>(1000.0f / hz) : 0;
+  }
+  return true;
+}
+
+void resetSnapshotSubscriber(SnapshotSubscriber& subscriber,
+                             const SnapshotSubscription& subscription) {
+  subscriber = {};
+  subscriber.subscription = subscription;
+}
+
+void accumulateSnapshotSubscriberChanges(SnapshotSubscriber& subscriber,
+                                         const uint16_t* changedFields,
+                                         uint8_t cardCount,
+                                         bool metricsChanged,
+                                         bool headerChanged) {
+  const SnapshotSubscription& subscription = subscriber.subscription;
+  for (uint8_t i = 0; i < cardCount; ++i) {
+    if ((changedFields[i] & subscription.fields) == 0) continue;
+    if (!v3SignalBit(subscription.cards, i)) continue;
+    setV3SignalBit(subscriber.pendingCards, i, true);
+  }
+  if (metricsChanged && subscription.metrics) subscriber.pendingMetrics = true;
+  if (headerChanged) subscriber.pendingHeader = true;
+}
+
+bool snapshotSubscriberDue(const SnapshotSubscriber& subscriber,
+                           uint32_t nowMs) {
+  if (!subscriber.hasBase) return true;
+  if (!subscriber.pendingMetrics && !subscriber.pendingHeader &&
+      !anyBitSet(subscriber.pendingCards)) {
+    return false;
+  }
+  return (nowMs - subscriber.lastSentMs) >=
+         subscriber.subscription.minIntervalMs;
+}
+
+void markSnapshotSubscriberSent(SnapshotSubscriber& subscriber,
+                                const SnapshotPayloadKey& key,
+                                uint32_t nowMs) {
+  memset(subscriber.pendingCards, 0, sizeof(subscriber.pendingCards));
+  subscriber.pendingMetrics = false;
+  subscriber.pendingHeader = false;
+  subscriber.hasBase = true;
+  subscriber.base = key;
+  subscriber.lastSentMs = nowMs;
+}
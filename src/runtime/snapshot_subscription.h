@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <ArduinoJson.h>
+
+#include "kernel/v3_card_layout.h"
+#include "kernel/v3_runtime_signals.h"
+#include "runtime/snapshot_json.h"
+#include "runtime/snapshot_payload_cache.h"
+
+constexpr uint16_t kSnapshotSubscriptionWords = v3SignalWordCount(kV3MaxCards);
+
+// What one WebSocket client asked to receive: a card-id bitset, card
+// field groups (`SnapshotCardField`), whether `metrics` is included, and
+// the minimum spacing between its frames.
+struct SnapshotSubscription {
+  uint32_t cards[kSnapshotSubscriptionWords];
+  uint16_t fields;
+  bool metrics;
+  uint32_t minIntervalMs;
+};
+
+// Delivery state of a subscribed client: subscribed changes accumulated
+// since its last frame, and that frame's key, which the next patch names
+// as its base. No base means the next frame is a keyframe.
+struct SnapshotSubscriber {
+  SnapshotSubscription subscription;
+  uint32_t pendingCards[kSnapshotSubscriptionWords];
+  bool pendingMetrics;
+  bool pendingHeader;
+  bool hasBase;
+  SnapshotPayloadKey base;
+  uint32_t lastSentMs;
+};
+
+// Parses a `subscribe` message. Without `cards` and `families` every card
+// is selected, without `fields` every group; `maxRateHz` <= 0 keeps the
+// server cadence. On failure `errorField` names the rejected member.
+bool parseSnapshotSubscription(JsonObjectConst message,
+                               const V3CardLayout& layout,
+                               SnapshotSubscription& out,
+                               const char*& errorField);
+
+void resetSnapshotSubscriber(SnapshotSubscriber& subscriber,
+                             const SnapshotSubscription& subscription);
+// `changedFields[i]` is `runtimeSnapshotCardChangedFields(...)` for card i
+// between the last two publish ticks.
+void accumulateSnapshotSubscriberChanges(SnapshotSubscriber& subscriber,
+                                         const uint16_t* changedFields,
+                                         uint8_t cardCount,
+                                         bool metricsChanged,
+                                         bool headerChanged);
+// Keyframes are always due; patches once something subscribed changed and
+// `minIntervalMs` has passed since the last frame.
+bool snapshotSubscriberDue(const SnapshotSubscriber& subscriber,
+                           uint32_t nowMs);
+void markSnapshotSubscriberSent(SnapshotSubscriber& subscriber,
+                                const SnapshotPayloadKey& key, uint32_t nowMs);
+
+// Next frame for `subscriber`: a `runtime_snapshot` of every subscribed
+// card when it has no base, otherwise a `runtime_patch` against its base
+// with the pending cards. Cards carry only the subscribed field groups;
+// `stream` joins `metrics` as in the full document.
+// Returns the number of cards included.
+template <size_t N>
+uint8_t serializeSubscribedSnapshotFrame(
+    JsonDocument& doc, const SharedRuntimeSnapshotT<N>& snapshot,
+    uint8_t cardCount, uint32_t nowMs, uint32_t scanIntervalMs,
+    const SnapshotSubscriber& subscriber, SnapshotEncoding encoding,
+    const SnapshotStreamMetrics* stream = nullptr) {
+  const SnapshotSubscription& subscription = subscriber.subscription;
+  const bool keyframe = !subscriber.hasBase;
+  doc["type"] = keyframe ? "runtime_snapshot" : "runtime_patch";
+  doc["schemaVersion"] = 1;
+  if (!keyframe) {
+    doc["baseSnapshotSeq"] = subscriber.base.seq;
+    doc["baseTsMs"] = subscriber.base.tsMs;
+  }
+  doc["tsMs"] = (snapshot.tsMs == 0) ? nowMs : snapshot.tsMs;
+  doc["scanIntervalMs"] = scanIntervalMs;
+  doc["lastCompleteScanMs"] =
+      static_cast<double>(snapshot.lastCompleteScanUs) / 1000.0;
+  if (subscription.metrics && (keyframe || subscriber.pendingMetrics)) {
+    JsonObject metrics = doc["metrics"].to<JsonObject>();
+    serializeRuntimeSnapshotMetrics(metrics, snapshot);
+    if (stream != nullptr) serializeSnapshotStreamMetrics(metrics, *stream);
+  }
+  setSnapshotEnum(doc.as<JsonObject>(), "runMode", snapshot.mode, encoding);
+  doc["snapshotSeq"] = snapshot.seq;
+  serializeRuntimeSnapshotTestMode(doc["testMode"].to<JsonObject>(), snapshot);
+
+  const uint32_t* selected =
+      keyframe ? subscription.cards : subscriber.pendingCards;
+  JsonArray cards = doc["cards"].to<JsonArray>();
+  uint8_t included = 0;
+  for (uint8_t i = 0; i < cardCount && i < N; ++i) {
+    if (!v3SignalBit(selected, i)) continue;
+    appendRuntimeSnapshotCard(cards, snapshot, i, encoding,
+                              subscription.fields);
+    included += 1;
+  }
+  return included;
+}
@@ -0,0 +1,69 @@
+#include "runtime/stream_backpressure.h"
+
+void resetStreamClient(SnapshotStreamMetrics& stream, uint8_t client,
+                       bool connected) {
+  if (client >= kStreamClientsMax) return;
+  stream.clients[client] = {};
+  stream.connected[client] = connected;
+  stream.revision += 1;
+}
+
+bool streamClientBackingOff(const SnapshotStreamMetrics& stream,
+                            uint8_t client, uint32_t nowMs) {
+  if (client >= kStreamClientsMax) return false;
+  const StreamClientLag& lag = stream.clients[client];
+  return lag.lagging &&
+         static_cast<int32_t>(lag.backoffUntilMs - nowMs) > 0;
+}
+
+bool streamClientMaySend(SnapshotStreamMetrics& stream, uint8_t client,
+                         uint32_t nowMs) {
+  if (!streamClientBackingOff(stream, client, nowMs)) return true;
+  stream.clients[client].framesDropped += 1;
+  stream.revision += 1;
+  return false;
+}
+
+void recordStreamSend(SnapshotStreamMetrics& stream, uint8_t client,
+                      const StreamBackpressurePolicy& policy, bool ok,
+                      uint32_t durationUs, uint32_t nowMs) {
+  if (client >= kStreamClientsMax) return;
+  StreamClientLag& lag = stream.clients[client];
+  lag.lastSendUs = durationUs;
+  if (durationUs > lag.maxSendUs) {
+    lag.maxSendUs = durationUs;
+    stream.revision += 1;
+  }
+  if (!ok) {
+    lag.sendFailures += 1;
+    stream.revision += 1;
+  }
+  if (ok && durationUs <= policy.slowSendUs) {
+    if (lag.lagging) {
+      lag.lagging = false;
+      stream.revision += 1;
+    }
+    return;
+  }
+  if (!lag.lagging) {
+    lag.lagging = true;
+    lag.laggingSinceMs = nowMs;
+    stream.revision += 1;
+  }
+  lag.backoffUntilMs = nowMs + policy.backoffMs;
+}
+
+bool streamClientShouldEvict(const SnapshotStreamMetrics& stream,
+                             uint8_t client,
+                             const StreamBackpressurePolicy& policy,
+                             uint32_t nowMs) {
+  if (client >= kStreamClientsMax) return false;
+  const StreamClientLag& lag = stream.clients[client];
+  return stream.connected[client] && lag.lagging &&
+         (nowMs - lag.laggingSinceMs) >= policy.evictAfterMs;
+}
+
+void recordStreamEviction(SnapshotStreamMetrics& stream, uint8_t client) {
+  stream.evictions += 1;
+  resetStreamClient(stream, client, false);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+// Snapshot stream sends are synchronous in the portal task, so a client on
+// a weak link shows up as a slow (or failed) send. Such a client is
+// lagging: it skips frames until `backoffMs` has passed, the next frame it
+// gets carries the newest state, and it is evicted once it has been
+// lagging for `evictAfterMs`.
+struct StreamBackpressurePolicy {
+  uint32_t slowSendUs;
+  uint32_t backoffMs;
+  uint32_t evictAfterMs;
+};
+
+constexpr StreamBackpressurePolicy kStreamBackpressureDefaults = {20000, 500,
+                                                                  10000};
+constexpr uint8_t kStreamClientsMax = 8;
+
+struct StreamClientLag {
+  bool lagging;
+  uint32_t lastSendUs;
+  uint32_t maxSendUs;
+  uint32_t framesDropped;
+  uint32_t sendFailures;
+  uint32_t laggingSinceMs;
+  uint32_t backoffUntilMs;
+};
+
+// Portal-side stream counters, merged into the `metrics` block at
+// serialization time. `revision` changes whenever a reported value other
+// than `lastSendUs` does, so cached documents can be keyed on it.
+struct SnapshotStreamMetrics {
+  uint32_t revision;
+  uint32_t evictions;
+  bool connected[kStreamClientsMax];
+  StreamClientLag clients[kStreamClientsMax];
+};
+
+void resetStreamClient(SnapshotStreamMetrics& stream, uint8_t client,
+                       bool connected);
+bool streamClientBackingOff(const SnapshotStreamMetrics& stream,
+                            uint8_t client, uint32_t nowMs);
+// False (counting a dropped frame) while the client is backing off.
+bool streamClientMaySend(SnapshotStreamMetrics& stream, uint8_t client,
+                         uint32_t nowMs);
+void recordStreamSend(SnapshotStreamMetrics& stream, uint8_t client,
+                      const StreamBackpressurePolicy& policy, bool ok,
+                      uint32_t durationUs, uint32_t nowMs);
+bool streamClientShouldEvict(const SnapshotStreamMetrics& stream,
+                             uint8_t client,
+                             const StreamBackpressurePolicy& policy,
+                             uint32_t nowMs);
+void recordStreamEviction(SnapshotStreamMetrics& stream, uint8_t client);
@@ -0,0 +1,306 @@
+// Host simulator entry point (`pio run -e native_sim`).
+//
+//   program <config.json> [scenario.txt] [--hours N] [--scan-ms N]
+//           [--start YYYY-MM-DD] [--trace]
+//
+// <config.json> is a config commit request body (`apiVersion`,
+// `schemaVersion`, `config.cards[]`) and goes through the same normalizer as
+// `POST /api/config/commit`. Scenario lines are `<timeMs> <event> ...`:
+//   <t> di <pin> <0|1>
+//   <t> ai <pin> <value>
+//   <t> force <cardId> real|high|low|value [value]
+//   <t> mask <cardId> <0|1>
+//   <t> mask_global <0|1>
+// Blank lines and lines starting with `#` are ignored. Events must be in
+// time order.
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "kernel/legacy_card_profile.h"
+#include "sim/sim_controller.h"
+#include "storage/v3_config_service.h"
+
+namespace {
+const char* kSimApiVersion = "2.0";
+const char* kSimSchemaVersion = "2.0.0";
+
+SimController gSim;
+V3ConfigContext gConfigContext;
+
+struct SimOptions {
+  const char* configPath;
+  const char* scenarioPath;
+  uint64_t durationMs;
+  uint32_t scanIntervalMs;
+  int startYear;
+  int startMonth;
+  int startDay;
+  bool trace;
+};
+
+struct SimEvent {
+  uint64_t atMs;
+  char kind[16];
+  uint32_t a;
+  uint32_t b;
+  char mode[8];
+};
+
+bool readFile(const char* path, std::string& out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  out = buffer.str();
+  return true;
+}
+
+bool parseOptions(int argc, char** argv, SimOptions& options) {
+  options = {};
+  options.durationMs = 24ULL * 3600000ULL;
+  options.scanIntervalMs = 500;
+  options.startYear = 2026;
+  options.startMonth = 1;
+  options.startDay = 1;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    if (strcmp(arg, "--hours") == 0 && i + 1 < argc) {
+      options.durationMs =
+          static_cast<uint64_t>(strtod(argv[++i], nullptr) * 3600000.0);
+    } else if (strcmp(arg, "--scan-ms") == 0 && i + 1 < argc) {
+      options.scanIntervalMs = static_cast<uint32_t>(atoi(argv[++i]));
+    } else if (strcmp(arg, "--start") == 0 && i + 1 < argc) {
+      if (sscanf(argv[++i], "%d-%d-%d", &options.startYear,
+                 &options.startMonth, &options.startDay) != 3) {
+        return false;
+      }
+    } else if (strcmp(arg, "--trace") == 0) {
+      options.trace = true;
+    } else if (options.configPath == nullptr) {
+      options.configPath = arg;
+    } else if (options.scenarioPath == nullptr) {
+      options.scenarioPath = arg;
+    } else {
+      return false;
+    }
+  }
+  return options.configPath != nullptr && options.scanIntervalMs > 0;
+}
+
+bool loadConfig(const char* path, const SimLayout& layout) {
+  std::string text;
+  if (!readFile(path, text)) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return false;
+  }
+  JsonDocument doc;
+  if (deserializeJson(doc, text) || !doc.is<JsonObjectConst>()) {
+    fprintf(stderr, "%s: invalid json\n", path);
+    return false;
+  }
+
+  const LegacyCardProfileLayout profileLayout = {
+      layout.cards, layout.pins.diPins, layout.pins.doPins, layout.pins.aiPins};
+  LogicCard baseline[kSimMaxCards] = {};
+  profileInitializeCardArraySafeDefaults(baseline, profileLayout);
+
+  const uint8_t rtcCount =
+      static_cast<uint8_t>(layout.cards.totalCards - layout.cards.rtcStart);
+  String reason;
+  const char* errorCode = "VALIDATION_FAILED";
+  if (!normalizeV3ConfigRequestContext(
+          doc.as<JsonObjectConst>(), layout.cards, kSimApiVersion,
+          kSimSchemaVersion, baseline, layout.cards.totalCards, rtcCount,
+          gConfigContext, reason, errorCode)) {
+    fprintf(stderr, "%s: %s: %s\n", path, errorCode, reason.c_str());
+    return false;
+  }
+
+  V3RtcScheduleView channels[kSimMaxRtcChannels] = {};
+  for (uint8_t i = 0; i < rtcCount; ++i) {
+    const V3RtcScheduleChannel& source = gConfigContext.rtcChannels[i];
+    channels[i] = {source.enabled, source.year,   source.month,
+                   source.day,     source.weekday, source.hour,
+                   source.minute,  source.rtcCardId};
+  }
+  return loadSimConfig(gSim, gConfigContext.typedCards,
+                       layout.cards.totalCards, channels, rtcCount);
+}
+
+bool parseEventLine(const std::string& line, SimEvent& event) {
+  event = {};
+  unsigned long long atMs = 0;
+  const int fields = sscanf(line.c_str(), "%llu %15s", &atMs, event.kind);
+  if (fields != 2) return false;
+  event.atMs = atMs;
+  const char* rest = line.c_str();
+  for (int skip = 0; skip < 2; ++skip) {
+    while (*rest == ' ' || *rest == '\t') ++rest;
+    while (*rest != '\0' && *rest != ' ' && *rest != '\t') ++rest;
+  }
+  if (strcmp(event.kind, "force") == 0) {
+    return sscanf(rest, "%u %7s %u", &event.a, event.mode, &event.b) >= 2;
+  }
+  if (strcmp(event.kind, "mask_global") == 0) {
+    return sscanf(rest, "%u", &event.a) == 1;
+  }
+  return sscanf(rest, "%u %u", &event.a, &event.b) == 2;
+}
+
+bool applyEvent(const SimEvent& event) {
+  if (strcmp(event.kind, "di") == 0) {
+    setSimDigitalInput(gSim, static_cast<uint8_t>(event.a), event.b != 0);
+    return true;
+  }
+  if (strcmp(event.kind, "ai") == 0) {
+    setSimAnalogInput(gSim, static_cast<uint8_t>(event.a), event.b);
+    return true;
+  }
+  KernelCommand command = {};
+  command.cardId = static_cast<uint8_t>(event.a);
+  if (strcmp(event.kind, "force") == 0) {
+    command.type = KernelCmd_SetInputForce;
+    command.value = event.b;
+    if (strcmp(event.mode, "real") == 0) {
+      command.inputMode = InputSource_Real;
+    } else if (strcmp(event.mode, "high") == 0) {
+      command.inputMode = InputSource_ForcedHigh;
+    } else if (strcmp(event.mode, "low") == 0) {
+      command.inputMode = InputSource_ForcedLow;
+    } else if (strcmp(event.mode, "value") == 0) {
+      command.inputMode = InputSource_ForcedValue;
+    } else {
+      return false;
+    }
+  } else if (strcmp(event.kind, "mask") == 0) {
+    command.type = KernelCmd_SetOutputMask;
+    command.flag = event.b != 0;
+  } else if (strcmp(event.kind, "mask_global") == 0) {
+    command.type = KernelCmd_SetOutputMaskGlobal;
+    command.flag = event.a != 0;
+  } else {
+    return false;
+  }
+  enqueueSimCommand(gSim, command);
+  return true;
+}
+
+void traceOutputs(uint64_t atMs, const V3RtcMinuteStamp& stamp,
+                  uint64_t& lastLevels) {
+  const uint64_t levels = gSim.io.outputLevels;
+  if (levels == lastLevels) return;
+  printf("%llu %04d-%02d-%02d %02d:%02d outputs=0x%016llx\n",
+         static_cast<unsigned long long>(atMs), stamp.year, stamp.month,
+         stamp.day, stamp.hour, stamp.minute,
+         static_cast<unsigned long long>(levels));
+  lastLevels = levels;
+}
+
+// With tracing, advance one scan period at a time so every output change is
+// reported at the scan that produced it.
+void advanceTo(uint64_t untilMs, bool trace, uint64_t& lastLevels) {
+  if (!trace) {
+    advanceSimController(gSim, untilMs);
+    return;
+  }
+  while (gSim.nowMs < untilMs) {
+    const uint64_t scanAtMs = gSim.nowMs;
+    const V3RtcMinuteStamp stamp = simRtcStamp(gSim);
+    advanceSimController(gSim, scanAtMs + 1);
+    traceOutputs(scanAtMs, stamp, lastLevels);
+  }
+}
+
+bool runScenario(const SimOptions& options) {
+  uint64_t lastLevels = gSim.io.outputLevels;
+  if (options.scenarioPath != nullptr) {
+    std::string text;
+    if (!readFile(options.scenarioPath, text)) {
+      fprintf(stderr, "cannot read %s\n", options.scenarioPath);
+      return false;
+    }
+    std::istringstream lines(text);
+    std::string line;
+    uint32_t lineNo = 0;
+    while (std::getline(lines, line)) {
+      ++lineNo;
+      const size_t first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos || line[first] == '#') continue;
+      SimEvent event = {};
+      if (!parseEventLine(line, event)) {
+        fprintf(stderr, "%s:%u: bad event\n", options.scenarioPath, lineNo);
+        return false;
+      }
+      if (event.atMs >= options.durationMs) break;
+      advanceTo(event.atMs, options.trace, lastLevels);
+      if (!applyEvent(event)) {
+        fprintf(stderr, "%s:%u: bad event\n", options.scenarioPath, lineNo);
+        return false;
+      }
+    }
+  }
+  advanceTo(options.durationMs, options.trace, lastLevels);
+  return true;
+}
+
+void printSummary(double wallSeconds) {
+  const SimStats& stats = gSim.stats;
+  const double simSeconds = static_cast<double>(gSim.nowMs) / 1000.0;
+  printf("simulatedSeconds=%.3f\n", simSeconds);
+  printf("wallSeconds=%.3f\n", wallSeconds);
+  printf("speedup=%.0f\n", wallSeconds > 0 ? simSeconds / wallSeconds : 0.0);
+  printf("scans=%u\n", stats.scans);
+  printf("idleScansSkipped=%u\n", stats.idleScansSkipped);
+  printf("fastForwardedPeriods=%u\n", stats.fastForwardedPeriods);
+  printf("cardsEvaluated=%llu\n",
+         static_cast<unsigned long long>(stats.cardsEvaluated));
+  printf("cardsSkipped=%llu\n",
+         static_cast<unsigned long long>(stats.cardsSkipped));
+  printf("outputEdges=%u\n", stats.outputEdges);
+  printf("rtcMinuteTicks=%u\n", stats.rtcMinuteTicks);
+  printf("rtcTriggers=%u\n", stats.rtcTriggers);
+  printf("commandsApplied=%u\n", stats.commandsApplied);
+  printf("commandsRejected=%u\n", stats.commandsRejected);
+  printf("commandsDropped=%u\n", stats.commandsDropped);
+  printf("queueHighWaterMark=%u\n", stats.queueHighWaterMark);
+  for (uint8_t i = 0; i < gSim.layout.pins.doCount; ++i) {
+    const V3DoRuntimeState& out = gSim.dOut[i];
+    printf("do%u pin=%u level=%u cycles=%u\n", i, gSim.layout.pins.doPins[i],
+           simOutputLevel(gSim, gSim.layout.pins.doPins[i]) ? 1U : 0U,
+           out.currentValue);
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  SimOptions options = {};
+  if (!parseOptions(argc, argv, options)) {
+    fprintf(stderr,
+            "usage: %s <config.json> [scenario.txt] [--hours N] "
+            "[--scan-ms N] [--start YYYY-MM-DD] [--trace]\n",
+            argv[0]);
+    return 2;
+  }
+  const SimLayout layout = simDefaultLayout();
+  if (!initSimController(gSim, layout, options.scanIntervalMs,
+                         options.startYear, options.startMonth,
+                         options.startDay)) {
+    return 2;
+  }
+  if (!loadConfig(options.configPath, layout)) return 1;
+
+  const auto wallStart = std::chrono::steady_clock::now();
+  if (!runScenario(options)) return 1;
+  const std::chrono::duration<double> wall =
+      std::chrono::steady_clock::now() - wallStart;
+  printSummary(wall.count());
+  return 0;
+}
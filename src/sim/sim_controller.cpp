@@ -0,0 +1,413 @@
+#include "sim/sim_controller.h"
+
+#include <string.h>
+
+#include "kernel/v3_card_bridge.h"
+#include "kernel/v3_incremental_scan.h"
+#include "kernel/v3_runtime_signals.h"
+#include "kernel/v3_timer_index.h"
+#include "platform/esp32_devkit_profile.h"
+
+namespace {
+constexpr uint64_t kSimMinuteMs = 60000;
+
+// days_from_civil / civil_from_days (proleptic Gregorian).
+int32_t daysFromCivil(int year, int month, int day) {
+  year -= month <= 2 ? 1 : 0;
+  const int era = (year >= 0 ? year : year - 399) / 400;
+  const int yoe = year - era * 400;
+  const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(int32_t days, int& year, int& month, int& day) {
+  days += 719468;
+  const int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const int32_t doe = days - era * 146097;
+  const int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int32_t mp = (5 * doy + 2) / 153;
+  day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+  month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+  year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+uint8_t popCount64(uint64_t value) {
+  uint8_t count = 0;
+  while (value != 0) {
+    value &= value - 1;
+    ++count;
+  }
+  return count;
+}
+
+// Mirrors profileInitializeCardSafeDefaults(...) for the runtime-relevant
+// fields; typed config is applied on top by v3CardConfigToLegacy(...).
+void initializeSimCardBaseline(LogicCard& card, uint8_t id,
+                               const SimLayout& layout) {
+  card = {};
+  card.id = id;
+  card.hwPin = 255;
+  card.setA_ID = id;
+  card.setB_ID = id;
+  card.resetA_ID = id;
+  card.resetB_ID = id;
+  card.setA_Operator = Op_AlwaysFalse;
+  card.setB_Operator = Op_AlwaysFalse;
+  card.resetA_Operator = Op_AlwaysFalse;
+  card.resetB_Operator = Op_AlwaysFalse;
+  card.setCombine = Combine_None;
+  card.resetCombine = Combine_None;
+  card.mode = Mode_None;
+  card.state = State_None;
+  const V3CardFamily family = v3CardFamilyForId(layout.cards, id);
+  card.type = v3CardTypeForFamily(family);
+  card.index = v3CardFamilyIndex(layout.cards, id);
+  switch (family) {
+    case V3CardFamily::DI:
+      card.mode = Mode_DI_Rising;
+      card.state = State_DI_Idle;
+      break;
+    case V3CardFamily::DO:
+    case V3CardFamily::SIO:
+      card.mode = Mode_DO_Normal;
+      card.state = State_DO_Idle;
+      break;
+    case V3CardFamily::AI:
+      card.mode = Mode_AI_Continuous;
+      card.state = State_AI_Streaming;
+      break;
+    default:
+      break;
+  }
+}
+
+V3RuntimeStoreView simRuntimeStore(SimController& sim) {
+  const V3CardLayout& layout = sim.layout.cards;
+  V3RuntimeStoreView store = {};
+  store.di = sim.di;
+  store.diCount = layout.doStart;
+  store.dOut = sim.dOut;
+  store.dOutCount = static_cast<uint8_t>(layout.aiStart - layout.doStart);
+  store.ai = sim.ai;
+  store.aiCount = static_cast<uint8_t>(layout.sioStart - layout.aiStart);
+  store.sio = sim.sio;
+  store.sioCount = static_cast<uint8_t>(layout.mathStart - layout.sioStart);
+  store.math = sim.math;
+  store.mathCount = static_cast<uint8_t>(layout.rtcStart - layout.mathStart);
+  store.rtc = sim.rtc;
+  store.rtcCount = static_cast<uint8_t>(layout.totalCards - layout.rtcStart);
+  return store;
+}
+
+bool isSimFamily(const SimController& sim, uint8_t cardId,
+                 logicCardType type) {
+  return cardId < sim.layout.cards.totalCards && sim.meta[cardId].type == type;
+}
+
+bool applySimInputForce(SimController& sim, const KernelCommand& command) {
+  const uint8_t cardId = command.cardId;
+  if (isSimFamily(sim, cardId, DigitalInput)) {
+    if (command.inputMode == InputSource_ForcedValue) return false;
+  } else if (isSimFamily(sim, cardId, AnalogInput)) {
+    if (command.inputMode == InputSource_ForcedHigh ||
+        command.inputMode == InputSource_ForcedLow) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  sim.inputSource[cardId] = command.inputMode;
+  if (command.inputMode == InputSource_ForcedValue) {
+    sim.forcedAIValue[cardId] = command.value;
+  }
+  if (command.inputMode == InputSource_Real) sim.forcedAIValue[cardId] = 0;
+  return true;
+}
+
+bool applySimRtcCardState(SimController& sim, uint8_t cardId, bool state,
+                          uint32_t nowMs) {
+  if (!isSimFamily(sim, cardId, RtcCard)) return false;
+  V3RtcRuntimeState* runtime =
+      runtimeRtcStateAt(v3CardFamilyIndex(sim.layout.cards, cardId),
+                        sim.engine.store);
+  if (runtime == nullptr) return false;
+  applyV3RtcCardState(*runtime, state, nowMs);
+  refreshRuntimeSignalAt(sim.meta, sim.engine.store, sim.engine.signals,
+                         cardId);
+  if (state) sim.stats.rtcTriggers += 1;
+  return true;
+}
+
+// Run mode, stepping and breakpoints are operator tooling and are not
+// modelled; those commands are rejected.
+bool applySimCommand(SimController& sim, const KernelCommand& command,
+                     uint32_t nowMs) {
+  switch (command.type) {
+    case KernelCmd_SetRunMode:
+      return command.mode == RUN_NORMAL;
+    case KernelCmd_SetTestMode:
+      if (!command.flag) {
+        for (uint8_t i = 0; i < sim.layout.cards.totalCards; ++i) {
+          sim.inputSource[i] = InputSource_Real;
+          sim.outputMask[i] = false;
+          sim.forcedAIValue[i] = 0;
+        }
+        sim.globalOutputMask = false;
+      }
+      return true;
+    case KernelCmd_SetInputForce:
+      return applySimInputForce(sim, command);
+    case KernelCmd_SetOutputMask:
+      if (!isSimFamily(sim, command.cardId, DigitalOutput)) return false;
+      sim.outputMask[command.cardId] = command.flag;
+      return true;
+    case KernelCmd_SetOutputMaskGlobal:
+      sim.globalOutputMask = command.flag;
+      return true;
+    case KernelCmd_SetRtcCardState:
+      return applySimRtcCardState(sim, command.cardId, command.flag, nowMs);
+    case KernelCmd_ResetTimingStats:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void processSimCommandQueue(SimController& sim, uint32_t nowMs) {
+  while (sim.queueDepth > 0) {
+    const KernelCommand command = sim.queue[sim.queueHead];
+    sim.queueHead =
+        static_cast<uint8_t>((sim.queueHead + 1) % kSimCommandQueueCapacity);
+    sim.queueDepth -= 1;
+    if (applySimCommand(sim, command, nowMs)) {
+      sim.stats.commandsApplied += 1;
+    } else {
+      sim.stats.commandsRejected += 1;
+    }
+    markAllV3ScanCardsDirty(sim.engine);
+  }
+}
+
+bool anySimRtcChannelEnabled(const SimController& sim) {
+  for (uint8_t i = 0; i < sim.rtcChannelCount; ++i) {
+    if (sim.rtcChannels[i].enabled) return true;
+  }
+  return false;
+}
+
+// Same intents as serviceRtcMinuteScheduler(...) in main.cpp: clear every
+// enabled channel, then re-assert the matching ones.
+void serviceSimRtcScheduler(SimController& sim) {
+  if (!anySimRtcChannelEnabled(sim)) return;
+  const V3RtcMinuteStamp stamp = simRtcStamp(sim);
+  const int32_t minuteKey = v3RtcMinuteKey(stamp);
+  if (minuteKey == sim.rtcLastMinuteKey) return;
+  sim.rtcLastMinuteKey = minuteKey;
+  sim.stats.rtcMinuteTicks += 1;
+
+  for (uint8_t i = 0; i < sim.rtcChannelCount; ++i) {
+    const V3RtcScheduleView& channel = sim.rtcChannels[i];
+    if (!channel.enabled) continue;
+    KernelCommand clearCmd = {};
+    clearCmd.type = KernelCmd_SetRtcCardState;
+    clearCmd.cardId = channel.rtcCardId;
+    clearCmd.flag = false;
+    enqueueSimCommand(sim, clearCmd);
+  }
+  for (uint8_t i = 0; i < sim.rtcChannelCount; ++i) {
+    const V3RtcScheduleView& channel = sim.rtcChannels[i];
+    if (!v3RtcChannelMatchesMinute(channel, stamp)) continue;
+    KernelCommand cmd = {};
+    cmd.type = KernelCmd_SetRtcCardState;
+    cmd.cardId = channel.rtcCardId;
+    cmd.flag = true;
+    enqueueSimCommand(sim, cmd);
+  }
+}
+
+void runSimScanPeriod(SimController& sim) {
+  V3ScanEngine& engine = sim.engine;
+  const uint32_t nowMs = static_cast<uint32_t>(sim.nowMs);
+  serviceSimRtcScheduler(sim);
+  processSimCommandQueue(sim, nowMs);
+
+  sampleV3ScanInputs(engine);
+  markV3DueTimerCards(engine, nowMs);
+  if (engine.cursor == 0 && !anyV3ScanCardDirty(engine)) {
+    sim.stats.idleScansSkipped += 1;
+    return;
+  }
+
+  engine.cardsEvaluated = 0;
+  engine.cardsSkipped = 0;
+  for (uint8_t i = 0; i < engine.count; ++i) {
+    runV3ScanCursorCard(engine, nowMs, false);
+  }
+  const uint64_t before = sim.io.outputLevels;
+  latchV3ScanOutputs(engine);
+  sim.stats.outputEdges += popCount64(before ^ sim.io.outputLevels);
+  sim.stats.scans += 1;
+  sim.stats.cardsEvaluated += engine.cardsEvaluated;
+  sim.stats.cardsSkipped += engine.cardsSkipped;
+}
+
+uint64_t alignUp(uint64_t value, uint64_t step) {
+  return ((value + step - 1) / step) * step;
+}
+
+// Earliest scan period that can do work: the next one while anything is
+// pending, otherwise the period holding the next timer deadline, RTC minute
+// or `untilMs`.
+uint64_t nextSimScanMs(SimController& sim, uint64_t untilMs) {
+  const uint64_t period = sim.scanIntervalMs;
+  const uint64_t next = sim.nowMs + period;
+  if (sim.queueDepth > 0 || anyV3ScanCardDirty(sim.engine)) return next;
+
+  uint64_t wake = untilMs;
+  uint8_t cardId = 0;
+  uint32_t dueMs = 0;
+  if (peekV3NextTimer(sim.engine.timers, cardId, dueMs)) {
+    const int32_t waitMs =
+        static_cast<int32_t>(dueMs - static_cast<uint32_t>(sim.nowMs));
+    const uint64_t dueAt = sim.nowMs + (waitMs > 0 ? waitMs : 0);
+    if (dueAt < wake) wake = dueAt;
+  }
+  if (anySimRtcChannelEnabled(sim)) {
+    const uint64_t minuteAt = (sim.nowMs / kSimMinuteMs + 1) * kSimMinuteMs;
+    if (minuteAt < wake) wake = minuteAt;
+  }
+  wake = alignUp(wake, period);
+  if (wake <= next) return next;
+  const uint64_t skipped = (wake - next) / period;
+  sim.stats.fastForwardedPeriods += static_cast<uint32_t>(skipped);
+  sim.stats.idleScansSkipped += static_cast<uint32_t>(skipped);
+  return wake;
+}
+}  // namespace
+
+SimLayout simDefaultLayout() {
+  SimLayout layout = {};
+  layout.cards = FirmwareHardwareProfile::kLayout;
+  layout.pins = FirmwareHardwareProfile::scanPlanPins();
+  return layout;
+}
+
+bool initSimController(SimController& sim, const SimLayout& layout,
+                       uint32_t scanIntervalMs, int startYear, int startMonth,
+                       int startDay) {
+  if (layout.cards.totalCards == 0 || layout.cards.totalCards > kSimMaxCards) {
+    return false;
+  }
+  if (scanIntervalMs == 0) return false;
+  memset(&sim, 0, sizeof(sim));
+  sim.layout = layout;
+  sim.scanIntervalMs = scanIntervalMs;
+  sim.epochDays = daysFromCivil(startYear, startMonth, startDay);
+  sim.rtcLastMinuteKey = -1;
+
+  V3ScanEngine& engine = sim.engine;
+  engine.count = layout.cards.totalCards;
+  engine.plan = sim.plan;
+  engine.meta = sim.meta;
+  engine.store = simRuntimeStore(sim);
+  engine.signals = makeV3SignalStoreView(sim.signals, layout.cards.totalCards);
+  engine.dependencies = {sim.dependencyOffsets, sim.dependents, 0};
+  engine.timers = {sim.timerHeap, sim.timerPosition, sim.timerDueMs, 0,
+                   layout.cards.totalCards};
+  engine.dirty = sim.dirty;
+  engine.inputSample = sim.inputSample;
+  engine.prevDISample = sim.prevDISample;
+  engine.prevDIPrimed = sim.prevDIPrimed;
+  engine.inputSource = sim.inputSource;
+  engine.forcedAIValue = sim.forcedAIValue;
+  engine.outputMask = sim.outputMask;
+  engine.globalOutputMask = &sim.globalOutputMask;
+  engine.io = makeMemoryIoBackend(sim.io);
+  return true;
+}
+
+bool loadSimConfig(SimController& sim, const V3CardConfig* cards,
+                   uint8_t count, const V3RtcScheduleView* rtcChannels,
+                   uint8_t rtcCount) {
+  const SimLayout& layout = sim.layout;
+  if (cards == nullptr || count != layout.cards.totalCards) return false;
+  if (rtcCount > kSimMaxRtcChannels) return false;
+  for (uint8_t i = 0; i < count; ++i) {
+    initializeSimCardBaseline(sim.legacyCards[i], i, layout);
+    if (!v3CardConfigToLegacy(cards[i], sim.legacyCards[i])) return false;
+    sim.typedCards[i] = cards[i];
+  }
+  for (uint8_t i = 0; i < rtcCount; ++i) sim.rtcChannels[i] = rtcChannels[i];
+  sim.rtcChannelCount = rtcCount;
+  sim.rtcLastMinuteKey = -1;
+
+  V3ScanEngine& engine = sim.engine;
+  syncRuntimeStoreFromTypedCards(sim.legacyCards, sim.typedCards, count,
+                                 engine.store);
+  refreshRuntimeCardMetaFromTypedCards(sim.typedCards, count, layout.cards,
+                                       sim.meta);
+  compileV3ScanPlan(sim.typedCards, sim.meta, count, engine.store,
+                    layout.pins, sim.plan);
+  buildV3DependencyIndex(sim.plan, count, engine.dependencies);
+  clearV3TimerIndex(engine.timers);
+  refreshRuntimeSignalsFromRuntime(sim.meta, engine.store, engine.signals);
+  memset(sim.prevDISample, 0, sizeof(sim.prevDISample));
+  memset(sim.prevDIPrimed, 0, sizeof(sim.prevDIPrimed));
+  engine.cursor = 0;
+  markAllV3ScanCardsDirty(engine);
+  return true;
+}
+
+bool enqueueSimCommand(SimController& sim, const KernelCommand& command) {
+  if (sim.queueDepth >= kSimCommandQueueCapacity) {
+    sim.stats.commandsDropped += 1;
+    return false;
+  }
+  const uint8_t tail = static_cast<uint8_t>((sim.queueHead + sim.queueDepth) %
+                                            kSimCommandQueueCapacity);
+  sim.queue[tail] = command;
+  sim.queueDepth += 1;
+  if (sim.queueDepth > sim.stats.queueHighWaterMark) {
+    sim.stats.queueHighWaterMark = sim.queueDepth;
+  }
+  return true;
+}
+
+void advanceSimController(SimController& sim, uint64_t untilMs) {
+  while (sim.nowMs < untilMs) {
+    runSimScanPeriod(sim);
+    sim.nowMs = nextSimScanMs(sim, untilMs);
+  }
+}
+
+void setSimDigitalInput(SimController& sim, uint8_t pin, bool level) {
+  if (pin >= 64) return;
+  const uint64_t bit = 1ULL << pin;
+  sim.io.inputLevels = level ? (sim.io.inputLevels | bit)
+                             : (sim.io.inputLevels & ~bit);
+}
+
+void setSimAnalogInput(SimController& sim, uint8_t pin, uint32_t value) {
+  if (pin >= kMemoryIoAnalogPins) return;
+  sim.io.analogValues[pin] = value;
+}
+
+bool simOutputLevel(const SimController& sim, uint8_t pin) {
+  if (pin >= 64) return false;
+  return (sim.io.outputLevels & (1ULL << pin)) != 0;
+}
+
+V3RtcMinuteStamp simRtcStamp(const SimController& sim) {
+  const uint64_t minutes = sim.nowMs / kSimMinuteMs;
+  const int32_t days = sim.epochDays + static_cast<int32_t>(minutes / 1440);
+  const uint32_t minuteOfDay = static_cast<uint32_t>(minutes % 1440);
+  V3RtcMinuteStamp stamp = {};
+  civilFromDays(days, stamp.year, stamp.month, stamp.day);
+  // 1970-01-01 was a Thursday; RTClib counts weekdays from Sunday = 0.
+  stamp.weekday = static_cast<int>(((days % 7) + 11) % 7);
+  stamp.hour = static_cast<int>(minuteOfDay / 60);
+  stamp.minute = static_cast<int>(minuteOfDay % 60);
+  return stamp;
+}
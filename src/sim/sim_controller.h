@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "control/command_dto.h"
+#include "kernel/card_model.h"
+#include "kernel/v3_card_layout.h"
+#include "kernel/v3_card_types.h"
+#include "kernel/v3_rtc_runtime.h"
+#include "kernel/v3_runtime_store.h"
+#include "kernel/v3_scan_engine.h"
+#include "platform/memory_io_backend.h"
+
+constexpr uint8_t kSimMaxCards = 255;
+constexpr uint8_t kSimMaxRtcChannels = 16;
+constexpr uint8_t kSimCommandQueueCapacity = 16;
+
+// Family start indices follow the firmware card order (DI, DO, AI, SIO,
+// MATH, RTC); pins are GPIO numbers on the memory backend.
+struct SimLayout {
+  V3CardLayout cards;
+  V3ScanPlanPins pins;
+};
+
+// Firmware hardware profile (`FirmwareHardwareProfile`).
+SimLayout simDefaultLayout();
+
+struct SimStats {
+  uint32_t scans;
+  uint32_t idleScansSkipped;
+  uint32_t fastForwardedPeriods;
+  uint64_t cardsEvaluated;
+  uint64_t cardsSkipped;
+  uint32_t outputEdges;
+  uint32_t rtcMinuteTicks;
+  uint32_t rtcTriggers;
+  uint32_t commandsApplied;
+  uint32_t commandsRejected;
+  uint32_t commandsDropped;
+  uint16_t queueHighWaterMark;
+};
+
+// Whole-controller model for host runs: the kernel scan engine bound to an
+// in-memory IO backend, the kernel command queue, the RTC minute scheduler
+// and a virtual millisecond clock. Large; keep it static and do not copy it
+// after `initSimController(...)` (the engine points into it).
+struct SimController {
+  SimLayout layout;
+  uint32_t scanIntervalMs;
+  uint64_t nowMs;
+  int32_t epochDays;  // civil day at nowMs == 0 (00:00), since 1970-01-01
+  int32_t rtcLastMinuteKey;
+  bool globalOutputMask;
+
+  V3CardConfig typedCards[kSimMaxCards];
+  LogicCard legacyCards[kSimMaxCards];
+  V3DiRuntimeState di[kSimMaxCards];
+  V3DoRuntimeState dOut[kSimMaxCards];
+  V3AiRuntimeState ai[kSimMaxCards];
+  V3SioRuntimeState sio[kSimMaxCards];
+  V3MathRuntimeState math[kSimMaxCards];
+  V3RtcRuntimeState rtc[kSimMaxCards];
+  RuntimeCardMeta meta[kSimMaxCards];
+  V3ScanPlanEntry plan[kSimMaxCards];
+  V3SignalStorage<kSimMaxCards> signals;
+  uint16_t dependencyOffsets[kSimMaxCards + 1];
+  uint8_t dependents[kSimMaxCards * kV3MaxSourcesPerCard];
+  uint8_t timerHeap[kSimMaxCards];
+  uint8_t timerPosition[kSimMaxCards];
+  uint32_t timerDueMs[kSimMaxCards];
+  bool dirty[kSimMaxCards];
+  uint32_t inputSample[kSimMaxCards];
+  bool prevDISample[kSimMaxCards];
+  bool prevDIPrimed[kSimMaxCards];
+  inputSourceMode inputSource[kSimMaxCards];
+  uint32_t forcedAIValue[kSimMaxCards];
+  bool outputMask[kSimMaxCards];
+
+  V3RtcScheduleView rtcChannels[kSimMaxRtcChannels];
+  uint8_t rtcChannelCount;
+
+  KernelCommand queue[kSimCommandQueueCapacity];
+  uint8_t queueHead;
+  uint8_t queueDepth;
+
+  MemoryIoBackendState io;
+  V3ScanEngine engine;
+  SimStats stats;
+};
+
+// Binds the engine and clears all state. The virtual clock starts at
+// `startYear-startMonth-startDay 00:00` local RTC time.
+bool initSimController(SimController& sim, const SimLayout& layout,
+                       uint32_t scanIntervalMs, int startYear, int startMonth,
+                       int startDay);
+// Applies a normalized typed config, as a config commit does on target:
+// runtime state from safe defaults, plan, dependency index and timers rebuilt.
+bool loadSimConfig(SimController& sim, const V3CardConfig* cards,
+                   uint8_t count, const V3RtcScheduleView* rtcChannels,
+                   uint8_t rtcCount);
+
+// Same acceptance rules as the firmware queue; false when full.
+bool enqueueSimCommand(SimController& sim, const KernelCommand& command);
+
+// Runs scan periods until the clock reaches `untilMs`; `nowMs` is then the
+// next pending scan, which samples any input set before the next call.
+// Stretches where no card, timer, command or RTC minute is pending are
+// fast-forwarded on the scan-period grid.
+void advanceSimController(SimController& sim, uint64_t untilMs);
+
+void setSimDigitalInput(SimController& sim, uint8_t pin, bool level);
+void setSimAnalogInput(SimController& sim, uint8_t pin, uint32_t value);
+bool simOutputLevel(const SimController& sim, uint8_t pin);
+V3RtcMinuteStamp simRtcStamp(const SimController& sim);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "kernel/card_model.h"
+#include "storage/v3_config_service.h"
+
+// Scratch memory for one config lifecycle request (staged save/validate,
+// commit, restore, load): the normalized typed config plus a baseline and
+// an output card array, sized for `N` cards. Firmware keeps one static
+// instance so these tens of KB live neither on a task stack nor get
+// zero-filled per request; every member is fully written before use.
+template <size_t N>
+struct V3ConfigWorkspaceT {
+  V3ConfigContextT<N> context;
+  LogicCard baseline[N];
+  LogicCard cards[N];
+  bool busy;
+};
+
+// Exclusive use of a workspace for one request. `get()` is null when
+// another request (or an enclosing call) already holds it.
+template <size_t N>
+class V3ConfigWorkspaceLease {
+ public:
+  explicit V3ConfigWorkspaceLease(V3ConfigWorkspaceT<N>& workspace)
+      : workspace_(workspace.busy ? nullptr : &workspace) {
+    if (workspace_ != nullptr) workspace_->busy = true;
+  }
+  ~V3ConfigWorkspaceLease() {
+    if (workspace_ != nullptr) workspace_->busy = false;
+  }
+  V3ConfigWorkspaceLease(const V3ConfigWorkspaceLease&) = delete;
+  V3ConfigWorkspaceLease& operator=(const V3ConfigWorkspaceLease&) = delete;
+
+  V3ConfigWorkspaceT<N>* get() const { return workspace_; }
+
+ private:
+  V3ConfigWorkspaceT<N>* workspace_;
+};
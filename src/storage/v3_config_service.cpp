@@ -23,9 +23,7 @@ bool normalizeV3ConfigRequestTyped(
   }
 
   std::string typedReason;
-  if (!validateTypedCardConfigs(outTypedCards, static_cast<uint8_t>(layout.totalCards),
-                                layout.doStart, layout.aiStart, layout.sioStart,
-                                layout.mathStart, layout.rtcStart, typedReason)) {
+  if (!validateTypedCardConfigs(outTypedCards, layout, typedReason)) {
     reason = typedReason.c_str();
     outErrorCode = "VALIDATION_FAILED";
     return false;
@@ -33,30 +31,6 @@ bool normalizeV3ConfigRequestTyped(
   return true;
 }
 
-bool normalizeV3ConfigRequestContext(
-    JsonObjectConst root, const V3CardLayout& layout, const char* apiVersion,
-    const char* schemaVersion, const LogicCard* baselineCards,
-    size_t baselineCount, size_t rtcChannelCount, V3ConfigContext& outContext,
-    String& reason, const char*& outErrorCode) {
-  if (layout.totalCards > kV3ConfigContextMaxCards) {
-    reason = "layout totalCards exceeds context capacity";
-    outErrorCode = "INTERNAL_ERROR";
-    return false;
-  }
-  if (rtcChannelCount > kV3ConfigContextMaxRtcChannels) {
-    reason = "rtc channel count exceeds context capacity";
-    outErrorCode = "INTERNAL_ERROR";
-    return false;
-  }
-
-  outContext.typedCount = layout.totalCards;
-  outContext.rtcCount = rtcChannelCount;
-  return normalizeV3ConfigRequestTyped(
-      root, layout, apiVersion, schemaVersion, baselineCards, baselineCount,
-      outContext.typedCards, outContext.typedCount, outContext.rtcChannels,
-      outContext.rtcCount, reason, outErrorCode);
-}
-
 bool buildLegacyCardsFromTypedWithBaseline(const V3CardConfig* typedCards,
                                            size_t typedCount,
                                            const LogicCard* baselineCards,
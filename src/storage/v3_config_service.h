@@ -13,13 +13,19 @@
 constexpr size_t kV3ConfigContextMaxCards = 255;
 constexpr size_t kV3ConfigContextMaxRtcChannels = 16;
 
-struct V3ConfigContext {
-  V3CardConfig typedCards[kV3ConfigContextMaxCards];
+// Normalized typed config of one request. `MaxCards` bounds the layouts
+// it can hold; firmware sizes it from the hardware profile, and
+// `V3ConfigContext` holds the largest supported layout.
+template <size_t MaxCards>
+struct V3ConfigContextT {
+  V3CardConfig typedCards[MaxCards];
   size_t typedCount;
   V3RtcScheduleChannel rtcChannels[kV3ConfigContextMaxRtcChannels];
   size_t rtcCount;
 };
 
+using V3ConfigContext = V3ConfigContextT<kV3ConfigContextMaxCards>;
+
 bool normalizeV3ConfigRequestTyped(
     JsonObjectConst root, const V3CardLayout& layout, const char* apiVersion,
     const char* schemaVersion, const LogicCard* baselineCards,
@@ -27,11 +33,33 @@ bool normalizeV3ConfigRequestTyped(
     V3RtcScheduleChannel* outRtc, size_t outRtcCount, String& reason,
     const char*& outErrorCode);
 
+template <size_t MaxCards>
 bool normalizeV3ConfigRequestContext(
     JsonObjectConst root, const V3CardLayout& layout, const char* apiVersion,
     const char* schemaVersion, const LogicCard* baselineCards,
-    size_t baselineCount, size_t rtcChannelCount, V3ConfigContext& outContext,
-    String& reason, const char*& outErrorCode);
+    size_t baselineCount, size_t rtcChannelCount,
+    V3ConfigContextT<MaxCards>& outContext, String& reason,
+    const char*& outErrorCode) {
+  static_assert(MaxCards <= kV3ConfigContextMaxCards,
+                "config context exceeds the largest supported layout");
+  if (layout.totalCards > MaxCards) {
+    reason = "layout totalCards exceeds context capacity";
+    outErrorCode = "INTERNAL_ERROR";
+    return false;
+  }
+  if (rtcChannelCount > kV3ConfigContextMaxRtcChannels) {
+    reason = "rtc channel count exceeds context capacity";
+    outErrorCode = "INTERNAL_ERROR";
+    return false;
+  }
+
+  outContext.typedCount = layout.totalCards;
+  outContext.rtcCount = rtcChannelCount;
+  return normalizeV3ConfigRequestTyped(
+      root, layout, apiVersion, schemaVersion, baselineCards, baselineCount,
+      outContext.typedCards, outContext.typedCount, outContext.rtcChannels,
+      outContext.rtcCount, reason, outErrorCode);
+}
 
 bool buildLegacyCardsFromTypedWithBaseline(const V3CardConfig* typedCards,
                                            size_t typedCount,
@@ -11,15 +11,6 @@
 #include "kernel/v3_typed_card_parser.h"
 
 namespace {
-logicCardType expectedTypeForCardId(const V3CardLayout& layout, uint8_t id) {
-  if (id < layout.doStart) return DigitalInput;
-  if (id < layout.aiStart) return DigitalOutput;
-  if (id < layout.sioStart) return AnalogInput;
-  if (id < layout.mathStart) return SoftIO;
-  if (id < layout.rtcStart) return MathCard;
-  return RtcCard;
-}
-
 bool hasLegacyCardsShape(JsonArrayConst cards) {
   for (JsonVariantConst v : cards) {
     if (!v.is<JsonObjectConst>()) continue;
@@ -142,9 +133,8 @@ bool normalizeConfigRequestWithLayout(
 
   {
     std::string payloadReason;
-    if (!validateV3PayloadConditionSources(
-            inputCards, layout.totalCards, layout.doStart, layout.aiStart,
-            layout.sioStart, layout.mathStart, layout.rtcStart, payloadReason)) {
+    if (!validateV3PayloadConditionSources(inputCards, layout,
+                                           payloadReason)) {
       reason = payloadReason.c_str();
       outErrorCode = "VALIDATION_FAILED";
       return false;
@@ -157,8 +147,9 @@ bool normalizeConfigRequestWithLayout(
     return false;
   }
 
-  LogicCard mapped[255] = {};
-  V3CardConfig typedCards[255] = {};
+  // Submitted cards are parsed straight into `typedOut`, which the final
+  // pass rewrites in place from the merged legacy card, so no per-card
+  // scratch arrays are needed on the caller's stack.
   bool seen[255] = {};
 
   if (layout.totalCards > 255) {
@@ -174,8 +165,7 @@ bool normalizeConfigRequestWithLayout(
 
   logicCardType sourceTypeById[255] = {};
   for (uint8_t i = 0; i < layout.totalCards; ++i) {
-    mapped[i] = baselineCards[i];
-    sourceTypeById[i] = expectedTypeForCardId(layout, i);
+    sourceTypeById[i] = v3CardTypeForId(layout, i);
   }
 
   for (JsonVariantConst v : inputCards) {
@@ -199,7 +189,7 @@ bool normalizeConfigRequestWithLayout(
       reason = "invalid cardType";
       return false;
     }
-    logicCardType expectedType = expectedTypeForCardId(layout, cardId);
+    logicCardType expectedType = v3CardTypeForId(layout, cardId);
     if (parsedType != expectedType) {
       reason = "cardType does not match cardId family slot";
       return false;
@@ -210,67 +200,56 @@ bool normalizeConfigRequestWithLayout(
   for (JsonVariantConst v : inputCards) {
     JsonObjectConst card = v.as<JsonObjectConst>();
     uint8_t cardId = card["cardId"] | 255;
-    if (!parseV3CardToTyped(card, sourceTypeById, layout.totalCards,
-                            layout.doStart, layout.aiStart, layout.sioStart,
-                            layout.mathStart, layout.rtcStart,
-                            typedCards[cardId], reason)) {
+    if (!parseV3CardToTyped(card, sourceTypeById, layout, typedOut[cardId],
+                            reason)) {
       outErrorCode = "VALIDATION_FAILED";
       return false;
     }
   }
 
-  for (uint8_t id = 0; id < layout.totalCards; ++id) {
-    if (!seen[id]) continue;
-    LogicCard converted = mapped[id];
-    if (!v3CardConfigToLegacy(typedCards[id], converted)) {
-      reason = "failed to convert typed card to runtime card";
-      outErrorCode = "INTERNAL_ERROR";
-      return false;
-    }
-    mapped[id] = converted;
-
-    if (typedCards[id].family == V3CardFamily::RTC) {
-      int slot = static_cast<int>(id) - static_cast<int>(layout.rtcStart);
-      if (slot >= 0 && static_cast<size_t>(slot) < rtcOutCount) {
+  JsonObject outConfig = normalizedDoc["config"].to<JsonObject>();
+  JsonArray out = outConfig["cards"].to<JsonArray>();
+  for (uint8_t i = 0; i < layout.totalCards; ++i) {
+    LogicCard mapped = baselineCards[i];
+    const int slot = static_cast<int>(i) - static_cast<int>(layout.rtcStart);
+    const bool hasRtcSlot =
+        slot >= 0 && static_cast<size_t>(slot) < rtcOutCount;
+    if (seen[i]) {
+      const V3CardConfig& typed = typedOut[i];
+      if (!v3CardConfigToLegacy(typed, mapped)) {
+        reason = "failed to convert typed card to runtime card";
+        outErrorCode = "INTERNAL_ERROR";
+        return false;
+      }
+      if (typed.family == V3CardFamily::RTC && hasRtcSlot) {
+        const V3RtcConfig& rtc = typed.asRtc();
         rtcOut[slot].enabled = true;
-        rtcOut[slot].year = typedCards[id].rtc.hasYear
-                                ? static_cast<int16_t>(typedCards[id].rtc.year)
-                                : static_cast<int16_t>(-1);
-        rtcOut[slot].month = typedCards[id].rtc.hasMonth
-                                 ? static_cast<int8_t>(typedCards[id].rtc.month)
-                                 : static_cast<int8_t>(-1);
-        rtcOut[slot].day = typedCards[id].rtc.hasDay
-                               ? static_cast<int8_t>(typedCards[id].rtc.day)
-                               : static_cast<int8_t>(-1);
-        rtcOut[slot].weekday =
-            typedCards[id].rtc.hasWeekday
-                ? static_cast<int8_t>(typedCards[id].rtc.weekday)
-                : static_cast<int8_t>(-1);
-        rtcOut[slot].hour = static_cast<int8_t>(typedCards[id].rtc.hour);
-        rtcOut[slot].minute = static_cast<int8_t>(typedCards[id].rtc.minute);
-        rtcOut[slot].rtcCardId = id;
+        rtcOut[slot].year = rtc.hasYear ? static_cast<int16_t>(rtc.year)
+                                        : static_cast<int16_t>(-1);
+        rtcOut[slot].month = rtc.hasMonth ? static_cast<int8_t>(rtc.month)
+                                          : static_cast<int8_t>(-1);
+        rtcOut[slot].day = rtc.hasDay ? static_cast<int8_t>(rtc.day)
+                                      : static_cast<int8_t>(-1);
+        rtcOut[slot].weekday = rtc.hasWeekday
+                                   ? static_cast<int8_t>(rtc.weekday)
+                                   : static_cast<int8_t>(-1);
+        rtcOut[slot].hour = static_cast<int8_t>(rtc.hour);
+        rtcOut[slot].minute = static_cast<int8_t>(rtc.minute);
+        rtcOut[slot].rtcCardId = i;
       }
     }
-  }
 
-  JsonObject outConfig = normalizedDoc["config"].to<JsonObject>();
-  JsonArray out = outConfig["cards"].to<JsonArray>();
-  for (uint8_t i = 0; i < layout.totalCards; ++i) {
     JsonObject node = out.add<JsonObject>();
-    serializeLegacyCardToJson(mapped[i], node);
+    serializeLegacyCardToJson(mapped, node);
 
-    const int slot = static_cast<int>(i) - static_cast<int>(layout.rtcStart);
-    const V3RtcScheduleChannel* rtc = nullptr;
-    if (slot >= 0 && static_cast<size_t>(slot) < rtcOutCount) {
-      rtc = &rtcOut[slot];
-    }
+    const V3RtcScheduleChannel* rtc = hasRtcSlot ? &rtcOut[slot] : nullptr;
     const int16_t rtcYear = (rtc != nullptr) ? rtc->year : -1;
     const int8_t rtcMonth = (rtc != nullptr) ? rtc->month : -1;
     const int8_t rtcDay = (rtc != nullptr) ? rtc->day : -1;
     const int8_t rtcWeekday = (rtc != nullptr) ? rtc->weekday : -1;
     const int8_t rtcHour = (rtc != nullptr) ? rtc->hour : -1;
     const int8_t rtcMinute = (rtc != nullptr) ? rtc->minute : -1;
-    if (!legacyToV3CardConfig(mapped[i], rtcYear, rtcMonth, rtcDay, rtcWeekday,
+    if (!legacyToV3CardConfig(mapped, rtcYear, rtcMonth, rtcDay, rtcWeekday,
                               rtcHour, rtcMinute, typedOut[i])) {
       reason = "failed to convert normalized card to typed card";
       outErrorCode = "INTERNAL_ERROR";
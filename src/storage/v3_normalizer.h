@@ -7,17 +7,9 @@
 
 #include "kernel/card_model.h"
 #include "kernel/string_compat.h"
+#include "kernel/v3_card_layout.h"
 #include "kernel/v3_card_types.h"
 
-struct V3CardLayout {
-  uint8_t totalCards;
-  uint8_t doStart;
-  uint8_t aiStart;
-  uint8_t sioStart;
-  uint8_t mathStart;
-  uint8_t rtcStart;
-};
-
 struct V3RtcScheduleChannel {
   bool enabled;
   int16_t year;
@@ -0,0 +1,158 @@
+#include <unity.h>
+
+#include <chrono>
+#include <stdio.h>
+
+#include "../../src/kernel/v3_status_runtime.cpp"
+#include "../../src/kernel/v3_condition_eval.cpp"
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_condition_batch.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint8_t kMaxCards = 255;
+constexpr uint32_t kScanRounds = 20000;
+
+V3RuntimeSignal gSignals[kMaxCards] = {};
+V3SignalStorage<kMaxCards> gSignalStorage = {};
+RuntimeCardMeta gMeta[kMaxCards] = {};
+V3ConditionBlock gBlocks[kMaxCards * 2] = {};
+V3ConditionProgram gPrograms[kMaxCards * 2] = {};
+V3ConditionBatchStorage<kMaxCards * 2> gBatchStorage = {};
+uint32_t gBatchResults[v3SignalWordCount(kMaxCards * 2)] = {};
+
+uint32_t countResultBits(uint16_t programs) {
+  uint32_t total = 0;
+  for (uint16_t w = 0; w < v3SignalWordCount(programs); ++w) {
+    total += static_cast<uint32_t>(__builtin_popcount(gBatchResults[w]));
+  }
+  return total;
+}
+
+uint32_t nextRandom(uint32_t& seed) {
+  seed = seed * 1664525U + 1013904223U;
+  return seed >> 8;
+}
+
+// `booleanPercent` of clauses use Op_AlwaysTrue .. Op_TriggerCleared; the
+// rest draw from the full operator range.
+logicOperator randomOperator(uint32_t& seed, uint8_t booleanPercent) {
+  if (nextRandom(seed) % 100U < booleanPercent) {
+    return static_cast<logicOperator>(nextRandom(seed) %
+                                      (Op_TriggerCleared + 1));
+  }
+  return static_cast<logicOperator>(nextRandom(seed) % (Op_Stopped + 1));
+}
+
+void buildSyntheticConfig(uint8_t cards, uint8_t booleanPercent) {
+  const logicCardType types[] = {DigitalInput, DigitalOutput, AnalogInput,
+                                 SoftIO,       MathCard,      RtcCard};
+  uint32_t seed = 0x5EEDU + cards;
+  for (uint8_t i = 0; i < cards; ++i) {
+    gMeta[i] = {};
+    gMeta[i].id = i;
+    gMeta[i].type = types[nextRandom(seed) % 6];
+    gSignals[i] = {};
+    gSignals[i].type = gMeta[i].type;
+    gSignals[i].state = static_cast<cardState>(nextRandom(seed) % 10);
+    gSignals[i].logicalState = (nextRandom(seed) & 1U) != 0;
+    gSignals[i].physicalState = (nextRandom(seed) & 1U) != 0;
+    gSignals[i].triggerFlag = (nextRandom(seed) & 1U) != 0;
+    gSignals[i].currentValue = nextRandom(seed) % 1000U;
+  }
+  V3SignalStoreView store = makeV3SignalStoreView(gSignalStorage, cards);
+  for (uint8_t i = 0; i < cards; ++i) writeV3Signal(store, i, gSignals[i]);
+  for (uint16_t i = 0; i < static_cast<uint16_t>(cards) * 2U; ++i) {
+    V3ConditionBlock& block = gBlocks[i];
+    block.clauseAId = static_cast<uint8_t>(nextRandom(seed) % cards);
+    block.clauseAOperator = randomOperator(seed, booleanPercent);
+    block.clauseAThreshold = nextRandom(seed) % 1000U;
+    block.clauseBId = static_cast<uint8_t>(nextRandom(seed) % cards);
+    block.clauseBOperator = randomOperator(seed, booleanPercent);
+    block.clauseBThreshold = nextRandom(seed) % 1000U;
+    block.combiner = static_cast<combineMode>(nextRandom(seed) % 3);
+    gPrograms[i] = compileV3ConditionProgram(block, gMeta, cards);
+  }
+}
+
+void runBenchmark(uint8_t cards, uint8_t booleanPercent) {
+  buildSyntheticConfig(cards, booleanPercent);
+  const uint16_t blocks = static_cast<uint16_t>(cards) * 2U;
+
+  uint32_t referenceTrue = 0;
+  const auto referenceStart = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < kScanRounds; ++round) {
+    for (uint16_t i = 0; i < blocks; ++i) {
+      referenceTrue += evalV3ConditionBlock(gBlocks[i], gSignals, cards) ? 1 : 0;
+    }
+    gSignals[round % cards].currentValue += 1;
+  }
+  const auto referenceEnd = std::chrono::steady_clock::now();
+
+  buildSyntheticConfig(cards, booleanPercent);
+  const V3SignalStoreView store = makeV3SignalStoreView(gSignalStorage, cards);
+  uint32_t programTrue = 0;
+  const auto programStart = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < kScanRounds; ++round) {
+    for (uint16_t i = 0; i < blocks; ++i) {
+      programTrue += evalV3ConditionProgram(gPrograms[i], store) ? 1 : 0;
+    }
+    store.currentValue[round % cards] += 1;
+  }
+  const auto programEnd = std::chrono::steady_clock::now();
+
+  buildSyntheticConfig(cards, booleanPercent);
+  V3ConditionBatchView batch =
+      makeV3ConditionBatchView(gBatchStorage, gPrograms, blocks);
+  compileV3ConditionBatch(batch);
+  uint32_t batchTrue = 0;
+  const auto batchStart = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < kScanRounds; ++round) {
+    evalV3ConditionBatch(batch, store, gBatchResults);
+    batchTrue += countResultBits(blocks);
+    store.currentValue[round % cards] += 1;
+  }
+  const auto batchEnd = std::chrono::steady_clock::now();
+
+  TEST_ASSERT_EQUAL_UINT32(referenceTrue, programTrue);
+  TEST_ASSERT_EQUAL_UINT32(referenceTrue, batchTrue);
+
+  const double referenceNs =
+      std::chrono::duration<double, std::nano>(referenceEnd - referenceStart)
+          .count() /
+      kScanRounds;
+  const double programNs =
+      std::chrono::duration<double, std::nano>(programEnd - programStart)
+          .count() /
+      kScanRounds;
+  const double batchNs =
+      std::chrono::duration<double, std::nano>(batchEnd - batchStart)
+          .count() /
+      kScanRounds;
+  printf("condition_eval cards=%u boolean_pct=%u reference_ns_per_scan=%.1f "
+         "program_ns_per_scan=%.1f batch_ns_per_scan=%.1f "
+         "speedup=%.2fx batch_speedup=%.2fx\n",
+         cards, booleanPercent, referenceNs, programNs, batchNs,
+         programNs > 0.0 ? referenceNs / programNs : 0.0,
+         batchNs > 0.0 ? referenceNs / batchNs : 0.0);
+}
+}  // namespace
+
+void test_bench_condition_eval_12_cards() { runBenchmark(12, 0); }
+void test_bench_condition_eval_64_cards() { runBenchmark(64, 0); }
+void test_bench_condition_eval_255_cards() { runBenchmark(255, 0); }
+void test_bench_condition_eval_255_cards_boolean_heavy() {
+  runBenchmark(255, 90);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bench_condition_eval_12_cards);
+  RUN_TEST(test_bench_condition_eval_64_cards);
+  RUN_TEST(test_bench_condition_eval_255_cards);
+  RUN_TEST(test_bench_condition_eval_255_cards_boolean_heavy);
+  return UNITY_END();
+}
@@ -0,0 +1,439 @@
+#include <unity.h>
+
+#include <chrono>
+#include <ctime>
+#include <stdio.h>
+#include <string>
+
+#include "../../src/kernel/enum_codec.cpp"
+#include "../../src/kernel/v3_ai_runtime.cpp"
+#include "../../src/kernel/v3_card_bridge.cpp"
+#include "../../src/kernel/v3_card_profile.cpp"
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_di_runtime.cpp"
+#include "../../src/kernel/v3_do_runtime.cpp"
+#include "../../src/kernel/v3_incremental_scan.cpp"
+#include "../../src/kernel/v3_io_image.cpp"
+#include "../../src/kernel/v3_math_runtime.cpp"
+#include "../../src/kernel/v3_rtc_runtime.cpp"
+#include "../../src/kernel/v3_runtime_adapters.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/kernel/v3_runtime_store.cpp"
+#include "../../src/kernel/v3_scan_engine.cpp"
+#include "../../src/kernel/v3_scan_plan.cpp"
+#include "../../src/kernel/v3_sio_runtime.cpp"
+#include "../../src/kernel/v3_timer_index.cpp"
+#include "../../src/platform/esp32_devkit_profile.cpp"
+#include "../../src/platform/memory_io_backend.cpp"
+#include "../../src/runtime/latency_histogram.cpp"
+#include "../../src/runtime/runtime_card_meta.cpp"
+#include "../../src/runtime/snapshot_card_builder.cpp"
+#include "../../src/runtime/snapshot_json.cpp"
+#include "../../src/sim/sim_controller.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint32_t kScanIntervalMs = 500;
+constexpr uint16_t kQueueCapacity = 16;
+constexpr uint32_t kCardScansPerCase = 200000;
+constexpr uint32_t kJsonCardsPerCase = 4000;
+constexpr uint8_t kFamilyCount = 6;
+
+// Relative weights in firmware card order: DI, DO, AI, SIO, MATH, RTC.
+struct FamilyMix {
+  const char* name;
+  uint8_t weights[kFamilyCount];
+};
+
+const FamilyMix kMixes[] = {
+    {"firmware", {4, 4, 2, 4, 2, 2}},
+    {"io_heavy", {6, 6, 3, 1, 1, 1}},
+    {"logic_heavy", {1, 1, 1, 8, 4, 1}},
+};
+const uint8_t kDensitiesPct[] = {25, 100};
+const uint8_t kDepths[] = {1, 8};
+
+struct ScalingResult {
+  uint32_t scanLastUs;
+  uint32_t scanMaxUs;
+  uint32_t scanOverrunCount;
+  double scanNsPerCard;
+  double conditionEvalsPerSec;
+  double snapshotBuildNs;
+  double jsonSerializeNs;
+  size_t jsonBytes;
+  double patchSerializeNs;
+  size_t patchBytes;
+  double msgpackSerializeNs;
+  size_t msgpackBytes;
+};
+
+SimController gSim;
+SharedRuntimeSnapshotT<kSimMaxCards> gSnapshot;
+SharedRuntimeSnapshotT<kSimMaxCards> gPreviousSnapshot;
+uint8_t gDiPins[kSimMaxCards];
+uint8_t gDoPins[kSimMaxCards];
+uint8_t gAiPins[kSimMaxCards];
+V3CardConfig gCards[kSimMaxCards];
+
+uint32_t nextRandom(uint32_t& seed) {
+  seed = seed * 1664525U + 1013904223U;
+  return seed >> 8;
+}
+
+double elapsedNs(std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Splits `cards` by the mix weights; the rounding remainder goes to SIO,
+// which has no pins. Pins wrap inside the memory backend's 64 GPIOs.
+SimLayout buildLayout(uint8_t cards, const FamilyMix& mix) {
+  uint16_t weightSum = 0;
+  for (uint8_t f = 0; f < kFamilyCount; ++f) weightSum += mix.weights[f];
+  uint8_t counts[kFamilyCount] = {};
+  uint16_t assigned = 0;
+  for (uint8_t f = 0; f < kFamilyCount; ++f) {
+    counts[f] = static_cast<uint8_t>(cards * mix.weights[f] / weightSum);
+    assigned += counts[f];
+  }
+  counts[3] = static_cast<uint8_t>(counts[3] + (cards - assigned));
+
+  for (uint8_t i = 0; i < counts[0]; ++i) gDiPins[i] = i % 64;
+  for (uint8_t i = 0; i < counts[1]; ++i) gDoPins[i] = i % 64;
+  for (uint8_t i = 0; i < counts[2]; ++i) gAiPins[i] = i % 64;
+
+  SimLayout layout = {};
+  V3CardLayout& cardLayout = layout.cards;
+  cardLayout.doStart = counts[0];
+  cardLayout.aiStart = static_cast<uint8_t>(cardLayout.doStart + counts[1]);
+  cardLayout.sioStart = static_cast<uint8_t>(cardLayout.aiStart + counts[2]);
+  cardLayout.mathStart = static_cast<uint8_t>(cardLayout.sioStart + counts[3]);
+  cardLayout.rtcStart = static_cast<uint8_t>(cardLayout.mathStart + counts[4]);
+  cardLayout.totalCards = cards;
+  layout.pins = {gDiPins, counts[0], gDoPins, counts[1], gAiPins, counts[2]};
+  return layout;
+}
+
+V3CardFamily familyAt(const SimLayout& layout, uint8_t id) {
+  return v3CardFamilyForId(layout.cards, id);
+}
+
+bool hasConditions(V3CardFamily family) {
+  return family == V3CardFamily::DI || family == V3CardFamily::DO ||
+         family == V3CardFamily::SIO || family == V3CardFamily::MATH;
+}
+
+V3ConditionBlock constantBlock(uint8_t id, logicOperator op) {
+  V3ConditionBlock block = {};
+  block.clauseAId = id;
+  block.clauseAOperator = op;
+  block.clauseBId = id;
+  block.clauseBOperator = Op_AlwaysFalse;
+  block.combiner = Combine_None;
+  return block;
+}
+
+// Clause that reads `source` with an operator its family supports.
+void sourceClause(const SimLayout& layout, uint8_t source, uint32_t& seed,
+                  uint8_t& id, logicOperator& op, uint32_t& threshold) {
+  id = source;
+  const V3CardFamily family = familyAt(layout, source);
+  if (family == V3CardFamily::AI || family == V3CardFamily::MATH) {
+    op = (nextRandom(seed) & 1U) ? Op_GT : Op_LTE;
+    threshold = nextRandom(seed) % 4096U;
+    return;
+  }
+  const logicOperator ops[] = {Op_LogicalTrue, Op_PhysicalOn, Op_Triggered,
+                               Op_LogicalFalse};
+  op = ops[nextRandom(seed) % 4];
+  threshold = 0;
+}
+
+// `densityPct` of condition blocks read other cards; the rest are constant.
+// Reading blocks form chains of `depth` cards, each link reading the
+// previous condition card, so a change ripples `depth` cards per scan.
+V3ConditionBlock syntheticBlock(const SimLayout& layout, uint8_t ownerId,
+                                uint8_t chainPrev, bool chainHead,
+                                uint8_t densityPct, uint32_t& seed) {
+  if (nextRandom(seed) % 100U >= densityPct) {
+    return constantBlock(ownerId, Op_AlwaysFalse);
+  }
+  const uint8_t total = layout.cards.totalCards;
+  const uint8_t sourceA =
+      chainHead ? static_cast<uint8_t>(nextRandom(seed) % total) : chainPrev;
+  const uint8_t sourceB = static_cast<uint8_t>(nextRandom(seed) % total);
+  V3ConditionBlock block = {};
+  sourceClause(layout, sourceA, seed, block.clauseAId, block.clauseAOperator,
+               block.clauseAThreshold);
+  sourceClause(layout, sourceB, seed, block.clauseBId, block.clauseBOperator,
+               block.clauseBThreshold);
+  block.combiner = (nextRandom(seed) & 1U) ? Combine_AND : Combine_OR;
+  return block;
+}
+
+// Returns the number of condition blocks one full scan evaluates.
+uint32_t buildCards(const SimLayout& layout, uint8_t densityPct,
+                    uint8_t depth, uint32_t seed) {
+  uint32_t blocks = 0;
+  uint8_t chainPrev = 0;
+  uint8_t chainPosition = 0;
+  for (uint8_t id = 0; id < layout.cards.totalCards; ++id) {
+    V3CardConfig& card = gCards[id];
+    card = {};
+    card.cardId = id;
+    card.enabled = true;
+    card.family = familyAt(layout, id);
+
+    V3ConditionBlock set = constantBlock(id, Op_AlwaysFalse);
+    V3ConditionBlock reset = constantBlock(id, Op_AlwaysFalse);
+    if (hasConditions(card.family)) {
+      const bool chainHead = (chainPosition % depth) == 0;
+      set = syntheticBlock(layout, id, chainPrev, chainHead, densityPct, seed);
+      reset = syntheticBlock(layout, id, chainPrev, chainHead,
+                             densityPct / 4, seed);
+      chainPrev = id;
+      chainPosition += 1;
+      blocks += 2;
+    }
+
+    switch (card.family) {
+      case V3CardFamily::DI:
+        card.di.channel = id;
+        card.di.edgeMode = Mode_DI_Change;
+        card.di.debounceTimeMs = (nextRandom(seed) & 1U) ? 0 : 20;
+        card.di.set = constantBlock(id, Op_AlwaysTrue);
+        card.di.reset = reset;
+        break;
+      case V3CardFamily::DO:
+        card.dout.channel = static_cast<uint8_t>(id - layout.cards.doStart);
+        card.dout.mode = Mode_DO_Normal;
+        card.dout.delayBeforeOnMs = 500 + nextRandom(seed) % 2000U;
+        card.dout.onDurationMs = 500 + nextRandom(seed) % 2000U;
+        card.dout.repeatCount = nextRandom(seed) % 4U;
+        card.dout.set = set;
+        card.dout.reset = reset;
+        break;
+      case V3CardFamily::AI:
+        card.ai.channel = static_cast<uint8_t>(id - layout.cards.aiStart);
+        card.ai.inputMax = 4095;
+        card.ai.outputMax = 4095;
+        card.ai.emaAlphaX100 = 50;
+        break;
+      case V3CardFamily::SIO:
+        card.sio.mode = Mode_DO_Normal;
+        card.sio.delayBeforeOnMs = nextRandom(seed) % 1000U;
+        card.sio.onDurationMs = 500 + nextRandom(seed) % 2000U;
+        card.sio.repeatCount = 1;
+        card.sio.set = set;
+        card.sio.reset = reset;
+        break;
+      case V3CardFamily::MATH:
+        card.math.inputA = nextRandom(seed) % 1000U;
+        card.math.inputB = nextRandom(seed) % 1000U;
+        card.math.clampMax = 4095;
+        card.math.set = set;
+        card.math.reset = reset;
+        break;
+      case V3CardFamily::RTC:
+        card.rtc.minute = static_cast<uint8_t>(nextRandom(seed) % 60U);
+        card.rtc.triggerDurationMs = 60000;
+        break;
+    }
+  }
+  return blocks;
+}
+
+void driveInputs(uint32_t round, uint32_t& seed) {
+  gSim.io.inputLevels ^= 1ULL << (nextRandom(seed) % 64U);
+  gSim.io.analogValues[round % kMemoryIoAnalogPins] = nextRandom(seed) % 4096U;
+}
+
+// Same per-card copies as updateSharedRuntimeSnapshot(...) in main.cpp.
+void captureSnapshot(uint8_t cards) {
+  const V3ScanEngine& engine = gSim.engine;
+  gSnapshot.seq += 1;
+  gSnapshot.tsMs = static_cast<uint32_t>(gSim.nowMs);
+  gSnapshot.scanCursor = engine.cursor;
+  gSnapshot.scanCardsEvaluatedLast = engine.cardsEvaluated;
+  gSnapshot.scanCardsSkippedLast = engine.cardsSkipped;
+  buildRuntimeSnapshotCards(gSim.meta, cards, engine.store, gSnapshot.cards);
+  memcpy(gSnapshot.inputSource, gSim.inputSource,
+         cards * sizeof(gSim.inputSource[0]));
+  memcpy(gSnapshot.forcedAIValue, gSim.forcedAIValue,
+         cards * sizeof(gSim.forcedAIValue[0]));
+  memcpy(gSnapshot.outputMaskLocal, gSim.outputMask,
+         cards * sizeof(gSim.outputMask[0]));
+  V3SignalStoreView published =
+      makeV3SignalStoreView(gSnapshot.signals, cards);
+  copyV3SignalStore(engine.signals, published);
+}
+
+// One input change plus a full scan; returns the scan time.
+double runScanPeriod(uint32_t round, uint32_t& seed, bool evaluateAll) {
+  V3ScanEngine& engine = gSim.engine;
+  driveInputs(round, seed);
+  gSim.nowMs += kScanIntervalMs;
+  const uint32_t nowMs = static_cast<uint32_t>(gSim.nowMs);
+  const auto start = std::chrono::steady_clock::now();
+  sampleV3ScanInputs(engine);
+  markV3DueTimerCards(engine, nowMs);
+  engine.cardsEvaluated = 0;
+  engine.cardsSkipped = 0;
+  for (uint8_t i = 0; i < engine.count; ++i) {
+    runV3ScanCursorCard(engine, nowMs, evaluateAll);
+  }
+  latchV3ScanOutputs(engine);
+  return elapsedNs(start, std::chrono::steady_clock::now());
+}
+
+void runCase(uint8_t cards, const FamilyMix& mix, uint8_t densityPct,
+             uint8_t depth, ScalingResult& result) {
+  const SimLayout layout = buildLayout(cards, mix);
+  TEST_ASSERT_TRUE(initSimController(gSim, layout, kScanIntervalMs, 2026, 1, 1));
+  uint32_t seed = 0x5CA1EU + cards * 131U + densityPct * 7U + depth;
+  const uint32_t blocksPerScan = buildCards(layout, densityPct, depth, seed);
+  TEST_ASSERT_TRUE(loadSimConfig(gSim, gCards, cards, nullptr, 0));
+
+  result = {};
+  V3ScanEngine& engine = gSim.engine;
+  const uint32_t scans = kCardScansPerCase / cards;
+  uint64_t evaluated = 0;
+  double scanTotalNs = 0.0;
+  for (uint32_t round = 0; round < scans; ++round) {
+    const double scanNs = runScanPeriod(round, seed, true);
+    scanTotalNs += scanNs;
+    evaluated += engine.cardsEvaluated;
+
+    const uint32_t scanUs = static_cast<uint32_t>(scanNs / 1000.0);
+    result.scanLastUs = scanUs;
+    if (scanUs > result.scanMaxUs) result.scanMaxUs = scanUs;
+    if (scanUs > kScanIntervalMs * 1000U) result.scanOverrunCount += 1;
+  }
+  TEST_ASSERT_TRUE(evaluated == static_cast<uint64_t>(scans) * cards);
+  result.scanNsPerCard = scanTotalNs / (static_cast<double>(scans) * cards);
+  result.conditionEvalsPerSec =
+      scanTotalNs > 0.0
+          ? (static_cast<double>(blocksPerScan) * scans) / (scanTotalNs / 1e9)
+          : 0.0;
+
+  const auto buildStart = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < scans; ++round) captureSnapshot(cards);
+  result.snapshotBuildNs =
+      elapsedNs(buildStart, std::chrono::steady_clock::now()) / scans;
+  gSnapshot.scanBudgetUs = kScanIntervalMs * 1000U;
+  gSnapshot.kernelQueueCapacity = kQueueCapacity;
+
+  const uint32_t jsonRounds =
+      kJsonCardsPerCase / cards > 20 ? kJsonCardsPerCase / cards : 20;
+  std::string payload;
+  const auto jsonStart = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < jsonRounds; ++round) {
+    JsonDocument doc;
+    serializeRuntimeSnapshotDocument(doc, gSnapshot, cards,
+                                     gSnapshot.tsMs, kScanIntervalMs);
+    payload.clear();
+    serializeJson(doc, payload);
+  }
+  result.jsonSerializeNs =
+      elapsedNs(jsonStart, std::chrono::steady_clock::now()) / jsonRounds;
+  result.jsonBytes = payload.size();
+
+  JsonDocument check;
+  TEST_ASSERT_FALSE(deserializeJson(check, payload));
+  TEST_ASSERT_EQUAL_UINT32(cards, check["cards"].size());
+
+  // Same keyframe in the negotiated binary encoding.
+  std::string packed;
+  const auto msgpackStart = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < jsonRounds; ++round) {
+    JsonDocument doc;
+    serializeRuntimeSnapshotDocument(doc, gSnapshot, cards, gSnapshot.tsMs,
+                                     kScanIntervalMs, SnapshotEncoding_MsgPack);
+    packed.clear();
+    serializeMsgPack(doc, packed);
+  }
+  result.msgpackSerializeNs =
+      elapsedNs(msgpackStart, std::chrono::steady_clock::now()) / jsonRounds;
+  result.msgpackBytes = packed.size();
+  check.clear();
+  TEST_ASSERT_FALSE(deserializeMsgPack(check, packed));
+  TEST_ASSERT_EQUAL_UINT32(cards, check["cards"].size());
+
+  // WebSocket delta for the next scan period against the frame above; the
+  // period scans incrementally as the firmware does by default.
+  gPreviousSnapshot = gSnapshot;
+  runScanPeriod(scans, seed, false);
+  captureSnapshot(cards);
+  const auto patchStart = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < jsonRounds; ++round) {
+    JsonDocument doc;
+    serializeRuntimeSnapshotPatch(doc, gPreviousSnapshot, gSnapshot, cards,
+                                  gSnapshot.tsMs, kScanIntervalMs);
+    payload.clear();
+    serializeJson(doc, payload);
+  }
+  result.patchSerializeNs =
+      elapsedNs(patchStart, std::chrono::steady_clock::now()) / jsonRounds;
+  result.patchBytes = payload.size();
+}
+
+// Leading columns match docs/snapshot-baseline.csv so the same tooling can
+// plot both; the host run has no queue traffic, so those columns are fixed.
+void printCsvHeader() {
+  printf("\"ts\",\"scanLastUs\",\"scanMaxUs\",\"scanBudgetUs\","
+         "\"scanOverrunCount\",\"queueDepth\",\"queueHighWaterMark\","
+         "\"queueCapacity\",\"commandLatencyLastUs\",\"commandLatencyMaxUs\","
+         "\"cards\",\"mix\",\"conditionDensityPct\",\"dependencyDepth\","
+         "\"scanNsPerCard\",\"conditionEvalsPerSec\",\"snapshotBuildNs\","
+         "\"jsonSerializeNs\",\"jsonBytes\",\"patchSerializeNs\","
+         "\"patchBytes\",\"msgpackSerializeNs\",\"msgpackBytes\"\n");
+}
+
+void printCsvRow(uint8_t cards, const FamilyMix& mix, uint8_t densityPct,
+                 uint8_t depth, const ScalingResult& r) {
+  char ts[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  printf("\"%s\",\"%u\",\"%u\",\"%u\",\"%u\",\"0\",\"0\",\"%u\",\"0\",\"0\","
+         "\"%u\",\"%s\",\"%u\",\"%u\",\"%.1f\",\"%.0f\",\"%.0f\",\"%.0f\","
+         "\"%u\",\"%.0f\",\"%u\",\"%.0f\",\"%u\"\n",
+         ts, r.scanLastUs, r.scanMaxUs, kScanIntervalMs * 1000U,
+         r.scanOverrunCount, kQueueCapacity, cards, mix.name, densityPct,
+         depth, r.scanNsPerCard, r.conditionEvalsPerSec, r.snapshotBuildNs,
+         r.jsonSerializeNs, static_cast<unsigned>(r.jsonBytes),
+         r.patchSerializeNs, static_cast<unsigned>(r.patchBytes),
+         r.msgpackSerializeNs, static_cast<unsigned>(r.msgpackBytes));
+}
+
+void runScaling(uint8_t cards) {
+  for (const FamilyMix& mix : kMixes) {
+    for (uint8_t densityPct : kDensitiesPct) {
+      for (uint8_t depth : kDepths) {
+        ScalingResult result = {};
+        runCase(cards, mix, densityPct, depth, result);
+        printCsvRow(cards, mix, densityPct, depth, result);
+      }
+    }
+  }
+}
+}  // namespace
+
+void test_bench_scan_scaling_12_cards() { runScaling(12); }
+void test_bench_scan_scaling_18_cards() { runScaling(18); }
+void test_bench_scan_scaling_64_cards() { runScaling(64); }
+void test_bench_scan_scaling_128_cards() { runScaling(128); }
+void test_bench_scan_scaling_255_cards() { runScaling(255); }
+
+int main() {
+  printCsvHeader();
+  UNITY_BEGIN();
+  RUN_TEST(test_bench_scan_scaling_12_cards);
+  RUN_TEST(test_bench_scan_scaling_18_cards);
+  RUN_TEST(test_bench_scan_scaling_64_cards);
+  RUN_TEST(test_bench_scan_scaling_128_cards);
+  RUN_TEST(test_bench_scan_scaling_255_cards);
+  return UNITY_END();
+}
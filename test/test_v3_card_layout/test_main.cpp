@@ -0,0 +1,130 @@
+#include <unity.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/kernel/v3_card_bridge.cpp"
+#include "../../src/platform/esp32_devkit_profile.h"
+#include "../../src/storage/v3_config_service.h"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+// V3CardConfig before the family union: every card carried all six
+// family configs side by side. Kept here only to report the saving.
+struct SideBySideCardConfig {
+  uint8_t cardId;
+  V3CardFamily family;
+  bool enabled;
+  V3FaultPolicy faultPolicy;
+  V3DiConfig di;
+  V3DoConfig dout;
+  V3AiConfig ai;
+  V3SioConfig sio;
+  V3MathConfig math;
+  V3RtcConfig rtc;
+};
+
+constexpr size_t kLargestFamily =
+    sizeof(V3DoConfig) > sizeof(V3MathConfig)
+        ? (sizeof(V3DoConfig) > sizeof(V3SioConfig) ? sizeof(V3DoConfig)
+                                                    : sizeof(V3SioConfig))
+        : sizeof(V3MathConfig);
+
+LogicCard rtcLegacyCard() {
+  LogicCard card = {};
+  card.id = 16;
+  card.type = RtcCard;
+  card.mode = Mode_None;
+  card.setting1 = 1500;
+  return card;
+}
+}  // namespace
+
+void test_card_config_pays_for_one_family() {
+  const size_t header = offsetof(V3CardConfig, dout);
+  TEST_ASSERT_TRUE(kLargestFamily >= sizeof(V3DiConfig));
+  TEST_ASSERT_TRUE(kLargestFamily >= sizeof(V3AiConfig));
+  TEST_ASSERT_TRUE(kLargestFamily >= sizeof(V3RtcConfig));
+  TEST_ASSERT_TRUE(sizeof(V3CardConfig) <= header + kLargestFamily + 4);
+  TEST_ASSERT_TRUE(sizeof(V3CardConfig) * 4 <= sizeof(SideBySideCardConfig));
+}
+
+void test_report_typed_config_ram() {
+  constexpr size_t kProfileCards = FirmwareHardwareProfile::kTotalCards;
+  const size_t before = sizeof(SideBySideCardConfig);
+  const size_t after = sizeof(V3CardConfig);
+  const size_t contextBefore =
+      sizeof(V3ConfigContext) + kV3ConfigContextMaxCards * (before - after);
+  printf("v3_card_config bytes_per_card before=%u after=%u\n",
+         static_cast<unsigned>(before), static_cast<unsigned>(after));
+  printf("v3_card_config profile_cards=%u before=%u after=%u\n",
+         static_cast<unsigned>(kProfileCards),
+         static_cast<unsigned>(kProfileCards * before),
+         static_cast<unsigned>(kProfileCards * after));
+  printf("v3_config_context max_cards=%u before=%u after=%u\n",
+         static_cast<unsigned>(kV3ConfigContextMaxCards),
+         static_cast<unsigned>(contextBefore),
+         static_cast<unsigned>(sizeof(V3ConfigContext)));
+  TEST_ASSERT_TRUE(sizeof(V3ConfigContext) < contextBefore);
+}
+
+void test_reused_card_keeps_no_stale_family_bytes() {
+  V3CardConfig cfg;
+  memset(&cfg, 0xA5, sizeof(cfg));
+  cfg.family = V3CardFamily::DO;
+
+  const LogicCard legacy = rtcLegacyCard();
+  TEST_ASSERT_TRUE(
+      legacyToV3CardConfig(legacy, -1, -1, -1, 2, 7, 30, cfg));
+  TEST_ASSERT_TRUE(cfg.family == V3CardFamily::RTC);
+  TEST_ASSERT_EQUAL_UINT32(1500, cfg.asRtc().triggerDurationMs);
+  TEST_ASSERT_EQUAL_UINT8(7, cfg.asRtc().hour);
+  TEST_ASSERT_FALSE(cfg.asRtc().hasYear);
+
+  const uint8_t* tail =
+      reinterpret_cast<const uint8_t*>(&cfg.rtc) + sizeof(V3RtcConfig);
+  const uint8_t* end = reinterpret_cast<const uint8_t*>(&cfg) + sizeof(cfg);
+  uint32_t stale = 0;
+  for (const uint8_t* p = tail; p < end; ++p) {
+    if (*p != 0) stale += 1;
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, stale);
+
+  LogicCard back = {};
+  TEST_ASSERT_TRUE(v3CardConfigToLegacy(cfg, back));
+  TEST_ASSERT_EQUAL(RtcCard, back.type);
+  TEST_ASSERT_EQUAL_UINT32(1500, back.setting1);
+}
+
+void test_accessor_returns_the_live_family() {
+  LogicCard legacy = {};
+  legacy.id = 5;
+  legacy.type = DigitalOutput;
+  legacy.index = 2;
+  legacy.mode = Mode_DO_Gated;
+  V3CardConfig cfg = {};
+  TEST_ASSERT_TRUE(legacyToV3CardConfig(legacy, -1, -1, -1, -1, -1, -1, cfg));
+  TEST_ASSERT_TRUE(cfg.family == V3CardFamily::DO);
+  TEST_ASSERT_TRUE(&cfg.asDo() == &cfg.dout);
+  TEST_ASSERT_EQUAL_UINT8(2, cfg.asDo().channel);
+  TEST_ASSERT_EQUAL(Mode_DO_Gated, cfg.asDo().mode);
+
+  cfg = {};
+  cfg.family = V3CardFamily::MATH;
+  cfg.asMath().clampMax = 900;
+  const V3CardConfig& view = cfg;
+  TEST_ASSERT_EQUAL_UINT32(900, view.asMath().clampMax);
+  TEST_ASSERT_TRUE(&view.asMath() == &cfg.math);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_card_config_pays_for_one_family);
+  RUN_TEST(test_report_typed_config_ram);
+  RUN_TEST(test_reused_card_keeps_no_stale_family_bytes);
+  RUN_TEST(test_accessor_returns_the_live_family);
+  return UNITY_END();
+}
@@ -0,0 +1,45 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_card_profile.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+void test_record_tracks_last_max_and_total() {
+  V3CardCost costs[2] = {};
+  recordV3CardCost(costs[1], 120);
+  recordV3CardCost(costs[1], 480);
+  recordV3CardCost(costs[1], 60);
+
+  TEST_ASSERT_EQUAL_UINT32(60, costs[1].lastTicks);
+  TEST_ASSERT_EQUAL_UINT32(480, costs[1].maxTicks);
+  TEST_ASSERT_TRUE(costs[1].totalTicks == 660);
+  TEST_ASSERT_EQUAL_UINT32(3, costs[1].samples);
+  TEST_ASSERT_EQUAL_UINT32(0, costs[0].samples);
+
+  resetV3CardCosts(costs, 2);
+  TEST_ASSERT_EQUAL_UINT32(0, costs[1].maxTicks);
+  TEST_ASSERT_EQUAL_UINT32(0, costs[1].samples);
+}
+
+void test_total_does_not_wrap_at_32_bits() {
+  V3CardCost cost = {};
+  recordV3CardCost(cost, 0xF0000000UL);
+  recordV3CardCost(cost, 0xF0000000UL);
+  TEST_ASSERT_TRUE(cost.totalTicks > 0xFFFFFFFFULL);
+}
+
+void test_counter_measures_elapsed_work() {
+  const uint32_t start = readV3CostCounter();
+  volatile uint32_t sink = 0;
+  for (uint32_t i = 0; i < 100000; ++i) sink += i;
+  TEST_ASSERT_TRUE(readV3CostCounter() - start > 0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_record_tracks_last_max_and_total);
+  RUN_TEST(test_total_does_not_wrap_at_32_bits);
+  RUN_TEST(test_counter_measures_elapsed_work);
+  return UNITY_END();
+}
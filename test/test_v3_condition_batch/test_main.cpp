@@ -0,0 +1,164 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_status_runtime.cpp"
+#include "../../src/kernel/v3_condition_eval.cpp"
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_condition_batch.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint8_t kMaxCards = 255;
+constexpr uint16_t kMaxPrograms = 2 * kMaxCards;
+
+V3RuntimeSignal gSignals[kMaxCards] = {};
+V3SignalStorage<kMaxCards> gSignalStorage = {};
+RuntimeCardMeta gMeta[kMaxCards] = {};
+V3ConditionBlock gBlocks[kMaxPrograms] = {};
+V3ConditionProgram gPrograms[kMaxPrograms] = {};
+V3ConditionBatchStorage<kMaxPrograms> gBatchStorage = {};
+uint32_t gResults[v3SignalWordCount(kMaxPrograms)] = {};
+
+uint32_t nextRandom(uint32_t& seed) {
+  seed = seed * 1664525U + 1013904223U;
+  return seed >> 8;
+}
+
+// Random signals plus blocks over every operator, including out-of-range
+// sources and combiners so the lowered constants are exercised too.
+void buildRandomConfig(uint8_t cards, uint16_t programs, uint32_t seed) {
+  const logicCardType types[] = {DigitalInput, DigitalOutput, AnalogInput,
+                                 SoftIO,       MathCard,      RtcCard};
+  V3SignalStoreView store = makeV3SignalStoreView(gSignalStorage, cards);
+  for (uint8_t i = 0; i < cards; ++i) {
+    gMeta[i] = {};
+    gMeta[i].id = i;
+    gMeta[i].type = types[nextRandom(seed) % 6];
+    gSignals[i] = {};
+    gSignals[i].type = gMeta[i].type;
+    gSignals[i].state = static_cast<cardState>(nextRandom(seed) % 10);
+    gSignals[i].logicalState = (nextRandom(seed) & 1U) != 0;
+    gSignals[i].physicalState = (nextRandom(seed) & 1U) != 0;
+    gSignals[i].triggerFlag = (nextRandom(seed) & 1U) != 0;
+    gSignals[i].currentValue = nextRandom(seed) % 64U;
+    writeV3Signal(store, i, gSignals[i]);
+  }
+  for (uint16_t i = 0; i < programs; ++i) {
+    V3ConditionBlock& block = gBlocks[i];
+    block = {};
+    block.clauseAId = static_cast<uint8_t>(nextRandom(seed) % (cards + 2U));
+    block.clauseAOperator =
+        static_cast<logicOperator>(nextRandom(seed) % (Op_Stopped + 2));
+    block.clauseAThreshold = nextRandom(seed) % 64U;
+    block.clauseBId = static_cast<uint8_t>(nextRandom(seed) % (cards + 2U));
+    block.clauseBOperator =
+        static_cast<logicOperator>(nextRandom(seed) % (Op_Stopped + 2));
+    block.clauseBThreshold = nextRandom(seed) % 64U;
+    block.combiner = static_cast<combineMode>(nextRandom(seed) % 4);
+    gPrograms[i] = compileV3ConditionProgram(block, gMeta, cards);
+  }
+}
+
+void assertBatchMatchesReference(uint8_t cards, uint16_t programs,
+                                 uint32_t seed) {
+  buildRandomConfig(cards, programs, seed);
+  const V3SignalStoreView store = makeV3SignalStoreView(gSignalStorage, cards);
+  V3ConditionBatchView batch =
+      makeV3ConditionBatchView(gBatchStorage, gPrograms, programs);
+  compileV3ConditionBatch(batch);
+  evalV3ConditionBatch(batch, store, gResults);
+
+  for (uint16_t i = 0; i < programs; ++i) {
+    const bool expected = evalV3ConditionBlock(gBlocks[i], gSignals, cards);
+    const bool actual = ((gResults[i >> 5] >> (i & 31U)) & 1U) != 0;
+    TEST_ASSERT_EQUAL(expected, actual);
+    TEST_ASSERT_EQUAL(evalV3ConditionProgram(gPrograms[i], store), actual);
+  }
+  const uint16_t tail = programs & 31U;
+  if (tail != 0) {
+    TEST_ASSERT_EQUAL_HEX32(0, gResults[programs >> 5] >> tail);
+  }
+}
+}  // namespace
+
+void test_batch_matches_reference_on_random_configs() {
+  const uint8_t cardCounts[] = {1, 12, 31, 32, 33, 64, 200, 255};
+  for (uint8_t c = 0; c < sizeof(cardCounts); ++c) {
+    for (uint32_t seed = 1; seed <= 16; ++seed) {
+      const uint8_t cards = cardCounts[c];
+      assertBatchMatchesReference(cards, static_cast<uint16_t>(cards) * 2U,
+                                  seed * 7919U + cards);
+    }
+  }
+}
+
+void test_batch_lists_only_numeric_and_state_clauses_as_compares() {
+  RuntimeCardMeta meta[2] = {};
+  meta[1].type = DigitalOutput;
+  V3ConditionBlock blocks[3] = {};
+  blocks[0].clauseAOperator = Op_LogicalTrue;
+  blocks[0].clauseBId = 1;
+  blocks[0].clauseBOperator = Op_TriggerCleared;
+  blocks[0].combiner = Combine_AND;
+  blocks[1].clauseAOperator = Op_GT;
+  blocks[1].combiner = Combine_None;
+  blocks[2].clauseAOperator = Op_PhysicalOn;
+  blocks[2].clauseBId = 1;
+  blocks[2].clauseBOperator = Op_Running;
+  blocks[2].combiner = Combine_OR;
+
+  V3ConditionProgram programs[3] = {};
+  for (uint8_t i = 0; i < 3; ++i) {
+    programs[i] = compileV3ConditionProgram(blocks[i], meta, 2);
+  }
+  V3ConditionBatchStorage<3> storage = {};
+  V3ConditionBatchView batch = makeV3ConditionBatchView(storage, programs, 3);
+  compileV3ConditionBatch(batch);
+
+  TEST_ASSERT_EQUAL_UINT16(2, batch.compareCount);
+  TEST_ASSERT_EQUAL_UINT16(1U << 1, batch.compares[0]);
+  TEST_ASSERT_EQUAL_UINT16((2U << 1) | 1U, batch.compares[1]);
+  TEST_ASSERT_EQUAL(CondPlane_Trigger, batch.clauseB[0].plane);
+  TEST_ASSERT_EQUAL_HEX32(0x1U, batch.invertB[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x4U, batch.anyOf[0]);
+}
+
+void test_batch_follows_signal_changes_without_recompile() {
+  RuntimeCardMeta meta[2] = {};
+  V3ConditionBlock block = {};
+  block.clauseAId = 1;
+  block.clauseAOperator = Op_LogicalTrue;
+  block.clauseBId = 0;
+  block.clauseBOperator = Op_PhysicalOff;
+  block.combiner = Combine_AND;
+  const V3ConditionProgram program = compileV3ConditionProgram(block, meta, 2);
+
+  V3ConditionBatchStorage<1> batchStorage = {};
+  V3ConditionBatchView batch =
+      makeV3ConditionBatchView(batchStorage, &program, 1);
+  compileV3ConditionBatch(batch);
+
+  V3SignalStorage<2> signalStorage = {};
+  V3SignalStoreView store = makeV3SignalStoreView(signalStorage, 2);
+  uint32_t result = 0xFFFFFFFFUL;
+  evalV3ConditionBatch(batch, store, &result);
+  TEST_ASSERT_EQUAL_HEX32(0, result);
+
+  setV3SignalBit(store.logical, 1, true);
+  evalV3ConditionBatch(batch, store, &result);
+  TEST_ASSERT_EQUAL_HEX32(1, result);
+
+  setV3SignalBit(store.physical, 0, true);
+  evalV3ConditionBatch(batch, store, &result);
+  TEST_ASSERT_EQUAL_HEX32(0, result);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_batch_matches_reference_on_random_configs);
+  RUN_TEST(test_batch_lists_only_numeric_and_state_clauses_as_compares);
+  RUN_TEST(test_batch_follows_signal_changes_without_recompile);
+  return UNITY_END();
+}
@@ -0,0 +1,105 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_status_runtime.cpp"
+#include "../../src/kernel/v3_condition_eval.cpp"
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+const logicCardType kTypes[] = {DigitalInput, DigitalOutput, AnalogInput,
+                                SoftIO,       MathCard,      RtcCard};
+const cardState kStates[] = {State_None,       State_DI_Idle,
+                             State_DI_Qualified, State_AI_Streaming,
+                             State_DO_Idle,    State_DO_OnDelay,
+                             State_DO_Active,  State_DO_Finished};
+
+void fillSignals(V3RuntimeSignal* signals, V3SignalStoreView& store,
+                 RuntimeCardMeta* meta, uint8_t count, uint8_t stateOffset) {
+  for (uint8_t i = 0; i < count; ++i) {
+    meta[i] = {};
+    meta[i].id = i;
+    meta[i].type = kTypes[i % 6];
+    signals[i] = {};
+    signals[i].type = meta[i].type;
+    signals[i].state = kStates[(i + stateOffset) % 8];
+    signals[i].logicalState = ((i + stateOffset) & 1U) != 0;
+    signals[i].physicalState = ((i + stateOffset) & 2U) != 0;
+    signals[i].triggerFlag = ((i + stateOffset) & 4U) != 0;
+    signals[i].currentValue = (i + stateOffset) * 7U;
+    writeV3Signal(store, i, signals[i]);
+  }
+}
+}  // namespace
+
+void test_program_matches_reference_for_all_operators_and_sources() {
+  constexpr uint8_t kCount = 12;
+  V3RuntimeSignal signals[kCount] = {};
+  V3SignalStorage<kCount> storage = {};
+  V3SignalStoreView store = makeV3SignalStoreView(storage, kCount);
+  RuntimeCardMeta meta[kCount] = {};
+
+  for (uint8_t offset = 0; offset < 8; ++offset) {
+    fillSignals(signals, store, meta, kCount, offset);
+    for (uint8_t op = Op_AlwaysTrue; op <= Op_Stopped + 1; ++op) {
+      for (uint8_t source = 0; source <= kCount; ++source) {
+        for (uint8_t combiner = Combine_None; combiner <= Combine_OR + 1;
+             ++combiner) {
+          V3ConditionBlock block = {};
+          block.clauseAId = source;
+          block.clauseAOperator = static_cast<logicOperator>(op);
+          block.clauseAThreshold = 35;
+          block.clauseBId = static_cast<uint8_t>((source + 5) % (kCount + 2));
+          block.clauseBOperator =
+              static_cast<logicOperator>((op + 3) % (Op_Stopped + 1));
+          block.clauseBThreshold = 14;
+          block.combiner = static_cast<combineMode>(combiner);
+
+          const V3ConditionProgram program =
+              compileV3ConditionProgram(block, meta, kCount);
+          TEST_ASSERT_EQUAL(evalV3ConditionBlock(block, signals, kCount),
+                            evalV3ConditionProgram(program, store));
+        }
+      }
+    }
+  }
+}
+
+void test_out_of_range_source_compiles_to_constant_false() {
+  RuntimeCardMeta meta[2] = {};
+  V3ConditionBlock block = {};
+  block.clauseAId = 9;
+  block.clauseAOperator = Op_LogicalTrue;
+  block.combiner = Combine_None;
+
+  const V3ConditionProgram program = compileV3ConditionProgram(block, meta, 2);
+  TEST_ASSERT_EQUAL(CondOp_False, program.a.opcode);
+  TEST_ASSERT_EQUAL_UINT8(0, program.a.source);
+}
+
+void test_mission_operator_on_non_mission_source_compiles_to_false() {
+  RuntimeCardMeta meta[2] = {};
+  meta[0].type = DigitalInput;
+  meta[1].type = SoftIO;
+  V3ConditionBlock block = {};
+  block.clauseAId = 0;
+  block.clauseAOperator = Op_Running;
+  block.clauseBId = 1;
+  block.clauseBOperator = Op_Stopped;
+  block.combiner = Combine_OR;
+
+  const V3ConditionProgram program = compileV3ConditionProgram(block, meta, 2);
+  TEST_ASSERT_EQUAL(CondOp_False, program.a.opcode);
+  TEST_ASSERT_EQUAL(CondOp_StateEither, program.b.opcode);
+  TEST_ASSERT_TRUE(program.anyOf);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_program_matches_reference_for_all_operators_and_sources);
+  RUN_TEST(test_out_of_range_source_compiles_to_constant_false);
+  RUN_TEST(test_mission_operator_on_non_mission_source_compiles_to_false);
+  return UNITY_END();
+}
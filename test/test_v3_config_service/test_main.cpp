@@ -9,6 +9,7 @@
 #include "../../src/kernel/v3_typed_config_rules.cpp"
 #include "../../src/storage/v3_normalizer.cpp"
 #include "../../src/storage/v3_config_service.cpp"
+#include "../../src/storage/config_workspace.h"
 
 namespace {
 constexpr uint8_t kTotalCards = 2;
@@ -216,11 +217,41 @@ void test_apply_rtc_schedule_channels_from_config_copies_fields() {
   TEST_ASSERT_EQUAL_UINT8(17, target[1].rtcCardId);
 }
 
+void test_config_workspace_is_sized_and_exclusive() {
+  static V3ConfigWorkspaceT<kTotalCards> workspace;
+  TEST_ASSERT_TRUE(sizeof(workspace.context) < sizeof(V3ConfigContext));
+  {
+    V3ConfigWorkspaceLease<kTotalCards> lease(workspace);
+    TEST_ASSERT_TRUE(lease.get() == &workspace);
+    V3ConfigWorkspaceLease<kTotalCards> nested(workspace);
+    TEST_ASSERT_TRUE(nested.get() == nullptr);
+  }
+  V3ConfigWorkspaceLease<kTotalCards> lease(workspace);
+  TEST_ASSERT_TRUE(lease.get() == &workspace);
+
+  // A layout larger than the workspace is rejected, not overrun.
+  LogicCard baseline[kTotalCards] = {};
+  seedBaseline(baseline);
+  JsonDocument req;
+  req["apiVersion"] = "2.0";
+  req["schemaVersion"] = "2.0.0";
+  req["config"]["cards"].to<JsonArray>();
+  V3CardLayout layout = {kTotalCards + 1, kDoStart, kAiStart, kSioStart,
+                         kMathStart, kRtcStart};
+  String reason;
+  const char* errorCode = "VALIDATION_FAILED";
+  TEST_ASSERT_FALSE(normalizeV3ConfigRequestContext(
+      req.as<JsonObjectConst>(), layout, "2.0", "2.0.0", baseline,
+      kTotalCards, 0, lease.get()->context, reason, errorCode));
+  TEST_ASSERT_EQUAL_STRING("INTERNAL_ERROR", errorCode);
+}
+
 int main() {
   UNITY_BEGIN();
   RUN_TEST(test_normalize_service_rejects_invalid_api_version);
   RUN_TEST(test_normalize_service_accepts_valid_di_do_payload);
   RUN_TEST(test_build_legacy_cards_from_typed_uses_baseline);
   RUN_TEST(test_apply_rtc_schedule_channels_from_config_copies_fields);
+  RUN_TEST(test_config_workspace_is_sized_and_exclusive);
   return UNITY_END();
 }
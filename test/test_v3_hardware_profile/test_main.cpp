@@ -0,0 +1,83 @@
+#include <unity.h>
+
+#include "../../src/platform/esp32_devkit_profile.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+// Larger SKU: 16 DI on an expander, 16 DO, 8 AI, more virtual cards.
+struct WideBoard {
+  static constexpr uint8_t kDiPins[16] = {};
+  static constexpr uint8_t kDoPins[16] = {};
+  static constexpr uint8_t kAiPins[8] = {};
+  static constexpr uint8_t kDiCapacity = 16;
+  static constexpr uint8_t kDoCapacity = 16;
+  static constexpr uint8_t kAiCapacity = 8;
+  static constexpr uint8_t kSioCapacity = 32;
+  static constexpr uint8_t kMathCapacity = 64;
+  static constexpr uint8_t kRtcCapacity = 16;
+};
+constexpr uint8_t WideBoard::kDiPins[16];
+constexpr uint8_t WideBoard::kDoPins[16];
+constexpr uint8_t WideBoard::kAiPins[8];
+
+using Devkit = FirmwareHardwareProfile;
+using Wide = V3HardwareProfile<WideBoard>;
+
+static_assert(Devkit::kTotalCards == 18, "devkit card count");
+static_assert(Devkit::kRtcStart == 16, "devkit RTC range");
+static_assert(Devkit::typeForId(8) == AnalogInput, "devkit AI range");
+static_assert(Wide::kTotalCards == 152, "wide card count");
+static_assert(Wide::familyForId(Wide::kMathStart) == V3CardFamily::MATH,
+              "wide MATH range");
+static_assert(v3CardFamilyIndex(Wide::kLayout, Wide::kRtcStart + 3) == 3,
+              "wide RTC index");
+}  // namespace
+
+void test_devkit_profile_matches_firmware_layout() {
+  const V3CardLayout& layout = Devkit::kLayout;
+  TEST_ASSERT_EQUAL_UINT8(18, layout.totalCards);
+  TEST_ASSERT_EQUAL_UINT8(4, layout.doStart);
+  TEST_ASSERT_EQUAL_UINT8(8, layout.aiStart);
+  TEST_ASSERT_EQUAL_UINT8(10, layout.sioStart);
+  TEST_ASSERT_EQUAL_UINT8(14, layout.mathStart);
+  TEST_ASSERT_EQUAL_UINT8(16, layout.rtcStart);
+
+  const V3ScanPlanPins pins = Devkit::scanPlanPins();
+  TEST_ASSERT_EQUAL_UINT8(4, pins.diCount);
+  TEST_ASSERT_EQUAL_UINT8(4, pins.doCount);
+  TEST_ASSERT_EQUAL_UINT8(2, pins.aiCount);
+  TEST_ASSERT_EQUAL_UINT8(13, pins.diPins[0]);
+  TEST_ASSERT_EQUAL_UINT8(32, pins.doPins[3]);
+  TEST_ASSERT_EQUAL_UINT8(34, pins.aiPins[1]);
+}
+
+void test_layout_lookups_follow_family_ranges() {
+  const V3CardLayout& layout = Devkit::kLayout;
+  TEST_ASSERT_EQUAL(DigitalInput, v3CardTypeForId(layout, 3));
+  TEST_ASSERT_EQUAL(DigitalOutput, v3CardTypeForId(layout, 4));
+  TEST_ASSERT_EQUAL(SoftIO, v3CardTypeForId(layout, 13));
+  TEST_ASSERT_EQUAL(MathCard, v3CardTypeForId(layout, 14));
+  TEST_ASSERT_EQUAL(RtcCard, v3CardTypeForId(layout, 17));
+  TEST_ASSERT_EQUAL_UINT8(1, v3CardFamilyIndex(layout, 9));
+  TEST_ASSERT_EQUAL_UINT8(10, v3FamilyStart(layout, V3CardFamily::SIO));
+}
+
+void test_wider_profile_derives_contiguous_ranges() {
+  TEST_ASSERT_EQUAL_UINT8(16, Wide::kDoStart);
+  TEST_ASSERT_EQUAL_UINT8(32, Wide::kAiStart);
+  TEST_ASSERT_EQUAL_UINT8(40, Wide::kSioStart);
+  TEST_ASSERT_EQUAL_UINT8(72, Wide::kMathStart);
+  TEST_ASSERT_EQUAL_UINT8(136, Wide::kRtcStart);
+  TEST_ASSERT_EQUAL(DigitalOutput, Wide::typeForId(31));
+  TEST_ASSERT_EQUAL(RtcCard, Wide::typeForId(151));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_devkit_profile_matches_firmware_layout);
+  RUN_TEST(test_layout_lookups_follow_family_ranges);
+  RUN_TEST(test_wider_profile_derives_contiguous_ranges);
+  return UNITY_END();
+}
@@ -0,0 +1,351 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_di_runtime.cpp"
+#include "../../src/kernel/v3_do_runtime.cpp"
+#include "../../src/kernel/v3_incremental_scan.cpp"
+#include "../../src/kernel/v3_math_runtime.cpp"
+#include "../../src/kernel/v3_rtc_runtime.cpp"
+#include "../../src/kernel/v3_runtime_adapters.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/kernel/v3_runtime_store.cpp"
+#include "../../src/kernel/v3_scan_plan.cpp"
+#include "../../src/kernel/v3_sio_runtime.cpp"
+#include "../../src/kernel/v3_timer_index.cpp"
+#include "../../src/runtime/runtime_card_meta.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint8_t kDoStart = 2;
+constexpr uint8_t kAiStart = 5;
+constexpr uint8_t kSioStart = 6;
+constexpr uint8_t kMathStart = 10;
+constexpr uint8_t kRtcStart = 12;
+constexpr uint8_t kCards = 13;
+
+struct TestEngine {
+  V3DiRuntimeState di[2];
+  V3DoRuntimeState dOut[3];
+  V3AiRuntimeState ai[1];
+  V3SioRuntimeState sio[4];
+  V3MathRuntimeState math[2];
+  V3RtcRuntimeState rtc[1];
+  V3RuntimeStoreView store;
+  RuntimeCardMeta meta[kCards];
+  V3ScanPlanEntry plan[kCards];
+  V3SignalStorage<kCards> signalStorage;
+  V3SignalStoreView signals;
+  bool prevSample[kCards];
+  bool prevPrimed[kCards];
+  bool dirty[kCards];
+  uint16_t offsets[kCards + 1];
+  uint8_t dependents[kCards * kV3MaxSourcesPerCard];
+  V3DependencyIndexView index;
+  bool lastSample[kCards];
+  uint8_t timerHeap[kCards];
+  uint8_t timerPosition[kCards];
+  uint32_t timerDueMs[kCards];
+  V3TimerIndexView timers;
+  uint32_t evaluated;
+};
+
+uint32_t nextRandom(uint32_t& seed) {
+  seed = seed * 1664525U + 1013904223U;
+  return seed >> 8;
+}
+
+V3ConditionBlock randomBlock(uint32_t& seed) {
+  V3ConditionBlock block = {};
+  block.clauseAId = static_cast<uint8_t>(nextRandom(seed) % kCards);
+  block.clauseAOperator =
+      static_cast<logicOperator>(nextRandom(seed) % (Op_Stopped + 1));
+  block.clauseAThreshold = nextRandom(seed) % 4U;
+  block.clauseBId = static_cast<uint8_t>(nextRandom(seed) % kCards);
+  block.clauseBOperator =
+      static_cast<logicOperator>(nextRandom(seed) % (Op_Stopped + 1));
+  block.clauseBThreshold = nextRandom(seed) % 4U;
+  block.combiner = static_cast<combineMode>(nextRandom(seed) % 3);
+  return block;
+}
+
+void buildRandomConfig(uint32_t seed, V3CardConfig* cards) {
+  const cardMode doModes[] = {Mode_DO_Normal, Mode_DO_Immediate, Mode_DO_Gated};
+  for (uint8_t i = 0; i < kCards; ++i) {
+    V3CardConfig& card = cards[i];
+    card = {};
+    card.cardId = i;
+    if (i < kDoStart) {
+      card.family = V3CardFamily::DI;
+      card.di.channel = i;
+      card.di.debounceTimeMs = nextRandom(seed) % 3U * 10U;
+      card.di.edgeMode = static_cast<cardMode>(Mode_DI_Rising + i % 3);
+      card.di.set = randomBlock(seed);
+      card.di.reset = randomBlock(seed);
+    } else if (i < kAiStart) {
+      card.family = V3CardFamily::DO;
+      card.dout.channel = static_cast<uint8_t>(i - kDoStart);
+      card.dout.mode = doModes[nextRandom(seed) % 3];
+      card.dout.delayBeforeOnMs = nextRandom(seed) % 3U * 10U;
+      card.dout.onDurationMs = nextRandom(seed) % 3U * 10U;
+      card.dout.repeatCount = nextRandom(seed) % 3U;
+      card.dout.set = randomBlock(seed);
+      card.dout.reset = randomBlock(seed);
+    } else if (i < kSioStart) {
+      card.family = V3CardFamily::AI;
+      card.ai.inputMax = 4095;
+      card.ai.outputMax = 100;
+      card.ai.emaAlphaX100 = 50;
+    } else if (i < kMathStart) {
+      card.family = V3CardFamily::SIO;
+      card.sio.mode = doModes[nextRandom(seed) % 3];
+      card.sio.delayBeforeOnMs = nextRandom(seed) % 3U * 10U;
+      card.sio.onDurationMs = nextRandom(seed) % 3U * 10U;
+      card.sio.repeatCount = nextRandom(seed) % 3U;
+      card.sio.set = randomBlock(seed);
+      card.sio.reset = randomBlock(seed);
+    } else if (i < kRtcStart) {
+      card.family = V3CardFamily::MATH;
+      card.math.inputA = nextRandom(seed) % 4U;
+      card.math.inputB = 1;
+      card.math.clampMax = 3;
+      card.math.fallbackValue = 2;
+      card.math.set = randomBlock(seed);
+      card.math.reset = randomBlock(seed);
+    } else {
+      card.family = V3CardFamily::RTC;
+      card.rtc.triggerDurationMs = 40;
+    }
+  }
+}
+
+void initEngine(TestEngine& engine, const V3CardConfig* cards) {
+  memset(&engine, 0, sizeof(engine));
+  engine.store = {engine.di,  2, engine.dOut, 3, engine.ai,  1,
+                  engine.sio, 4, engine.math, 2, engine.rtc, 1};
+  const V3CardLayout layout = {kCards,    kDoStart,   kAiStart,
+                               kSioStart, kMathStart, kRtcStart};
+  refreshRuntimeCardMetaFromTypedCards(cards, kCards, layout, engine.meta);
+  const V3ScanPlanPins pins = {};
+  compileV3ScanPlan(cards, engine.meta, kCards, engine.store, pins,
+                    engine.plan);
+  engine.index = {engine.offsets, engine.dependents, 0};
+  buildV3DependencyIndex(engine.plan, kCards, engine.index);
+  engine.signals = makeV3SignalStoreView(engine.signalStorage, kCards);
+  refreshRuntimeSignalsFromRuntime(engine.meta, engine.store, engine.signals);
+  engine.timers = {engine.timerHeap, engine.timerPosition, engine.timerDueMs,
+                   0, kCards};
+  clearV3TimerIndex(engine.timers);
+  for (uint8_t i = 0; i < kCards; ++i) engine.dirty[i] = true;
+}
+
+void evaluateCard(TestEngine& engine, uint8_t cardId, uint32_t nowMs,
+                  const bool* samples) {
+  const V3ScanPlanEntry& entry = engine.plan[cardId];
+  const bool setCondition = evalV3ConditionProgram(entry.set, engine.signals);
+  const bool resetCondition =
+      evalV3ConditionProgram(entry.reset, engine.signals);
+  switch (entry.family) {
+    case V3CardFamily::DI: {
+      V3DiStepInput in = {nowMs, samples[cardId], setCondition, resetCondition,
+                          engine.prevSample[cardId], engine.prevPrimed[cardId]};
+      V3DiStepOutput out = {};
+      runV3DiStep(entry.config.di, *entry.runtime.di, in, out);
+      engine.prevSample[cardId] = out.nextPrevSample;
+      engine.prevPrimed[cardId] = out.nextPrevSampleValid;
+      break;
+    }
+    case V3CardFamily::DO: {
+      V3DoStepInput in = {nowMs, setCondition, resetCondition};
+      V3DoStepOutput out = {};
+      runV3DoStep(entry.config.dOut, *entry.runtime.dOut, in, out);
+      break;
+    }
+    case V3CardFamily::AI: {
+      // AI has no condition inputs; sample into currentValue directly.
+      entry.runtime.ai->currentValue = samples[cardId] ? 100U : 0U;
+      break;
+    }
+    case V3CardFamily::SIO: {
+      V3SioStepInput in = {nowMs, setCondition, resetCondition};
+      V3SioStepOutput out = {};
+      runV3SioStep(entry.config.sio, *entry.runtime.sio, in, out);
+      break;
+    }
+    case V3CardFamily::MATH: {
+      V3MathStepInput in = {setCondition, resetCondition};
+      V3MathStepOutput out = {};
+      runV3MathStep(entry.config.math, *entry.runtime.math, in, out);
+      break;
+    }
+    case V3CardFamily::RTC: {
+      V3RtcStepInput in = {nowMs};
+      runV3RtcStep(entry.config.rtc, *entry.runtime.rtc, in);
+      break;
+    }
+    default:
+      break;
+  }
+  engine.evaluated += 1;
+}
+
+void runScan(TestEngine& engine, uint32_t nowMs, const bool* samples,
+             bool incremental) {
+  if (incremental) {
+    for (uint8_t cardId = 0; cardId < kCards; ++cardId) {
+      if (samples[cardId] == engine.lastSample[cardId]) continue;
+      engine.lastSample[cardId] = samples[cardId];
+      engine.dirty[cardId] = true;
+    }
+    uint8_t dueCard = 0;
+    while (popV3DueTimer(engine.timers, nowMs, dueCard)) {
+      engine.dirty[dueCard] = true;
+    }
+  }
+  for (uint8_t cardId = 0; cardId < kCards; ++cardId) {
+    if (incremental && !engine.dirty[cardId]) continue;
+    engine.dirty[cardId] = false;
+    evaluateCard(engine, cardId, nowMs, samples);
+    if (refreshRuntimeSignalAt(engine.meta, engine.store, engine.signals,
+                               cardId)) {
+      markV3SignalChanged(engine.index, cardId, engine.dirty);
+    }
+    uint32_t dueMs = 0;
+    if (v3ScanPlanEntryNextDeadline(engine.plan[cardId], nowMs, dueMs)) {
+      setV3TimerDue(engine.timers, cardId, dueMs);
+    } else {
+      removeV3Timer(engine.timers, cardId);
+    }
+  }
+}
+
+void assertSameSignals(const TestEngine& a, const TestEngine& b) {
+  for (uint8_t i = 0; i < kCards; ++i) {
+    const V3RuntimeSignal sa = v3SignalAt(a.signals, a.meta[i].type, i);
+    const V3RuntimeSignal sb = v3SignalAt(b.signals, b.meta[i].type, i);
+    TEST_ASSERT_EQUAL(sa.state, sb.state);
+    TEST_ASSERT_EQUAL(sa.logicalState, sb.logicalState);
+    TEST_ASSERT_EQUAL(sa.physicalState, sb.physicalState);
+    TEST_ASSERT_EQUAL(sa.triggerFlag, sb.triggerFlag);
+    TEST_ASSERT_EQUAL_UINT32(sa.currentValue, sb.currentValue);
+  }
+}
+}  // namespace
+
+void test_dependency_index_lists_readers_per_source() {
+  V3ScanPlanEntry plan[3] = {};
+  for (uint8_t i = 0; i < 3; ++i) plan[i].cardId = i;
+  plan[0].set.a = {2, CondOp_Logical, 0, 0, 0};
+  plan[0].reset.a = {2, CondOp_GT, 0, 0, 5};
+  plan[1].set.a = {0, CondOp_Triggered, 0, 0, 0};
+  plan[1].set.b = {2, CondOp_Physical, 0, 0, 0};
+  plan[2].set.a = {1, CondOp_False, 0, 0, 0};
+
+  uint16_t offsets[4] = {};
+  uint8_t dependents[3 * kV3MaxSourcesPerCard] = {};
+  V3DependencyIndexView index = {offsets, dependents, 0};
+  buildV3DependencyIndex(plan, 3, index);
+
+  TEST_ASSERT_EQUAL_UINT16(0, offsets[0]);
+  TEST_ASSERT_EQUAL_UINT16(1, offsets[1]);
+  TEST_ASSERT_EQUAL_UINT16(1, offsets[2]);
+  TEST_ASSERT_EQUAL_UINT16(3, offsets[3]);
+  TEST_ASSERT_EQUAL_UINT8(1, dependents[0]);
+  TEST_ASSERT_EQUAL_UINT8(0, dependents[1]);
+  TEST_ASSERT_EQUAL_UINT8(1, dependents[2]);
+
+  bool dirty[3] = {};
+  markV3SignalChanged(index, 2, dirty);
+  TEST_ASSERT_TRUE(dirty[0]);
+  TEST_ASSERT_TRUE(dirty[1]);
+  TEST_ASSERT_TRUE(dirty[2]);
+}
+
+void test_next_deadline_tracks_mission_and_rtc_timers() {
+  V3DoRuntimeState dOut = {};
+  V3ScanPlanEntry entry = {};
+  entry.family = V3CardFamily::DO;
+  entry.runtime.dOut = &dOut;
+  entry.config.dOut.delayBeforeOnMs = 30;
+  entry.config.dOut.onDurationMs = 50;
+  uint32_t dueMs = 0;
+  dOut.state = State_DO_Idle;
+  TEST_ASSERT_FALSE(v3ScanPlanEntryNextDeadline(entry, 100, dueMs));
+  dOut.state = State_DO_OnDelay;
+  dOut.startOnMs = 90;
+  TEST_ASSERT_TRUE(v3ScanPlanEntryNextDeadline(entry, 100, dueMs));
+  TEST_ASSERT_EQUAL_UINT32(120, dueMs);
+  dOut.state = State_DO_Active;
+  dOut.startOffMs = 0xFFFFFFF0UL;
+  TEST_ASSERT_TRUE(v3ScanPlanEntryNextDeadline(entry, 0x10, dueMs));
+  TEST_ASSERT_EQUAL_UINT32(0x22, dueMs);
+
+  V3RtcRuntimeState rtc = {};
+  entry.family = V3CardFamily::RTC;
+  entry.runtime.rtc = &rtc;
+  entry.config.rtc.triggerDurationMs = 1000;
+  TEST_ASSERT_FALSE(v3ScanPlanEntryNextDeadline(entry, 5, dueMs));
+  rtc.logicalState = true;
+  rtc.triggerStartMs = 5;
+  TEST_ASSERT_TRUE(v3ScanPlanEntryNextDeadline(entry, 7, dueMs));
+  TEST_ASSERT_EQUAL_UINT32(1005, dueMs);
+
+  V3DiRuntimeState di = {};
+  entry.family = V3CardFamily::DI;
+  entry.runtime.di = &di;
+  TEST_ASSERT_FALSE(v3ScanPlanEntryNextDeadline(entry, 7, dueMs));
+  entry.runtime.any = nullptr;
+  TEST_ASSERT_FALSE(v3ScanPlanEntryNextDeadline(entry, 7, dueMs));
+}
+
+void test_incremental_scan_matches_full_scan() {
+  static TestEngine full;
+  static TestEngine incremental;
+  uint32_t skipped = 0;
+  for (uint32_t seed = 1; seed <= 64; ++seed) {
+    V3CardConfig cards[kCards] = {};
+    buildRandomConfig(seed, cards);
+    initEngine(full, cards);
+    initEngine(incremental, cards);
+
+    uint32_t inputSeed = seed * 7919U;
+    bool samples[kCards] = {};
+    uint32_t nowMs = 0;
+    for (uint16_t scan = 0; scan < 400; ++scan) {
+      nowMs += 5;
+      if (nextRandom(inputSeed) % 8U == 0) {
+        const uint8_t target = static_cast<uint8_t>(nextRandom(inputSeed) % 6U);
+        if (target < kDoStart || target == kAiStart) {
+          samples[target] = !samples[target];
+        } else if (target == 2) {
+          // RTC intent arrives via kernel command: mark all dirty.
+          const bool state = !full.rtc[0].logicalState;
+          TestEngine* engines[] = {&full, &incremental};
+          for (TestEngine* engine : engines) {
+            engine->rtc[0].logicalState = state;
+            engine->rtc[0].triggerStartMs = nowMs;
+            refreshRuntimeSignalAt(engine->meta, engine->store, engine->signals,
+                                   kRtcStart);
+            for (uint8_t i = 0; i < kCards; ++i) engine->dirty[i] = true;
+          }
+        }
+      }
+      runScan(full, nowMs, samples, false);
+      runScan(incremental, nowMs, samples, true);
+      assertSameSignals(full, incremental);
+    }
+    skipped += full.evaluated - incremental.evaluated;
+  }
+  TEST_ASSERT_TRUE(skipped > 0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_dependency_index_lists_readers_per_source);
+  RUN_TEST(test_next_deadline_tracks_mission_and_rtc_timers);
+  RUN_TEST(test_incremental_scan_matches_full_scan);
+  return UNITY_END();
+}
@@ -0,0 +1,56 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_io_image.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+void test_input_image_reads_low_and_high_banks() {
+  V3InputImage image = {};
+  image.levels = (1ULL << 13) | (1ULL << 35);
+  TEST_ASSERT_TRUE(v3InputImageLevel(image, 13));
+  TEST_ASSERT_FALSE(v3InputImageLevel(image, 12));
+  TEST_ASSERT_TRUE(v3InputImageLevel(image, 35));
+  TEST_ASSERT_FALSE(v3InputImageLevel(image, 255));
+}
+
+void test_latch_covers_only_driven_pins() {
+  V3OutputImage image = {};
+  writeV3OutputImage(image, 26, true);
+  writeV3OutputImage(image, 33, true);
+  writeV3OutputImage(image, 25, false);
+
+  uint64_t setMask = 0;
+  uint64_t clearMask = 0;
+  takeV3OutputLatch(image, setMask, clearMask);
+  TEST_ASSERT_TRUE(setMask == ((1ULL << 26) | (1ULL << 33)));
+  TEST_ASSERT_TRUE(clearMask == (1ULL << 25));
+
+  // Undriven pins keep their staged level but are not re-latched.
+  writeV3OutputImage(image, 33, false);
+  takeV3OutputLatch(image, setMask, clearMask);
+  TEST_ASSERT_TRUE(setMask == 0);
+  TEST_ASSERT_TRUE(clearMask == (1ULL << 33));
+  TEST_ASSERT_TRUE((image.levels & (1ULL << 26)) != 0);
+}
+
+void test_last_write_in_scan_wins() {
+  V3OutputImage image = {};
+  writeV3OutputImage(image, 32, true);
+  writeV3OutputImage(image, 32, false);
+  writeV3OutputImage(image, kV3IoImagePins, true);
+
+  uint64_t setMask = 0;
+  uint64_t clearMask = 0;
+  takeV3OutputLatch(image, setMask, clearMask);
+  TEST_ASSERT_TRUE(setMask == 0);
+  TEST_ASSERT_TRUE(clearMask == (1ULL << 32));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_input_image_reads_low_and_high_banks);
+  RUN_TEST(test_latch_covers_only_driven_pins);
+  RUN_TEST(test_last_write_in_scan_wins);
+  return UNITY_END();
+}
@@ -0,0 +1,208 @@
+#include <unity.h>
+
+#include <stdio.h>
+
+#include "../../src/portal/json_arena.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+// A command request holds two documents of one pool each plus strings and
+// the body, sized from the library's real pool size.
+constexpr size_t kArenaBytes = jsonArenaBytesFor(2, 1024);
+alignas(8) uint8_t gBuffer[kArenaBytes];
+
+// Full config upload: every card an object with a nested condition block,
+// enough members to span several variant pools.
+constexpr size_t kConfigCards = 48;
+constexpr size_t kConfigArenaPools = 16;
+constexpr size_t kConfigArenaBytes = jsonArenaBytesFor(kConfigArenaPools, 4096);
+alignas(8) uint8_t gConfigBuffer[kConfigArenaBytes];
+
+void addConfigCard(JsonArray cards, uint8_t id) {
+  JsonObject card = cards.add<JsonObject>();
+  card["cardId"] = id;
+  card["cardType"] = "DO";
+  card["enabled"] = true;
+  card["faultPolicy"] = "WARN";
+  JsonObject cfg = card["config"].to<JsonObject>();
+  cfg["channel"] = id % 4;
+  cfg["mode"] = "Normal";
+  cfg["delayBeforeON"] = 100 + id;
+  cfg["onDuration"] = 500 + id;
+  cfg["repeatCount"] = 1;
+  JsonObject set = cfg["set"].to<JsonObject>();
+  set["combiner"] = "NONE";
+  JsonObject clause = set["clauseA"].to<JsonObject>();
+  JsonObject source = clause["source"].to<JsonObject>();
+  source["cardId"] = id;
+  source["field"] = "currentValue";
+  source["type"] = "NUMBER";
+  clause["operator"] = "GTE";
+  clause["threshold"] = id;
+}
+
+// One portal request as the handlers run it: parse a command, build the
+// result and serialize the body into the arena.
+size_t runCommandRequest(JsonArena& arena, uint32_t n) {
+  JsonArenaScope scope(arena);
+  char request[160];
+  snprintf(request, sizeof(request),
+           "{\"type\":\"command\",\"schemaVersion\":1,"
+           "\"requestId\":\"req-%lu\",\"name\":\"set_run_mode\","
+           "\"payload\":{\"mode\":\"RUN_NORMAL\"}}",
+           static_cast<unsigned long>(n));
+  JsonDocument doc(&arena);
+  if (deserializeJson(doc, request)) return 0;
+
+  JsonDocument result(&arena);
+  result["type"] = "command_result";
+  result["schemaVersion"] = 1;
+  result["requestId"] = doc["requestId"] | "";
+  result["ok"] = true;
+  result["error"] = nullptr;
+  char* body = nullptr;
+  const size_t size = serializeJsonToArena(result, arena, body);
+  arena.deallocate(body);
+  return size;
+}
+}  // namespace
+
+void test_newest_block_resizes_and_frees_in_place() {
+  JsonArena arena(gBuffer, kArenaBytes);
+  JsonArenaScope scope(arena);
+  void* pool = arena.allocate(100);
+  char* text = static_cast<char*>(arena.allocate(31));
+  memcpy(text, "abc", 4);
+  const uint32_t usedBefore = arena.stats().used;
+
+  TEST_ASSERT_TRUE(arena.reallocate(text, 120) == text);
+  TEST_ASSERT_TRUE(arena.reallocate(text, 4) == text);
+  TEST_ASSERT_EQUAL_STRING("abc", text);
+  TEST_ASSERT_TRUE(arena.stats().used < usedBefore);
+
+  // Growing an older block moves it; freeing the newest pops it.
+  char* moved = static_cast<char*>(arena.reallocate(pool, 200));
+  TEST_ASSERT_TRUE(moved != pool);
+  const uint32_t usedWithMove = arena.stats().used;
+  arena.deallocate(moved);
+  TEST_ASSERT_TRUE(arena.stats().used < usedWithMove);
+  TEST_ASSERT_EQUAL_UINT32(0, arena.stats().heapFallbacks);
+}
+
+void test_oversized_allocation_falls_back_to_heap() {
+  JsonArena arena(gBuffer, kArenaBytes);
+  JsonArenaScope scope(arena);
+  void* big = arena.allocate(kArenaBytes * 2);
+  TEST_ASSERT_NOT_NULL(big);
+  TEST_ASSERT_EQUAL_UINT32(1, arena.stats().heapFallbacks);
+  TEST_ASSERT_EQUAL_UINT32(kArenaBytes * 2, arena.stats().heapBytesLive);
+  TEST_ASSERT_EQUAL_UINT32(0, arena.stats().used);
+
+  // A newest arena block that outgrows the arena moves to the heap too.
+  char* text = static_cast<char*>(arena.allocate(64));
+  memcpy(text, "kept", 5);
+  char* grown = static_cast<char*>(arena.reallocate(text, kArenaBytes));
+  TEST_ASSERT_EQUAL_STRING("kept", grown);
+  TEST_ASSERT_EQUAL_UINT32(2, arena.stats().heapFallbacks);
+
+  arena.deallocate(grown);
+  arena.deallocate(big);
+  TEST_ASSERT_EQUAL_UINT32(0, arena.stats().heapBytesLive);
+}
+
+void test_only_outermost_scope_resets() {
+  JsonArena arena(gBuffer, kArenaBytes);
+  {
+    JsonArenaScope outer(arena);
+    arena.allocate(64);
+    {
+      JsonArenaScope inner(arena);
+      arena.allocate(64);
+    }
+    TEST_ASSERT_TRUE(arena.stats().used >= 128);
+    TEST_ASSERT_EQUAL_UINT32(0, arena.stats().requests);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, arena.stats().used);
+  TEST_ASSERT_EQUAL_UINT32(1, arena.stats().requests);
+}
+
+void test_many_pool_document_stays_in_arena() {
+  JsonArena arena(gConfigBuffer, kConfigArenaBytes);
+  char* body = nullptr;
+  size_t bodySize = 0;
+  {
+    JsonArenaScope scope(arena);
+    JsonDocument doc(&arena);
+    JsonArray cards = doc["cards"].to<JsonArray>();
+    for (uint8_t id = 0; id < kConfigCards; ++id) addConfigCard(cards, id);
+    bodySize = serializeJsonToArena(doc, arena, body);
+    TEST_ASSERT_TRUE(bodySize > 0);
+    TEST_ASSERT_EQUAL_UINT32(kConfigCards, doc["cards"].size());
+    arena.deallocate(body);
+  }
+  const JsonArenaStats& stats = arena.stats();
+  printf("json_arena config_cards=%u pool_bytes=%u high_water=%u capacity=%u\n",
+         static_cast<unsigned>(kConfigCards),
+         static_cast<unsigned>(kJsonPoolBytes),
+         static_cast<unsigned>(stats.highWater),
+         static_cast<unsigned>(stats.capacity));
+  // More pools than the inline pool list holds, all of them in the arena.
+  TEST_ASSERT_TRUE(stats.highWater >
+                   jsonArenaBytesFor(ARDUINOJSON_INITIAL_POOL_COUNT, 0));
+  TEST_ASSERT_TRUE(stats.highWater <= kConfigArenaBytes);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.heapFallbacks);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.heapBytesLive);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.used);
+}
+
+void test_config_larger_than_arena_spills_to_heap() {
+  JsonArena arena(gBuffer, kArenaBytes);
+  {
+    JsonArenaScope scope(arena);
+    JsonDocument doc(&arena);
+    JsonArray cards = doc["cards"].to<JsonArray>();
+    for (uint8_t id = 0; id < kConfigCards; ++id) addConfigCard(cards, id);
+    char* body = nullptr;
+    TEST_ASSERT_TRUE(serializeJsonToArena(doc, arena, body) > 0);
+    TEST_ASSERT_TRUE(arena.stats().heapFallbacks > 0);
+    TEST_ASSERT_TRUE(arena.stats().heapBytesLive > 0);
+    arena.deallocate(body);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, arena.stats().heapBytesLive);
+  TEST_ASSERT_TRUE(arena.stats().highWater <= kArenaBytes);
+}
+
+void test_soak_memory_stays_flat_across_requests() {
+  constexpr uint32_t kRequests = 100000;
+  JsonArena arena(gBuffer, kArenaBytes);
+  TEST_ASSERT_TRUE(runCommandRequest(arena, 0) > 0);
+  const uint32_t highWater = arena.stats().highWater;
+  TEST_ASSERT_TRUE(highWater > 0);
+
+  uint32_t failed = 0;
+  uint32_t leaked = 0;
+  for (uint32_t n = 1; n < kRequests; ++n) {
+    if (runCommandRequest(arena, n) == 0) failed += 1;
+    if (arena.stats().used != 0) leaked += 1;
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, failed);
+  TEST_ASSERT_EQUAL_UINT32(0, leaked);
+  TEST_ASSERT_EQUAL_UINT32(kRequests, arena.stats().requests);
+  // Request ids grow from 1 to 5 digits; allow for that, nothing more.
+  TEST_ASSERT_TRUE(arena.stats().highWater <= highWater + 32);
+  TEST_ASSERT_EQUAL_UINT32(0, arena.stats().heapFallbacks);
+  TEST_ASSERT_EQUAL_UINT32(0, arena.stats().heapBytesLive);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_newest_block_resizes_and_frees_in_place);
+  RUN_TEST(test_oversized_allocation_falls_back_to_heap);
+  RUN_TEST(test_only_outermost_scope_resets);
+  RUN_TEST(test_many_pool_document_stays_in_arena);
+  RUN_TEST(test_config_larger_than_arena_spills_to_heap);
+  RUN_TEST(test_soak_memory_stays_flat_across_requests);
+  return UNITY_END();
+}
@@ -0,0 +1,48 @@
+#include <unity.h>
+
+#include "../../src/runtime/latency_histogram.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+void test_bucket_bounds_are_contiguous_and_contain_values() {
+  uint32_t expectedLower = 0;
+  for (uint8_t i = 0; i < kLatencyHistogramBuckets; ++i) {
+    const uint32_t upper = latencyHistogramBucketUpperUs(i);
+    TEST_ASSERT_EQUAL_UINT8(i, latencyHistogramBucketFor(expectedLower));
+    TEST_ASSERT_EQUAL_UINT8(i, latencyHistogramBucketFor(upper));
+    expectedLower = upper + 1;
+  }
+  TEST_ASSERT_EQUAL_UINT8(kLatencyHistogramBuckets - 1,
+                          latencyHistogramBucketFor(0xFFFFFFFFUL));
+}
+
+void test_quantiles_track_distribution() {
+  LatencyHistogram histogram = {};
+  resetLatencyHistogram(histogram);
+  for (uint32_t i = 0; i < 990; ++i) recordLatencySample(histogram, 10);
+  for (uint32_t i = 0; i < 9; ++i) recordLatencySample(histogram, 1000);
+  recordLatencySample(histogram, 50000);
+
+  TEST_ASSERT_EQUAL_UINT32(1000, histogram.total);
+  TEST_ASSERT_EQUAL_UINT32(10, latencyHistogramQuantileUs(histogram, 5000));
+  TEST_ASSERT_EQUAL_UINT32(10, latencyHistogramQuantileUs(histogram, 9900));
+  const uint32_t p999 = latencyHistogramQuantileUs(histogram, 9990);
+  TEST_ASSERT_TRUE(p999 >= 1000 && p999 <= 1125);
+  TEST_ASSERT_EQUAL_UINT32(50000, latencyHistogramQuantileUs(histogram, 10000));
+  TEST_ASSERT_EQUAL_UINT32(50000, histogram.maxUs);
+}
+
+void test_empty_histogram_reports_zero() {
+  LatencyHistogram histogram = {};
+  resetLatencyHistogram(histogram);
+  TEST_ASSERT_EQUAL_UINT32(0, latencyHistogramQuantileUs(histogram, 9900));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bucket_bounds_are_contiguous_and_contain_values);
+  RUN_TEST(test_quantiles_track_distribution);
+  RUN_TEST(test_empty_histogram_reports_zero);
+  return UNITY_END();
+}
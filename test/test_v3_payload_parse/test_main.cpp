@@ -14,6 +14,8 @@ constexpr uint8_t kSioStart = 10;
 constexpr uint8_t kMathStart = 14;
 constexpr uint8_t kRtcStart = 16;
 constexpr uint8_t kTotalCards = 18;
+constexpr V3CardLayout kLayout = {kTotalCards, kDoStart,   kAiStart,
+                                  kSioStart,   kMathStart, kRtcStart};
 
 void addBareCards(JsonArray& cards) {
   for (uint8_t id = 0; id < kTotalCards; ++id) {
@@ -70,9 +72,7 @@ void test_payload_rejects_ai_logical_state() {
   writeBlockNumeric(cfg, 8, "logicalState", "EQ", 1);
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -84,9 +84,7 @@ void test_payload_rejects_rtc_mission_state() {
   writeBlockState(cfg, 16, "missionState", "EQ", "ACTIVE");
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -98,9 +96,7 @@ void test_payload_rejects_mission_state_neq() {
   writeBlockState(cfg, 4, "missionState", "NEQ", "ACTIVE");
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -112,9 +108,7 @@ void test_payload_accepts_do_mission_state_eq() {
   writeBlockState(cfg, 4, "missionState", "EQ", "ACTIVE");
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_TRUE(ok);
 }
 
@@ -125,9 +119,7 @@ void test_payload_rejects_duplicate_card_id() {
   cards[5]["cardId"] = 4;
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -138,9 +130,7 @@ void test_payload_rejects_card_type_slot_mismatch() {
   cards[8]["cardType"] = "DO";  // id=8 is AI slot in this profile layout.
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -161,9 +151,7 @@ void test_payload_rejects_clause_source_card_id_out_of_range() {
   clauseA["threshold"] = 1;
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -175,9 +163,7 @@ void test_payload_rejects_invalid_mission_state_threshold() {
   writeBlockState(cfg, 4, "missionState", "EQ", "PAUSED");
 
   std::string reason;
-  bool ok = validateV3PayloadConditionSources(cards, kTotalCards, kDoStart,
-                                              kAiStart, kSioStart, kMathStart,
-                                              kRtcStart, reason);
+  bool ok = validateV3PayloadConditionSources(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -75,6 +75,24 @@ void test_rtc_step_auto_clears_after_trigger_window() {
   TEST_ASSERT_EQUAL_UINT32(0, runtime.currentValue);
 }
 
+void test_rtc_apply_card_state_opens_and_clears_trigger_window() {
+  V3RtcRuntimeState runtime = {};
+
+  applyV3RtcCardState(runtime, true, 5000);
+  TEST_ASSERT_TRUE(runtime.logicalState);
+  TEST_ASSERT_TRUE(runtime.physicalState);
+  TEST_ASSERT_TRUE(runtime.triggerFlag);
+  TEST_ASSERT_EQUAL_UINT32(1, runtime.currentValue);
+  TEST_ASSERT_EQUAL_UINT32(5000, runtime.triggerStartMs);
+
+  applyV3RtcCardState(runtime, false, 65000);
+  TEST_ASSERT_FALSE(runtime.logicalState);
+  TEST_ASSERT_FALSE(runtime.physicalState);
+  TEST_ASSERT_FALSE(runtime.triggerFlag);
+  TEST_ASSERT_EQUAL_UINT32(0, runtime.currentValue);
+  TEST_ASSERT_EQUAL_UINT32(0, runtime.triggerStartMs);
+}
+
 void test_rtc_channel_matches_minute_with_wildcards() {
   V3RtcScheduleView channel = {};
   channel.enabled = true;
@@ -119,6 +137,7 @@ int main() {
   RUN_TEST(test_rtc_step_clears_trigger_when_logical_false);
   RUN_TEST(test_rtc_step_holds_true_within_trigger_window);
   RUN_TEST(test_rtc_step_auto_clears_after_trigger_window);
+  RUN_TEST(test_rtc_apply_card_state_opens_and_clears_trigger_window);
   RUN_TEST(test_rtc_channel_matches_minute_with_wildcards);
   RUN_TEST(test_rtc_minute_key_changes_per_minute);
   return UNITY_END();
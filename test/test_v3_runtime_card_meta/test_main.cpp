@@ -21,7 +21,8 @@ void test_refresh_runtime_card_meta_from_typed_cards() {
   cards[2].family = V3CardFamily::RTC;
 
   RuntimeCardMeta out[3] = {};
-  refreshRuntimeCardMetaFromTypedCards(cards, 3, 4, 8, 10, 14, 16, out);
+  const V3CardLayout layout = {18, 4, 8, 10, 14, 16};
+  refreshRuntimeCardMetaFromTypedCards(cards, 3, layout, out);
 
   TEST_ASSERT_EQUAL_UINT8(0, out[0].id);
   TEST_ASSERT_EQUAL(DigitalInput, out[0].type);
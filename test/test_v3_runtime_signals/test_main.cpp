@@ -48,13 +48,13 @@ void test_refresh_runtime_signals_from_runtime() {
   store.math = math;
   store.mathCount = 1;
 
-  V3RuntimeSignal out[2] = {};
-  refreshRuntimeSignalsFromRuntime(cards, store, out, 2);
+  V3SignalStorage<2> storage = {};
+  V3SignalStoreView out = makeV3SignalStoreView(storage, 2);
+  refreshRuntimeSignalsFromRuntime(cards, store, out);
 
-  TEST_ASSERT_EQUAL(DigitalInput, out[0].type);
-  TEST_ASSERT_EQUAL_UINT32(1, out[0].currentValue);
-  TEST_ASSERT_EQUAL(MathCard, out[1].type);
-  TEST_ASSERT_EQUAL_UINT32(9, out[1].currentValue);
+  TEST_ASSERT_EQUAL_UINT32(1, out.currentValue[0]);
+  TEST_ASSERT_EQUAL_UINT32(9, out.currentValue[1]);
+  TEST_ASSERT_EQUAL(MathCard, v3SignalAt(out, cards[1].type, 1).type);
 }
 
 void test_refresh_runtime_signal_at_updates_single_slot() {
@@ -75,14 +75,54 @@ void test_refresh_runtime_signal_at_updates_single_slot() {
   store.rtc = rtc;
   store.rtcCount = 1;
 
-  V3RuntimeSignal out[2] = {};
-  refreshRuntimeSignalsFromRuntime(cards, store, out, 2);
+  V3SignalStorage<2> storage = {};
+  V3SignalStoreView out = makeV3SignalStoreView(storage, 2);
+  refreshRuntimeSignalsFromRuntime(cards, store, out);
+  TEST_ASSERT_FALSE(refreshRuntimeSignalAt(cards, store, out, 1));
   rtc[0].currentValue = 42;
 
-  refreshRuntimeSignalAt(cards, store, out, 2, 1);
+  TEST_ASSERT_TRUE(refreshRuntimeSignalAt(cards, store, out, 1));
 
-  TEST_ASSERT_EQUAL_UINT32(1, out[0].currentValue);
-  TEST_ASSERT_EQUAL_UINT32(42, out[1].currentValue);
+  TEST_ASSERT_EQUAL_UINT32(1, out.currentValue[0]);
+  TEST_ASSERT_EQUAL_UINT32(42, out.currentValue[1]);
+}
+
+void test_signal_store_packs_flags_per_card_across_words() {
+  V3SignalStorage<40> storage = {};
+  V3SignalStoreView signals = makeV3SignalStoreView(storage, 40);
+  TEST_ASSERT_EQUAL_UINT16(2, v3SignalWordCount(40));
+
+  V3RuntimeSignal on = {};
+  on.state = State_DO_Active;
+  on.logicalState = true;
+  on.triggerFlag = true;
+  on.currentValue = 7;
+  TEST_ASSERT_TRUE(writeV3Signal(signals, 33, on));
+  TEST_ASSERT_FALSE(writeV3Signal(signals, 33, on));
+  recordV3ConditionResults(signals, 31, true, false, true);
+
+  TEST_ASSERT_EQUAL_HEX32(0x2, storage.logical[1]);
+  TEST_ASSERT_EQUAL_HEX32(0x0, storage.physical[1]);
+  TEST_ASSERT_EQUAL_HEX32(0x80000000UL, storage.setResult[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x80000000UL, storage.resetOverride[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x0, storage.resetResult[0]);
+
+  V3RuntimeSignal read = v3SignalAt(signals, DigitalOutput, 33);
+  TEST_ASSERT_EQUAL(State_DO_Active, read.state);
+  TEST_ASSERT_TRUE(read.logicalState);
+  TEST_ASSERT_FALSE(read.physicalState);
+  TEST_ASSERT_TRUE(read.triggerFlag);
+  TEST_ASSERT_EQUAL_UINT32(7, read.currentValue);
+
+  V3SignalStorage<40> copy = {};
+  V3SignalStoreView published = makeV3SignalStoreView(copy, 40);
+  copyV3SignalStore(signals, published);
+  TEST_ASSERT_TRUE(v3SignalBit(copy.trigger, 33));
+  TEST_ASSERT_EQUAL_UINT32(7, copy.currentValue[33]);
+
+  on.logicalState = false;
+  TEST_ASSERT_TRUE(writeV3Signal(signals, 33, on));
+  TEST_ASSERT_EQUAL_HEX32(0x0, storage.logical[1]);
 }
 
 int main() {
@@ -90,5 +130,6 @@ int main() {
   RUN_TEST(test_make_runtime_signal_reads_store_from_meta);
   RUN_TEST(test_refresh_runtime_signals_from_runtime);
   RUN_TEST(test_refresh_runtime_signal_at_updates_single_slot);
+  RUN_TEST(test_signal_store_packs_flags_per_card_across_words);
   return UNITY_END();
 }
@@ -0,0 +1,257 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "../../src/kernel/v3_ai_runtime.cpp"
+#include "../../src/kernel/v3_card_profile.cpp"
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_di_runtime.cpp"
+#include "../../src/kernel/v3_do_runtime.cpp"
+#include "../../src/kernel/v3_incremental_scan.cpp"
+#include "../../src/kernel/v3_io_image.cpp"
+#include "../../src/kernel/v3_math_runtime.cpp"
+#include "../../src/kernel/v3_rtc_runtime.cpp"
+#include "../../src/kernel/v3_runtime_adapters.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/kernel/v3_runtime_store.cpp"
+#include "../../src/kernel/v3_scan_engine.cpp"
+#include "../../src/kernel/v3_scan_plan.cpp"
+#include "../../src/kernel/v3_sio_runtime.cpp"
+#include "../../src/kernel/v3_timer_index.cpp"
+#include "../../src/platform/memory_io_backend.cpp"
+#include "../../src/runtime/runtime_card_meta.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+// Card 0: DI on pin 13. Card 1: DO on pin 26 pulsing 50 ms on DI physical.
+// Card 2: DO on pin 33 gated while AI > 100. Card 3: AI on pin 35.
+constexpr uint8_t kCards = 4;
+constexpr uint8_t kDiPin = 13;
+constexpr uint8_t kDoPin = 26;
+constexpr uint8_t kAiPin = 35;
+constexpr uint8_t kDo2Pin = 33;
+
+struct TestRig {
+  V3DiRuntimeState di[1];
+  V3DoRuntimeState dOut[2];
+  V3AiRuntimeState ai[1];
+  RuntimeCardMeta meta[kCards];
+  V3ScanPlanEntry plan[kCards];
+  V3SignalStorage<kCards> signals;
+  uint16_t offsets[kCards + 1];
+  uint8_t dependents[kCards * kV3MaxSourcesPerCard];
+  uint8_t timerHeap[kCards];
+  uint8_t timerPosition[kCards];
+  uint32_t timerDueMs[kCards];
+  bool dirty[kCards];
+  uint32_t inputSample[kCards];
+  bool prevDISample[kCards];
+  bool prevDIPrimed[kCards];
+  inputSourceMode inputSource[kCards];
+  uint32_t forcedAIValue[kCards];
+  bool outputMask[kCards];
+  bool globalOutputMask;
+  MemoryIoBackendState io;
+  V3ScanEngine engine;
+};
+
+V3ConditionBlock clause(uint8_t id, logicOperator op, uint32_t threshold) {
+  V3ConditionBlock block = {};
+  block.clauseAId = id;
+  block.clauseAOperator = op;
+  block.clauseAThreshold = threshold;
+  block.combiner = Combine_None;
+  return block;
+}
+
+void initRig(TestRig& rig) {
+  memset(&rig, 0, sizeof(rig));
+  V3CardConfig cards[kCards] = {};
+  cards[0].cardId = 0;
+  cards[0].family = V3CardFamily::DI;
+  cards[0].di.channel = 0;
+  cards[0].di.edgeMode = Mode_DI_Rising;
+  cards[0].di.set = clause(0, Op_AlwaysTrue, 0);
+  cards[0].di.reset = clause(0, Op_AlwaysFalse, 0);
+  cards[1].cardId = 1;
+  cards[1].family = V3CardFamily::DO;
+  cards[1].dout.channel = 0;
+  cards[1].dout.mode = Mode_DO_Immediate;
+  cards[1].dout.onDurationMs = 50;
+  cards[1].dout.repeatCount = 1;
+  cards[1].dout.set = clause(0, Op_PhysicalOn, 0);
+  cards[1].dout.reset = clause(0, Op_AlwaysFalse, 0);
+  cards[2].cardId = 2;
+  cards[2].family = V3CardFamily::DO;
+  cards[2].dout.channel = 1;
+  cards[2].dout.mode = Mode_DO_Gated;
+  cards[2].dout.delayBeforeOnMs = 1;
+  cards[2].dout.set = clause(3, Op_GT, 100);
+  cards[2].dout.reset = clause(0, Op_AlwaysFalse, 0);
+  cards[3].cardId = 3;
+  cards[3].family = V3CardFamily::AI;
+  cards[3].ai.channel = 0;
+  cards[3].ai.inputMax = 4095;
+  cards[3].ai.outputMax = 4095;
+  cards[3].ai.emaAlphaX100 = 100;
+
+  rig.di[0].state = State_DI_Idle;
+  rig.dOut[0].state = State_DO_Idle;
+  rig.dOut[1].state = State_DO_Idle;
+  V3RuntimeStoreView store = {rig.di, 1, rig.dOut, 2, rig.ai, 1,
+                              nullptr, 0, nullptr, 0, nullptr, 0};
+  const V3CardLayout layout = {kCards, 1, 3, kCards, kCards, kCards};
+  refreshRuntimeCardMetaFromTypedCards(cards, kCards, layout, rig.meta);
+  const uint8_t diPins[] = {kDiPin};
+  const uint8_t doPins[] = {kDoPin, kDo2Pin};
+  const uint8_t aiPins[] = {kAiPin};
+  const V3ScanPlanPins pins = {diPins, 1, doPins, 2, aiPins, 1};
+  compileV3ScanPlan(cards, rig.meta, kCards, store, pins, rig.plan);
+
+  V3ScanEngine& engine = rig.engine;
+  engine.count = kCards;
+  engine.plan = rig.plan;
+  engine.meta = rig.meta;
+  engine.store = store;
+  engine.signals = makeV3SignalStoreView(rig.signals, kCards);
+  engine.dependencies = {rig.offsets, rig.dependents, 0};
+  engine.timers = {rig.timerHeap, rig.timerPosition, rig.timerDueMs, 0,
+                   kCards};
+  engine.dirty = rig.dirty;
+  engine.inputSample = rig.inputSample;
+  engine.prevDISample = rig.prevDISample;
+  engine.prevDIPrimed = rig.prevDIPrimed;
+  engine.inputSource = rig.inputSource;
+  engine.forcedAIValue = rig.forcedAIValue;
+  engine.outputMask = rig.outputMask;
+  engine.globalOutputMask = &rig.globalOutputMask;
+  engine.io = makeMemoryIoBackend(rig.io);
+
+  buildV3DependencyIndex(rig.plan, kCards, engine.dependencies);
+  clearV3TimerIndex(engine.timers);
+  refreshRuntimeSignalsFromRuntime(rig.meta, store, engine.signals);
+  markAllV3ScanCardsDirty(engine);
+}
+
+// Returns true when the scan had work to do.
+bool runScan(TestRig& rig, uint32_t nowMs) {
+  V3ScanEngine& engine = rig.engine;
+  sampleV3ScanInputs(engine);
+  markV3DueTimerCards(engine, nowMs);
+  if (!anyV3ScanCardDirty(engine)) return false;
+  engine.cardsEvaluated = 0;
+  engine.cardsSkipped = 0;
+  for (uint8_t i = 0; i < kCards; ++i) runV3ScanCursorCard(engine, nowMs, false);
+  latchV3ScanOutputs(engine);
+  return true;
+}
+
+// Runs scans until the engine reports no pending work.
+void settle(TestRig& rig, uint32_t nowMs) {
+  for (uint8_t i = 0; i < 8 && runScan(rig, nowMs); ++i) {
+  }
+  TEST_ASSERT_FALSE(anyV3ScanCardDirty(rig.engine));
+}
+
+bool outputHigh(const TestRig& rig, uint8_t pin) {
+  return (rig.io.outputLevels & (1ULL << pin)) != 0;
+}
+}  // namespace
+
+void test_input_edge_drives_output_through_backend() {
+  static TestRig rig;
+  initRig(rig);
+  settle(rig, 0);
+  TEST_ASSERT_FALSE(outputHigh(rig, kDoPin));
+  TEST_ASSERT_FALSE(runScan(rig, 10));
+
+  rig.io.inputLevels = 1ULL << kDiPin;
+  TEST_ASSERT_TRUE(runScan(rig, 20));
+  TEST_ASSERT_TRUE(outputHigh(rig, kDoPin));
+  TEST_ASSERT_EQUAL_UINT32(1, rig.di[0].currentValue);
+
+  // The trigger flag clears on the next pass; after that the pulse stays on
+  // with no work until its on-duration timer expires.
+  settle(rig, 30);
+  TEST_ASSERT_FALSE(runScan(rig, 40));
+  TEST_ASSERT_FALSE(runScan(rig, 69));
+  TEST_ASSERT_TRUE(outputHigh(rig, kDoPin));
+  TEST_ASSERT_TRUE(runScan(rig, 70));
+  TEST_ASSERT_FALSE(outputHigh(rig, kDoPin));
+  TEST_ASSERT_EQUAL(State_DO_Finished, rig.dOut[0].state);
+}
+
+void test_outputs_latch_together_once_per_scan() {
+  static TestRig rig;
+  initRig(rig);
+  settle(rig, 0);
+  rig.io.analogValues[kAiPin] = 2000;
+  settle(rig, 10);
+  TEST_ASSERT_FALSE(outputHigh(rig, kDo2Pin));
+  const uint32_t writesBefore = rig.io.outputWriteCount;
+
+  // DI edge and the gated output's on-delay expiry land in the same scan.
+  rig.io.inputLevels = 1ULL << kDiPin;
+  TEST_ASSERT_TRUE(runScan(rig, 20));
+  TEST_ASSERT_TRUE(outputHigh(rig, kDoPin));
+  TEST_ASSERT_TRUE(outputHigh(rig, kDo2Pin));
+  TEST_ASSERT_EQUAL_UINT32(writesBefore + 1, rig.io.outputWriteCount);
+}
+
+void test_forced_inputs_and_masks_bypass_hardware() {
+  static TestRig rig;
+  initRig(rig);
+  rig.inputSource[3] = InputSource_ForcedValue;
+  rig.forcedAIValue[3] = 3000;
+  rig.outputMask[2] = true;
+  rig.io.analogValues[kAiPin] = 0;
+  settle(rig, 0);
+  settle(rig, 5);
+  TEST_ASSERT_EQUAL_UINT32(3000, rig.ai[0].currentValue);
+  TEST_ASSERT_EQUAL(State_DO_Active, rig.dOut[1].state);
+  TEST_ASSERT_FALSE(outputHigh(rig, kDo2Pin));
+
+  rig.inputSource[0] = InputSource_ForcedHigh;
+  rig.io.inputLevels = 0;
+  TEST_ASSERT_TRUE(runScan(rig, 10));
+  TEST_ASSERT_TRUE(outputHigh(rig, kDoPin));
+}
+
+void test_scan_walks_plan_entries_in_plan_order() {
+  static TestRig rig;
+  initRig(rig);
+  // Run the pulsing DO ahead of the DI it reads.
+  const V3ScanPlanEntry first = rig.plan[0];
+  rig.plan[0] = rig.plan[1];
+  rig.plan[1] = first;
+  buildV3DependencyIndex(rig.plan, kCards, rig.engine.dependencies);
+  settle(rig, 0);
+
+  rig.io.inputLevels = 1ULL << kDiPin;
+  sampleV3ScanInputs(rig.engine);
+  uint8_t visited[kCards] = {};
+  for (uint8_t i = 0; i < kCards; ++i) {
+    visited[i] = runV3ScanCursorCard(rig.engine, 20, false);
+  }
+  latchV3ScanOutputs(rig.engine);
+  const uint8_t expected[kCards] = {1, 0, 2, 3};
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, visited, kCards);
+
+  // The DO already ran when the DI edge landed; the dependency index
+  // re-marks it and it picks the edge up on the next scan.
+  TEST_ASSERT_FALSE(outputHigh(rig, kDoPin));
+  TEST_ASSERT_TRUE(rig.dirty[1]);
+  TEST_ASSERT_TRUE(runScan(rig, 21));
+  TEST_ASSERT_TRUE(outputHigh(rig, kDoPin));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_input_edge_drives_output_through_backend);
+  RUN_TEST(test_outputs_latch_together_once_per_scan);
+  RUN_TEST(test_forced_inputs_and_masks_bypass_hardware);
+  RUN_TEST(test_scan_walks_plan_entries_in_plan_order);
+  return UNITY_END();
+}
@@ -0,0 +1,148 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_runtime_store.cpp"
+#include "../../src/kernel/v3_runtime_adapters.cpp"
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_scan_plan.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+void test_compile_resolves_io_runtime_slots_and_pins() {
+  V3CardConfig cards[3] = {};
+  cards[0].cardId = 0;
+  cards[0].family = V3CardFamily::DI;
+  cards[0].di.channel = 1;
+  cards[0].di.invert = true;
+  cards[0].di.debounceTimeMs = 25;
+  cards[0].di.edgeMode = Mode_DI_Falling;
+  cards[0].di.set.clauseAId = 2;
+  cards[0].di.set.clauseAOperator = Op_GT;
+  cards[0].di.set.clauseAThreshold = 100;
+  cards[0].di.set.combiner = Combine_None;
+  cards[1].cardId = 1;
+  cards[1].family = V3CardFamily::DO;
+  cards[1].dout.channel = 0;
+  cards[1].dout.mode = Mode_DO_Gated;
+  cards[1].dout.delayBeforeOnMs = 10;
+  cards[1].dout.onDurationMs = 20;
+  cards[1].dout.repeatCount = 3;
+  cards[2].cardId = 2;
+  cards[2].family = V3CardFamily::AI;
+  cards[2].ai.channel = 0;
+  cards[2].ai.emaAlphaX100 = 40;
+
+  RuntimeCardMeta meta[3] = {};
+  meta[0].index = 1;
+  meta[1].index = 0;
+  meta[2].index = 0;
+
+  V3DiRuntimeState di[2] = {};
+  V3DoRuntimeState dOut[1] = {};
+  V3AiRuntimeState ai[1] = {};
+  V3RuntimeStoreView store = {};
+  store.di = di;
+  store.diCount = 2;
+  store.dOut = dOut;
+  store.dOutCount = 1;
+  store.ai = ai;
+  store.aiCount = 1;
+
+  const uint8_t diPins[] = {13, 12};
+  const uint8_t doPins[] = {26};
+  const uint8_t aiPins[] = {35};
+  const V3ScanPlanPins pins = {diPins, 2, doPins, 1, aiPins, 1};
+
+  V3ScanPlanEntry plan[3] = {};
+  compileV3ScanPlan(cards, meta, 3, store, pins, plan);
+
+  TEST_ASSERT_TRUE(plan[0].runtime.di == &di[1]);
+  TEST_ASSERT_EQUAL_UINT8(12, plan[0].hwPin);
+  TEST_ASSERT_TRUE(plan[0].invert);
+  TEST_ASSERT_EQUAL_UINT8(2, plan[0].set.a.source);
+  TEST_ASSERT_EQUAL(CondOp_GT, plan[0].set.a.opcode);
+  TEST_ASSERT_EQUAL_UINT32(100, plan[0].set.a.threshold);
+  TEST_ASSERT_EQUAL_UINT32(25, plan[0].config.di.debounceTimeMs);
+  TEST_ASSERT_EQUAL(Mode_DI_Falling, plan[0].config.di.edgeMode);
+
+  TEST_ASSERT_TRUE(plan[1].runtime.dOut == &dOut[0]);
+  TEST_ASSERT_EQUAL_UINT8(26, plan[1].hwPin);
+  TEST_ASSERT_EQUAL(Mode_DO_Gated, plan[1].config.dOut.mode);
+  TEST_ASSERT_EQUAL_UINT32(3, plan[1].config.dOut.repeatCount);
+
+  TEST_ASSERT_TRUE(plan[2].runtime.ai == &ai[0]);
+  TEST_ASSERT_EQUAL_UINT8(35, plan[2].hwPin);
+  TEST_ASSERT_EQUAL_UINT32(400, plan[2].config.ai.emaAlphaX1000);
+}
+
+void test_compile_uses_meta_index_for_virtual_families() {
+  V3CardConfig cards[3] = {};
+  cards[0].cardId = 4;
+  cards[0].family = V3CardFamily::SIO;
+  cards[1].cardId = 5;
+  cards[1].family = V3CardFamily::MATH;
+  cards[1].math.clampMin = 10;
+  cards[1].math.clampMax = 5;
+  cards[2].cardId = 6;
+  cards[2].family = V3CardFamily::RTC;
+  cards[2].rtc.triggerDurationMs = 60000;
+
+  RuntimeCardMeta meta[3] = {};
+  meta[0].index = 1;
+  meta[1].index = 0;
+  meta[2].index = 0;
+
+  V3SioRuntimeState sio[2] = {};
+  V3MathRuntimeState math[1] = {};
+  V3RtcRuntimeState rtc[1] = {};
+  V3RuntimeStoreView store = {};
+  store.sio = sio;
+  store.sioCount = 2;
+  store.math = math;
+  store.mathCount = 1;
+  store.rtc = rtc;
+  store.rtcCount = 1;
+
+  const V3ScanPlanPins pins = {};
+  V3ScanPlanEntry plan[3] = {};
+  compileV3ScanPlan(cards, meta, 3, store, pins, plan);
+
+  TEST_ASSERT_TRUE(plan[0].runtime.sio == &sio[1]);
+  TEST_ASSERT_EQUAL_UINT8(kV3ScanPlanNoPin, plan[0].hwPin);
+  TEST_ASSERT_TRUE(plan[1].runtime.math == &math[0]);
+  TEST_ASSERT_FALSE(plan[1].config.math.clampEnabled);
+  TEST_ASSERT_TRUE(plan[2].runtime.rtc == &rtc[0]);
+  TEST_ASSERT_EQUAL_UINT32(60000, plan[2].config.rtc.triggerDurationMs);
+  TEST_ASSERT_EQUAL(CondOp_False, plan[2].set.a.opcode);
+}
+
+void test_compile_leaves_unresolved_slots_null() {
+  V3CardConfig card = {};
+  card.cardId = 0;
+  card.family = V3CardFamily::DO;
+  card.dout.channel = 3;
+
+  RuntimeCardMeta meta = {};
+  meta.index = 3;
+
+  V3DoRuntimeState dOut[1] = {};
+  V3RuntimeStoreView store = {};
+  store.dOut = dOut;
+  store.dOutCount = 1;
+
+  const uint8_t doPins[] = {26};
+  const V3ScanPlanPins pins = {nullptr, 0, doPins, 1, nullptr, 0};
+  const V3ScanPlanEntry entry =
+      compileV3ScanPlanEntry(card, meta, &meta, 1, store, pins);
+
+  TEST_ASSERT_NULL(entry.runtime.any);
+  TEST_ASSERT_EQUAL_UINT8(kV3ScanPlanNoPin, entry.hwPin);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_compile_resolves_io_runtime_slots_and_pins);
+  RUN_TEST(test_compile_uses_meta_index_for_virtual_families);
+  RUN_TEST(test_compile_leaves_unresolved_slots_null);
+  return UNITY_END();
+}
@@ -0,0 +1,52 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_scan_schedule.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+void test_deadlines_advance_on_absolute_period() {
+  V3ScanSchedule schedule = {};
+  armV3ScanSchedule(schedule, 1000, 10000);
+  uint32_t lateness = 0;
+
+  TEST_ASSERT_FALSE(takeV3ScanDeadline(schedule, 10999, lateness));
+  TEST_ASSERT_EQUAL_UINT32(1, v3ScanScheduleRemainingUs(schedule, 10999));
+  TEST_ASSERT_TRUE(takeV3ScanDeadline(schedule, 11300, lateness));
+  TEST_ASSERT_EQUAL_UINT32(300, lateness);
+  // Late wake-up does not shift the phase of the next deadline.
+  TEST_ASSERT_EQUAL_UINT32(21000, schedule.nextDueUs);
+  TEST_ASSERT_TRUE(takeV3ScanDeadline(schedule, 21000, lateness));
+  TEST_ASSERT_EQUAL_UINT32(0, lateness);
+}
+
+void test_missed_periods_are_skipped_not_replayed() {
+  V3ScanSchedule schedule = {};
+  armV3ScanSchedule(schedule, 0, 1000);
+  uint32_t lateness = 0;
+
+  TEST_ASSERT_TRUE(takeV3ScanDeadline(schedule, 3500, lateness));
+  TEST_ASSERT_EQUAL_UINT32(2500, lateness);
+  TEST_ASSERT_EQUAL_UINT32(2, schedule.missedPeriods);
+  TEST_ASSERT_EQUAL_UINT32(4000, schedule.nextDueUs);
+  TEST_ASSERT_FALSE(takeV3ScanDeadline(schedule, 3600, lateness));
+}
+
+void test_schedule_handles_clock_wrap() {
+  V3ScanSchedule schedule = {};
+  armV3ScanSchedule(schedule, 0xFFFFFF00UL, 0x200);
+  uint32_t lateness = 0;
+
+  TEST_ASSERT_FALSE(takeV3ScanDeadline(schedule, 0xFFFFFFF0UL, lateness));
+  TEST_ASSERT_EQUAL_UINT32(0x110, v3ScanScheduleRemainingUs(schedule, 0xFFFFFFF0UL));
+  TEST_ASSERT_TRUE(takeV3ScanDeadline(schedule, 0x110, lateness));
+  TEST_ASSERT_EQUAL_UINT32(0x10, lateness);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_deadlines_advance_on_absolute_period);
+  RUN_TEST(test_missed_periods_are_skipped_not_replayed);
+  RUN_TEST(test_schedule_handles_clock_wrap);
+  return UNITY_END();
+}
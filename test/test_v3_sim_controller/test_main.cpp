@@ -0,0 +1,225 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_ai_runtime.cpp"
+#include "../../src/kernel/v3_card_bridge.cpp"
+#include "../../src/kernel/v3_card_profile.cpp"
+#include "../../src/kernel/v3_condition_program.cpp"
+#include "../../src/kernel/v3_di_runtime.cpp"
+#include "../../src/kernel/v3_do_runtime.cpp"
+#include "../../src/kernel/v3_incremental_scan.cpp"
+#include "../../src/kernel/v3_io_image.cpp"
+#include "../../src/kernel/v3_math_runtime.cpp"
+#include "../../src/kernel/v3_rtc_runtime.cpp"
+#include "../../src/kernel/v3_runtime_adapters.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/kernel/v3_runtime_store.cpp"
+#include "../../src/kernel/v3_scan_engine.cpp"
+#include "../../src/kernel/v3_scan_plan.cpp"
+#include "../../src/kernel/v3_sio_runtime.cpp"
+#include "../../src/kernel/v3_timer_index.cpp"
+#include "../../src/platform/esp32_devkit_profile.cpp"
+#include "../../src/platform/memory_io_backend.cpp"
+#include "../../src/runtime/runtime_card_meta.cpp"
+#include "../../src/sim/sim_controller.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint64_t kHourMs = 3600000ULL;
+constexpr uint64_t kDayMs = 24 * kHourMs;
+constexpr uint8_t kDiCard = 0;
+constexpr uint8_t kPulseCard = 4;   // DO pin 26
+constexpr uint8_t kBlinkCard = 5;   // DO pin 25
+constexpr uint8_t kFollowCard = 6;  // DO pin 33
+constexpr uint8_t kRtcCard = 16;
+
+V3ConditionBlock clause(uint8_t id, logicOperator op) {
+  V3ConditionBlock block = {};
+  block.clauseAId = id;
+  block.clauseAOperator = op;
+  block.clauseBId = id;
+  block.clauseBOperator = Op_AlwaysFalse;
+  block.combiner = Combine_None;
+  return block;
+}
+
+void defaultCards(const SimLayout& layout, V3CardConfig* cards) {
+  for (uint8_t id = 0; id < layout.cards.totalCards; ++id) {
+    V3CardConfig& card = cards[id];
+    card = {};
+    card.cardId = id;
+    card.enabled = true;
+    if (id < layout.cards.doStart) {
+      card.family = V3CardFamily::DI;
+      card.di.channel = id;
+      card.di.edgeMode = Mode_DI_Rising;
+      card.di.set = clause(id, Op_AlwaysTrue);
+      card.di.reset = clause(id, Op_AlwaysFalse);
+    } else if (id < layout.cards.aiStart) {
+      card.family = V3CardFamily::DO;
+      card.dout.channel = static_cast<uint8_t>(id - layout.cards.doStart);
+      card.dout.mode = Mode_DO_Normal;
+      card.dout.delayBeforeOnMs = 1000;
+      card.dout.onDurationMs = 1000;
+      card.dout.repeatCount = 1;
+      card.dout.set = clause(id, Op_AlwaysFalse);
+      card.dout.reset = clause(id, Op_AlwaysFalse);
+    } else if (id < layout.cards.sioStart) {
+      card.family = V3CardFamily::AI;
+      card.ai.channel = static_cast<uint8_t>(id - layout.cards.aiStart);
+      card.ai.inputMax = 4095;
+      card.ai.outputMax = 4095;
+      card.ai.emaAlphaX100 = 100;
+    } else if (id < layout.cards.mathStart) {
+      card.family = V3CardFamily::SIO;
+      card.sio.mode = Mode_DO_Normal;
+      card.sio.onDurationMs = 1000;
+      card.sio.repeatCount = 1;
+      card.sio.set = clause(id, Op_AlwaysFalse);
+      card.sio.reset = clause(id, Op_AlwaysFalse);
+    } else if (id < layout.cards.rtcStart) {
+      card.family = V3CardFamily::MATH;
+      card.math.set = clause(id, Op_AlwaysFalse);
+      card.math.reset = clause(id, Op_AlwaysFalse);
+    } else {
+      card.family = V3CardFamily::RTC;
+      card.rtc.triggerDurationMs = 60000;
+    }
+  }
+}
+
+// Card 16 fires at minute 0 of every hour for 5 s; card 4 pulses 3x
+// (1 s delay, 2 s on) per trigger; card 5 blinks 30 s off / 30 s on
+// forever; card 6 follows DI 0.
+void initSim(SimController& sim) {
+  const SimLayout layout = simDefaultLayout();
+  TEST_ASSERT_TRUE(initSimController(sim, layout, 500, 2026, 1, 1));
+  V3CardConfig cards[kSimMaxCards] = {};
+  defaultCards(layout, cards);
+
+  cards[kPulseCard].dout.delayBeforeOnMs = 1000;
+  cards[kPulseCard].dout.onDurationMs = 2000;
+  cards[kPulseCard].dout.repeatCount = 3;
+  cards[kPulseCard].dout.set = clause(kRtcCard, Op_LogicalTrue);
+
+  cards[kBlinkCard].dout.delayBeforeOnMs = 30000;
+  cards[kBlinkCard].dout.onDurationMs = 30000;
+  cards[kBlinkCard].dout.repeatCount = 0;
+  cards[kBlinkCard].dout.set = clause(kBlinkCard, Op_AlwaysTrue);
+
+  cards[kFollowCard].dout.mode = Mode_DO_Gated;
+  cards[kFollowCard].dout.delayBeforeOnMs = 1;
+  cards[kFollowCard].dout.onDurationMs = 0;
+  cards[kFollowCard].dout.set = clause(kDiCard, Op_PhysicalOn);
+
+  cards[kRtcCard].rtc.minute = 0;
+  cards[kRtcCard].rtc.triggerDurationMs = 5000;
+
+  V3RtcScheduleView channels[2] = {};
+  channels[0] = {true, -1, -1, -1, -1, -1, 0, kRtcCard};
+  channels[1] = {false, -1, -1, -1, -1, -1, -1, kRtcCard + 1};
+  TEST_ASSERT_TRUE(
+      loadSimConfig(sim, cards, layout.cards.totalCards, channels, 2));
+}
+}  // namespace
+
+void test_rtc_stamp_tracks_virtual_calendar() {
+  static SimController sim;
+  TEST_ASSERT_TRUE(initSimController(sim, simDefaultLayout(), 500, 2026, 1, 1));
+  V3RtcMinuteStamp stamp = simRtcStamp(sim);
+  TEST_ASSERT_EQUAL(2026, stamp.year);
+  TEST_ASSERT_EQUAL(1, stamp.month);
+  TEST_ASSERT_EQUAL(1, stamp.day);
+  TEST_ASSERT_EQUAL(4, stamp.weekday);  // Thursday
+  TEST_ASSERT_EQUAL(0, stamp.hour);
+
+  sim.nowMs = 59 * kDayMs + 25 * kHourMs + 61000;
+  stamp = simRtcStamp(sim);
+  TEST_ASSERT_EQUAL(3, stamp.month);
+  TEST_ASSERT_EQUAL(2, stamp.day);
+  TEST_ASSERT_EQUAL(1, stamp.weekday);  // Monday
+  TEST_ASSERT_EQUAL(1, stamp.hour);
+  TEST_ASSERT_EQUAL(1, stamp.minute);
+}
+
+void test_day_of_rtc_schedules_and_repeat_cycles() {
+  static SimController sim;
+  initSim(sim);
+  advanceSimController(sim, kDayMs);
+
+  TEST_ASSERT_EQUAL_UINT32(24 * 60, sim.stats.rtcMinuteTicks);
+  TEST_ASSERT_EQUAL_UINT32(24, sim.stats.rtcTriggers);
+  // Three pulses per hourly trigger.
+  TEST_ASSERT_EQUAL_UINT32(24 * 3, sim.dOut[kPulseCard - 4].currentValue);
+  TEST_ASSERT_EQUAL(State_DO_Finished, sim.dOut[kPulseCard - 4].state);
+  // One on-edge per minute.
+  TEST_ASSERT_EQUAL_UINT32(24 * 60, sim.dOut[kBlinkCard - 4].currentValue);
+  TEST_ASSERT_EQUAL_UINT32(24 * 3 * 2 + 24 * 60 * 2 - 1,
+                           sim.stats.outputEdges);
+  TEST_ASSERT_EQUAL_UINT32(0, sim.stats.commandsDropped);
+
+  // Only periods with work are evaluated; the rest are fast-forwarded.
+  const uint32_t periods = static_cast<uint32_t>(kDayMs / 500);
+  TEST_ASSERT_EQUAL_UINT32(periods, sim.stats.scans +
+                                        sim.stats.idleScansSkipped);
+  TEST_ASSERT_TRUE(sim.stats.scans < periods / 20);
+}
+
+void test_input_changes_are_seen_by_next_scan() {
+  static SimController sim;
+  initSim(sim);
+  advanceSimController(sim, 10000);
+  TEST_ASSERT_FALSE(simOutputLevel(sim, 33));
+
+  setSimDigitalInput(sim, 13, true);
+  advanceSimController(sim, 12000);
+  TEST_ASSERT_TRUE(simOutputLevel(sim, 33));
+
+  setSimDigitalInput(sim, 13, false);
+  advanceSimController(sim, 14000);
+  TEST_ASSERT_FALSE(simOutputLevel(sim, 33));
+}
+
+void test_commands_pass_through_queue() {
+  static SimController sim;
+  initSim(sim);
+  advanceSimController(sim, 1000);
+  const uint32_t appliedBefore = sim.stats.commandsApplied;
+
+  KernelCommand force = {};
+  force.type = KernelCmd_SetInputForce;
+  force.cardId = kDiCard;
+  force.inputMode = InputSource_ForcedHigh;
+  TEST_ASSERT_TRUE(enqueueSimCommand(sim, force));
+  KernelCommand step = {};
+  step.type = KernelCmd_StepOnce;
+  TEST_ASSERT_TRUE(enqueueSimCommand(sim, step));
+  KernelCommand mask = {};
+  mask.type = KernelCmd_SetOutputMask;
+  mask.cardId = kDiCard;
+  mask.flag = true;
+  TEST_ASSERT_TRUE(enqueueSimCommand(sim, mask));
+
+  advanceSimController(sim, 3000);
+  TEST_ASSERT_EQUAL_UINT32(appliedBefore + 1, sim.stats.commandsApplied);
+  TEST_ASSERT_EQUAL_UINT32(2, sim.stats.commandsRejected);
+  TEST_ASSERT_TRUE(simOutputLevel(sim, 33));
+
+  for (uint8_t i = 0; i < kSimCommandQueueCapacity; ++i) {
+    TEST_ASSERT_TRUE(enqueueSimCommand(sim, step));
+  }
+  TEST_ASSERT_FALSE(enqueueSimCommand(sim, step));
+  TEST_ASSERT_EQUAL_UINT32(1, sim.stats.commandsDropped);
+  TEST_ASSERT_EQUAL_UINT16(kSimCommandQueueCapacity,
+                           sim.stats.queueHighWaterMark);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_rtc_stamp_tracks_virtual_calendar);
+  RUN_TEST(test_day_of_rtc_schedules_and_repeat_cycles);
+  RUN_TEST(test_input_changes_are_seen_by_next_scan);
+  RUN_TEST(test_commands_pass_through_queue);
+  return UNITY_END();
+}
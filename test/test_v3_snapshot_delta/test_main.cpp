@@ -0,0 +1,141 @@
+#include <unity.h>
+
+#include <string>
+
+#include "../../src/kernel/enum_codec.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/runtime/latency_histogram.cpp"
+#include "../../src/runtime/snapshot_json.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint8_t kCards = 4;
+using Snapshot = SharedRuntimeSnapshotT<kCards>;
+
+Snapshot gPrevious;
+Snapshot gNext;
+
+void fillSnapshot(Snapshot& snapshot) {
+  snapshot = {};
+  snapshot.seq = 7;
+  snapshot.tsMs = 1000;
+  snapshot.scanBudgetUs = 10000;
+  snapshot.kernelQueueCapacity = 16;
+  for (uint8_t i = 0; i < kCards; ++i) {
+    snapshot.cards[i].id = i;
+    snapshot.cards[i].type = (i < 2) ? DigitalInput : DigitalOutput;
+    snapshot.cards[i].index = i % 2;
+    snapshot.signals.currentValue[i] = i * 10U;
+    snapshot.signals.evalCounter[i] = 3;
+  }
+}
+
+std::string cardJson(JsonArrayConst cards, uint8_t id) {
+  for (JsonVariantConst card : cards) {
+    if ((card["id"] | 255) != id) continue;
+    std::string out;
+    serializeJson(card, out);
+    return out;
+  }
+  return std::string();
+}
+
+void serializePatch(JsonDocument& doc) {
+  serializeRuntimeSnapshotPatch(doc, gPrevious, gNext, kCards, 2000, 10);
+}
+}  // namespace
+
+void test_patch_without_changes_has_no_cards_or_metrics() {
+  fillSnapshot(gPrevious);
+  fillSnapshot(gNext);
+  JsonDocument doc;
+  TEST_ASSERT_EQUAL_UINT8(
+      0, serializeRuntimeSnapshotPatch(doc, gPrevious, gNext, kCards, 2000, 10));
+  TEST_ASSERT_EQUAL_STRING("runtime_patch", doc["type"] | "");
+  TEST_ASSERT_EQUAL_UINT32(7, doc["snapshotSeq"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(7, doc["baseSnapshotSeq"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(1000, doc["baseTsMs"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(0, doc["cards"].size());
+  TEST_ASSERT_TRUE(doc["metrics"].isNull());
+  TEST_ASSERT_FALSE(doc["testMode"].isNull());
+}
+
+void test_patch_carries_only_changed_cards_matching_full_document() {
+  fillSnapshot(gPrevious);
+  fillSnapshot(gNext);
+  gNext.seq = 8;
+  gNext.signals.currentValue[1] = 99;
+  setV3SignalBit(gNext.signals.logical, 3, true);
+  gNext.breakpointEnabled[3] = true;
+
+  JsonDocument patch;
+  serializePatch(patch);
+  TEST_ASSERT_EQUAL_UINT32(2, patch["cards"].size());
+  TEST_ASSERT_EQUAL_UINT8(1, patch["cards"][0]["id"] | 255);
+  TEST_ASSERT_EQUAL_UINT8(3, patch["cards"][1]["id"] | 255);
+
+  JsonDocument full;
+  serializeRuntimeSnapshotDocument(full, gNext, kCards, 2000, 10);
+  for (uint8_t id : {1, 3}) {
+    TEST_ASSERT_TRUE(cardJson(full["cards"].as<JsonArrayConst>(), id) ==
+                     cardJson(patch["cards"].as<JsonArrayConst>(), id));
+  }
+}
+
+void test_global_mask_change_patches_every_card() {
+  fillSnapshot(gPrevious);
+  fillSnapshot(gNext);
+  gNext.globalOutputMask = true;
+  JsonDocument doc;
+  serializePatch(doc);
+  TEST_ASSERT_EQUAL_UINT32(kCards, doc["cards"].size());
+  TEST_ASSERT_TRUE(doc["testMode"]["outputMaskGlobal"] | false);
+}
+
+void test_metric_change_includes_full_metrics_block() {
+  fillSnapshot(gPrevious);
+  fillSnapshot(gNext);
+  recordLatencySample(gNext.scanDurationHistogram, 812);
+  JsonDocument doc;
+  serializePatch(doc);
+  TEST_ASSERT_EQUAL_UINT32(0, doc["cards"].size());
+  TEST_ASSERT_EQUAL_UINT32(10000, doc["metrics"]["scanBudgetUs"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(1, doc["metrics"]["scanHistogram"]["count"] | 0U);
+}
+
+void test_msgpack_patch_encodes_enums_as_integers() {
+  fillSnapshot(gPrevious);
+  fillSnapshot(gNext);
+  gNext.mode = RUN_STEP;
+  gNext.signals.state[2] = static_cast<uint8_t>(State_DO_Active);
+  JsonDocument doc;
+  TEST_ASSERT_EQUAL_UINT8(
+      1, serializeRuntimeSnapshotPatch(doc, gPrevious, gNext, kCards, 2000, 10,
+                                       SnapshotEncoding_MsgPack));
+  std::string packed;
+  serializeMsgPack(doc, packed);
+
+  JsonDocument decoded;
+  TEST_ASSERT_FALSE(deserializeMsgPack(decoded, packed));
+  TEST_ASSERT_EQUAL_STRING("runtime_patch", decoded["type"] | "");
+  TEST_ASSERT_TRUE(decoded["runMode"].is<uint8_t>());
+  TEST_ASSERT_EQUAL_UINT8(RUN_STEP, decoded["runMode"] | 255);
+  JsonVariantConst card = decoded["cards"][0];
+  TEST_ASSERT_EQUAL_UINT8(2, card["id"] | 255);
+  TEST_ASSERT_EQUAL_UINT8(DigitalOutput, card["type"] | 255);
+  TEST_ASSERT_EQUAL_UINT8(State_DO_Active, card["state"] | 255);
+  TEST_ASSERT_TRUE(card["maskForced"]["inputSource"].is<uint8_t>());
+  TEST_ASSERT_EQUAL_UINT32(20, card["currentValue"] | 0U);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_patch_without_changes_has_no_cards_or_metrics);
+  RUN_TEST(test_patch_carries_only_changed_cards_matching_full_document);
+  RUN_TEST(test_global_mask_change_patches_every_card);
+  RUN_TEST(test_metric_change_includes_full_metrics_block);
+  RUN_TEST(test_msgpack_patch_encodes_enums_as_integers);
+  return UNITY_END();
+}
@@ -0,0 +1,135 @@
+#include <unity.h>
+
+#include <string>
+
+#include "../../src/kernel/enum_codec.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/runtime/latency_histogram.cpp"
+#include "../../src/runtime/snapshot_json.cpp"
+#include "../../src/runtime/snapshot_payload_cache.cpp"
+#include "../../src/runtime/stream_backpressure.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint8_t kCards = 4;
+using Snapshot = SharedRuntimeSnapshotT<kCards>;
+
+Snapshot gSnapshot;
+
+void fillSnapshot(Snapshot& snapshot) {
+  snapshot = {};
+  snapshot.seq = 7;
+  snapshot.tsMs = 1000;
+  snapshot.scanBudgetUs = 10000;
+  for (uint8_t i = 0; i < kCards; ++i) {
+    snapshot.cards[i].id = i;
+    snapshot.cards[i].type = (i < 2) ? DigitalInput : DigitalOutput;
+    snapshot.signals.currentValue[i] = i * 10U;
+  }
+}
+
+const SnapshotPayload* cachePayload(SnapshotPayloadCache& cache,
+                                    SnapshotEncoding encoding) {
+  return cacheRuntimeSnapshotPayload(cache, gSnapshot, kCards, 2000, 10,
+                                     encoding);
+}
+
+std::string payloadText(const SnapshotPayload& payload) {
+  return std::string(reinterpret_cast<const char*>(payload.data),
+                     payload.size);
+}
+}  // namespace
+
+void test_unchanged_snapshot_reuses_serialized_payload() {
+  fillSnapshot(gSnapshot);
+  SnapshotPayloadCache cache = {};
+  const SnapshotPayload* first = cachePayload(cache, SnapshotEncoding_Json);
+  TEST_ASSERT_TRUE(first != nullptr);
+  const std::string text = payloadText(*first);
+  const SnapshotPayload* second = cachePayload(cache, SnapshotEncoding_Json);
+  TEST_ASSERT_TRUE(first == second);
+  TEST_ASSERT_EQUAL_UINT32(1, cache.misses);
+  TEST_ASSERT_EQUAL_UINT32(1, cache.hits);
+  TEST_ASSERT_TRUE(text == payloadText(*second));
+
+  JsonDocument doc;
+  serializeRuntimeSnapshotDocument(doc, gSnapshot, kCards, 2000, 10);
+  std::string expected;
+  serializeJson(doc, expected);
+  TEST_ASSERT_TRUE(expected == text);
+  releaseSnapshotPayloadCache(cache);
+}
+
+void test_metrics_only_publish_reserializes_into_same_buffer() {
+  fillSnapshot(gSnapshot);
+  SnapshotPayloadCache cache = {};
+  const SnapshotPayload* first = cachePayload(cache, SnapshotEncoding_Json);
+  const uint8_t* buffer = first->data;
+
+  gSnapshot.tsMs = 1001;
+  gSnapshot.kernelQueueDepth = 1;
+  const SnapshotPayload* second = cachePayload(cache, SnapshotEncoding_Json);
+  TEST_ASSERT_EQUAL_UINT32(2, cache.misses);
+  TEST_ASSERT_EQUAL_UINT32(0, cache.hits);
+  TEST_ASSERT_TRUE(buffer == second->data);
+
+  JsonDocument doc;
+  TEST_ASSERT_FALSE(deserializeJson(doc, payloadText(*second)));
+  TEST_ASSERT_EQUAL_UINT32(7, doc["snapshotSeq"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(1001, doc["tsMs"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(1, doc["metrics"]["queueDepth"] | 0U);
+  releaseSnapshotPayloadCache(cache);
+}
+
+void test_encodings_have_separate_slots() {
+  fillSnapshot(gSnapshot);
+  SnapshotPayloadCache cache = {};
+  const SnapshotPayload* json = cachePayload(cache, SnapshotEncoding_Json);
+  const SnapshotPayload* packed =
+      cachePayload(cache, SnapshotEncoding_MsgPack);
+  TEST_ASSERT_TRUE(json != packed);
+  TEST_ASSERT_TRUE(packed->size < json->size);
+  TEST_ASSERT_TRUE(json == cachePayload(cache, SnapshotEncoding_Json));
+  TEST_ASSERT_EQUAL_UINT32(2, cache.misses);
+  TEST_ASSERT_EQUAL_UINT32(1, cache.hits);
+
+  JsonDocument doc;
+  TEST_ASSERT_FALSE(deserializeMsgPack(
+      doc, reinterpret_cast<const char*>(packed->data), packed->size));
+  TEST_ASSERT_EQUAL_UINT8(DigitalOutput, doc["cards"][3]["type"] | 255);
+  releaseSnapshotPayloadCache(cache);
+}
+
+void test_stream_revision_change_reserializes() {
+  fillSnapshot(gSnapshot);
+  SnapshotPayloadCache cache = {};
+  SnapshotStreamMetrics stream = {};
+  resetStreamClient(stream, 0, true);
+  cacheRuntimeSnapshotPayload(cache, gSnapshot, kCards, 2000, 10,
+                              SnapshotEncoding_Json, &stream);
+  cacheRuntimeSnapshotPayload(cache, gSnapshot, kCards, 2000, 10,
+                              SnapshotEncoding_Json, &stream);
+  TEST_ASSERT_EQUAL_UINT32(1, cache.hits);
+
+  stream.evictions = 1;
+  stream.revision += 1;
+  const SnapshotPayload* payload = cacheRuntimeSnapshotPayload(
+      cache, gSnapshot, kCards, 2000, 10, SnapshotEncoding_Json, &stream);
+  TEST_ASSERT_EQUAL_UINT32(2, cache.misses);
+  JsonDocument doc;
+  TEST_ASSERT_FALSE(deserializeJson(doc, payloadText(*payload)));
+  TEST_ASSERT_EQUAL_UINT32(1, doc["metrics"]["wsEvictions"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(1, doc["metrics"]["wsClients"].size());
+  releaseSnapshotPayloadCache(cache);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_unchanged_snapshot_reuses_serialized_payload);
+  RUN_TEST(test_metrics_only_publish_reserializes_into_same_buffer);
+  RUN_TEST(test_encodings_have_separate_slots);
+  RUN_TEST(test_stream_revision_change_reserializes);
+  return UNITY_END();
+}
@@ -0,0 +1,63 @@
+#include <unity.h>
+
+#include "../../src/runtime/snapshot_publish_gate.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint32_t kIntervalMs = 250;
+
+// One kernel wake per `periodMs`; every wake records a jitter sample, so
+// metrics are always dirty. Returns the number of publishes.
+uint32_t runIdleKernel(SnapshotPublishGate& gate, uint32_t periodMs,
+                       uint32_t durationMs) {
+  uint32_t publishes = 0;
+  for (uint32_t nowMs = periodMs; nowMs <= durationMs; nowMs += periodMs) {
+    if (takeSnapshotPublish(gate, false, true, nowMs) != SnapshotPublish_None) {
+      publishes += 1;
+    }
+  }
+  return publishes;
+}
+}  // namespace
+
+void test_idle_kernel_does_not_republish_every_period() {
+  SnapshotPublishGate gate = {kIntervalMs, 0, 0};
+  const uint32_t publishes = runIdleKernel(gate, 1, 10000);
+  TEST_ASSERT_EQUAL_UINT32(10000 / kIntervalMs, publishes);
+  TEST_ASSERT_EQUAL_UINT32(publishes, gate.rebuildsAvoided);
+}
+
+void test_runtime_change_publishes_at_once_with_cards() {
+  SnapshotPublishGate gate = {kIntervalMs, 0, 0};
+  TEST_ASSERT_EQUAL(SnapshotPublish_Full,
+                    takeSnapshotPublish(gate, true, true, 10));
+  TEST_ASSERT_EQUAL(SnapshotPublish_Full,
+                    takeSnapshotPublish(gate, true, false, 11));
+  TEST_ASSERT_EQUAL_UINT32(0, gate.rebuildsAvoided);
+
+  // The full publish carried the metrics, so the interval restarts there.
+  TEST_ASSERT_EQUAL(SnapshotPublish_None,
+                    takeSnapshotPublish(gate, false, true, 11 + 249));
+  TEST_ASSERT_EQUAL(SnapshotPublish_Metrics,
+                    takeSnapshotPublish(gate, false, true, 11 + 250));
+  TEST_ASSERT_EQUAL_UINT32(1, gate.rebuildsAvoided);
+}
+
+void test_wakes_without_change_are_not_counted() {
+  SnapshotPublishGate gate = {kIntervalMs, 0, 0};
+  for (uint32_t nowMs = 0; nowMs < 5000; nowMs += 10) {
+    TEST_ASSERT_EQUAL(SnapshotPublish_None,
+                      takeSnapshotPublish(gate, false, false, nowMs));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, gate.rebuildsAvoided);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_idle_kernel_does_not_republish_every_period);
+  RUN_TEST(test_runtime_change_publishes_at_once_with_cards);
+  RUN_TEST(test_wakes_without_change_are_not_counted);
+  return UNITY_END();
+}
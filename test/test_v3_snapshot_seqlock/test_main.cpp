@@ -0,0 +1,115 @@
+#include <unity.h>
+
+#include "../../src/runtime/snapshot_seqlock.h"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+struct Payload {
+  uint32_t seq;
+  uint32_t values[8];
+};
+
+void fillPayload(Payload& payload, uint32_t seq) {
+  payload.seq = seq;
+  for (uint8_t i = 0; i < 8; ++i) payload.values[i] = seq * 10U + i;
+}
+
+template <uint8_t Buffers>
+void publish(V3SnapshotSeqlock<Payload, Buffers>& lock, uint32_t seq) {
+  fillPayload(beginV3SnapshotWrite(lock), seq);
+  publishV3SnapshotWrite(lock);
+}
+
+uint32_t gYields = 0;
+void countYield() { gYields += 1; }
+}  // namespace
+
+void test_reader_sees_last_published_buffer_during_write() {
+  V3SnapshotSeqlock<Payload> lock = {};
+  publish(lock, 1);
+
+  Payload& back = beginV3SnapshotWrite(lock);
+  fillPayload(back, 2);
+  back.values[3] = 0xDEADU;
+
+  Payload out = {};
+  TEST_ASSERT_TRUE(tryReadV3Snapshot(lock, out));
+  TEST_ASSERT_EQUAL_UINT32(1, out.seq);
+  TEST_ASSERT_EQUAL_UINT32(13, out.values[3]);
+  TEST_ASSERT_EQUAL_UINT32(1, publishedV3Snapshot(lock).seq);
+
+  publishV3SnapshotWrite(lock);
+  TEST_ASSERT_TRUE(readV3Snapshot(lock, out));
+  TEST_ASSERT_EQUAL_UINT32(2, out.seq);
+  TEST_ASSERT_EQUAL_UINT32(0xDEADU, out.values[3]);
+}
+
+void test_reader_retries_only_when_writer_laps_its_buffer() {
+  V3SnapshotSeqlock<Payload> lock = {};
+  publish(lock, 1);
+
+  uint8_t index = 0;
+  uint32_t seq = beginV3SnapshotRead(lock, index);
+  publish(lock, 2);
+  publish(lock, 3);
+  TEST_ASSERT_TRUE(endV3SnapshotRead(lock, index, seq));
+
+  seq = beginV3SnapshotRead(lock, index);
+  publish(lock, 4);
+  publish(lock, 5);
+  beginV3SnapshotWrite(lock);
+  TEST_ASSERT_FALSE(endV3SnapshotRead(lock, index, seq));
+  publishV3SnapshotWrite(lock);
+  TEST_ASSERT_FALSE(endV3SnapshotRead(lock, index, seq));
+}
+
+void test_double_buffer_rotates_between_two_slots() {
+  V3SnapshotSeqlock<Payload, 2> lock = {};
+  publish(lock, 1);
+  const Payload* first = &publishedV3Snapshot(lock);
+  publish(lock, 2);
+  publish(lock, 3);
+  TEST_ASSERT_TRUE(first == &publishedV3Snapshot(lock));
+
+  Payload out = {};
+  TEST_ASSERT_TRUE(readV3Snapshot(lock, out));
+  TEST_ASSERT_EQUAL_UINT32(3, out.seq);
+  TEST_ASSERT_EQUAL_UINT32(37, out.values[7]);
+}
+
+void test_read_is_bounded_when_writer_keeps_lapping() {
+  V3SnapshotSeqlock<Payload> lock = {};
+  publish(lock, 1);
+  gYields = 0;
+
+  // Three publishes during every copy lap the reader's buffer each time.
+  uint32_t copies = 0;
+  Payload out = {};
+  const bool ok = readV3SnapshotWith(
+      lock,
+      [&](const Payload& snapshot) {
+        out = snapshot;
+        copies += 1;
+        for (uint8_t i = 0; i < 3; ++i) publish(lock, 3 * copies + i);
+      },
+      countYield);
+  TEST_ASSERT_FALSE(ok);
+  TEST_ASSERT_EQUAL_UINT32(kV3SnapshotReadAttempts, copies);
+  TEST_ASSERT_EQUAL_UINT32(kV3SnapshotReadAttempts / kV3SnapshotReadSpins,
+                           gYields);
+
+  // A writer that stops lapping lets the next read through at once.
+  TEST_ASSERT_TRUE(readV3Snapshot(lock, out, countYield));
+  TEST_ASSERT_EQUAL_UINT32(3 * copies + 2, out.seq);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_reader_sees_last_published_buffer_during_write);
+  RUN_TEST(test_reader_retries_only_when_writer_laps_its_buffer);
+  RUN_TEST(test_double_buffer_rotates_between_two_slots);
+  RUN_TEST(test_read_is_bounded_when_writer_keeps_lapping);
+  return UNITY_END();
+}
@@ -0,0 +1,176 @@
+#include <unity.h>
+
+#include "../../src/kernel/enum_codec.cpp"
+#include "../../src/kernel/v3_condition_rules.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/runtime/latency_histogram.cpp"
+#include "../../src/runtime/snapshot_json.cpp"
+#include "../../src/runtime/snapshot_payload_cache.cpp"
+#include "../../src/runtime/snapshot_subscription.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint8_t kCards = 8;
+using Snapshot = SharedRuntimeSnapshotT<kCards>;
+
+// DI 0-1, DO 2-5, AI 6, SIO 7.
+constexpr V3CardLayout kLayout = {8, 2, 6, 7, 8, 8};
+
+Snapshot gPrevious;
+Snapshot gNext;
+
+void fillSnapshot(Snapshot& snapshot) {
+  snapshot = {};
+  snapshot.seq = 7;
+  snapshot.tsMs = 1000;
+  for (uint8_t i = 0; i < kCards; ++i) {
+    snapshot.cards[i].id = i;
+    snapshot.cards[i].type = v3CardTypeForId(kLayout, i);
+    snapshot.signals.currentValue[i] = i * 10U;
+  }
+}
+
+bool parse(const char* json, SnapshotSubscription& out,
+           const char*& errorField) {
+  JsonDocument doc;
+  deserializeJson(doc, json);
+  return parseSnapshotSubscription(doc.as<JsonObjectConst>(), kLayout, out,
+                                   errorField);
+}
+
+void accumulate(SnapshotSubscriber& subscriber) {
+  uint16_t changed[kCards] = {};
+  for (uint8_t i = 0; i < kCards; ++i) {
+    changed[i] = runtimeSnapshotCardChangedFields(gPrevious, gNext, i);
+  }
+  accumulateSnapshotSubscriberChanges(
+      subscriber, changed, kCards,
+      runtimeSnapshotMetricsChanged(gPrevious, gNext),
+      runtimeSnapshotHeaderChanged(gPrevious, gNext));
+}
+}  // namespace
+
+void test_parse_selects_families_cards_fields_and_rate() {
+  SnapshotSubscription sub = {};
+  const char* errorField = nullptr;
+  TEST_ASSERT_TRUE(parse("{\"families\":[\"DO\"],\"cards\":[7],"
+                         "\"fields\":[\"signals\",\"state\"],"
+                         "\"metrics\":false,\"maxRateHz\":4}",
+                         sub, errorField));
+  for (uint8_t id = 0; id < kCards; ++id) {
+    const bool expected = (id >= 2 && id <= 5) || id == 7;
+    TEST_ASSERT_EQUAL(expected, v3SignalBit(sub.cards, id));
+  }
+  TEST_ASSERT_EQUAL_UINT16(CardField_Signals | CardField_State, sub.fields);
+  TEST_ASSERT_FALSE(sub.metrics);
+  TEST_ASSERT_EQUAL_UINT32(250, sub.minIntervalMs);
+
+  TEST_ASSERT_TRUE(parse("{}", sub, errorField));
+  TEST_ASSERT_TRUE(v3SignalBit(sub.cards, 0) && v3SignalBit(sub.cards, 7));
+  TEST_ASSERT_FALSE(v3SignalBit(sub.cards, 8));
+  TEST_ASSERT_EQUAL_UINT16(kSnapshotCardFieldsAll, sub.fields);
+  TEST_ASSERT_TRUE(sub.metrics);
+  TEST_ASSERT_EQUAL_UINT32(0, sub.minIntervalMs);
+}
+
+void test_parse_rejects_unknown_members() {
+  SnapshotSubscription sub = {};
+  const char* errorField = nullptr;
+  TEST_ASSERT_FALSE(parse("{\"cards\":[8]}", sub, errorField));
+  TEST_ASSERT_EQUAL_STRING("cards", errorField);
+  TEST_ASSERT_FALSE(parse("{\"families\":[\"PLC\"]}", sub, errorField));
+  TEST_ASSERT_EQUAL_STRING("families", errorField);
+  TEST_ASSERT_FALSE(parse("{\"fields\":[\"everything\"]}", sub, errorField));
+  TEST_ASSERT_EQUAL_STRING("fields", errorField);
+  TEST_ASSERT_FALSE(parse("{\"maxRateHz\":\"fast\"}", sub, errorField));
+  TEST_ASSERT_EQUAL_STRING("maxRateHz", errorField);
+}
+
+void test_keyframe_then_patch_carry_only_subscribed_cards_and_fields() {
+  SnapshotSubscription sub = {};
+  const char* errorField = nullptr;
+  TEST_ASSERT_TRUE(parse("{\"families\":[\"DO\"],\"fields\":[\"value\"],"
+                         "\"metrics\":false}",
+                         sub, errorField));
+  SnapshotSubscriber subscriber = {};
+  resetSnapshotSubscriber(subscriber, sub);
+  fillSnapshot(gNext);
+
+  JsonDocument keyframe;
+  TEST_ASSERT_TRUE(snapshotSubscriberDue(subscriber, 1000));
+  TEST_ASSERT_EQUAL_UINT8(4, serializeSubscribedSnapshotFrame(
+                                 keyframe, gNext, kCards, 1000, 10,
+                                 subscriber, SnapshotEncoding_Json));
+  TEST_ASSERT_EQUAL_STRING("runtime_snapshot", keyframe["type"] | "");
+  TEST_ASSERT_TRUE(keyframe["metrics"].isNull());
+  JsonVariantConst card = keyframe["cards"][0];
+  TEST_ASSERT_EQUAL_UINT8(2, card["id"] | 255);
+  TEST_ASSERT_EQUAL_UINT32(20, card["currentValue"] | 0U);
+  TEST_ASSERT_TRUE(card["logicalState"].isNull());
+  TEST_ASSERT_TRUE(card["maskForced"].isNull());
+  markSnapshotSubscriberSent(subscriber, snapshotPayloadKey(gNext), 1000);
+
+  // A DI change and a debug-only DO change do not wake the subscriber.
+  gPrevious = gNext;
+  gNext.seq = 8;
+  gNext.signals.currentValue[0] = 5;
+  gNext.signals.evalCounter[3] = 9;
+  accumulate(subscriber);
+  TEST_ASSERT_FALSE(snapshotSubscriberDue(subscriber, 1200));
+
+  gPrevious = gNext;
+  gNext.seq = 9;
+  gNext.tsMs = 1300;
+  gNext.signals.currentValue[4] = 77;
+  accumulate(subscriber);
+  TEST_ASSERT_TRUE(snapshotSubscriberDue(subscriber, 1300));
+
+  JsonDocument patch;
+  TEST_ASSERT_EQUAL_UINT8(1, serializeSubscribedSnapshotFrame(
+                                 patch, gNext, kCards, 1300, 10, subscriber,
+                                 SnapshotEncoding_Json));
+  TEST_ASSERT_EQUAL_STRING("runtime_patch", patch["type"] | "");
+  TEST_ASSERT_EQUAL_UINT32(7, patch["baseSnapshotSeq"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(1000, patch["baseTsMs"] | 0U);
+  TEST_ASSERT_EQUAL_UINT8(4, patch["cards"][0]["id"] | 255);
+  TEST_ASSERT_EQUAL_UINT32(77, patch["cards"][0]["currentValue"] | 0U);
+}
+
+void test_rate_limit_defers_and_merges_changes() {
+  SnapshotSubscription sub = {};
+  const char* errorField = nullptr;
+  TEST_ASSERT_TRUE(parse("{\"cards\":[2,3],\"maxRateHz\":2}", sub,
+                         errorField));
+  SnapshotSubscriber subscriber = {};
+  resetSnapshotSubscriber(subscriber, sub);
+  fillSnapshot(gNext);
+  markSnapshotSubscriberSent(subscriber, snapshotPayloadKey(gNext), 1000);
+
+  gPrevious = gNext;
+  gNext.signals.currentValue[2] = 1;
+  accumulate(subscriber);
+  TEST_ASSERT_FALSE(snapshotSubscriberDue(subscriber, 1200));
+
+  gPrevious = gNext;
+  setV3SignalBit(gNext.signals.logical, 3, true);
+  accumulate(subscriber);
+  TEST_ASSERT_TRUE(snapshotSubscriberDue(subscriber, 1500));
+
+  JsonDocument patch;
+  TEST_ASSERT_EQUAL_UINT8(2, serializeSubscribedSnapshotFrame(
+                                 patch, gNext, kCards, 1500, 10, subscriber,
+                                 SnapshotEncoding_Json));
+  markSnapshotSubscriberSent(subscriber, snapshotPayloadKey(gNext), 1500);
+  TEST_ASSERT_FALSE(snapshotSubscriberDue(subscriber, 3000));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_selects_families_cards_fields_and_rate);
+  RUN_TEST(test_parse_rejects_unknown_members);
+  RUN_TEST(test_keyframe_then_patch_carry_only_subscribed_cards_and_fields);
+  RUN_TEST(test_rate_limit_defers_and_merges_changes);
+  return UNITY_END();
+}
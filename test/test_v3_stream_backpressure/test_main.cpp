@@ -0,0 +1,91 @@
+#include <unity.h>
+
+#include "../../src/kernel/enum_codec.cpp"
+#include "../../src/kernel/v3_runtime_signals.cpp"
+#include "../../src/runtime/latency_histogram.cpp"
+#include "../../src/runtime/snapshot_json.cpp"
+#include "../../src/runtime/stream_backpressure.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+const StreamBackpressurePolicy kPolicy = {20000, 500, 10000};
+
+SnapshotStreamMetrics connectedStream() {
+  SnapshotStreamMetrics stream = {};
+  resetStreamClient(stream, 1, true);
+  return stream;
+}
+}  // namespace
+
+void test_fast_sends_never_back_off() {
+  SnapshotStreamMetrics stream = connectedStream();
+  recordStreamSend(stream, 1, kPolicy, true, 900, 1000);
+  recordStreamSend(stream, 1, kPolicy, true, 1200, 1200);
+  TEST_ASSERT_FALSE(stream.clients[1].lagging);
+  TEST_ASSERT_TRUE(streamClientMaySend(stream, 1, 1201));
+  TEST_ASSERT_EQUAL_UINT32(1200, stream.clients[1].lastSendUs);
+  TEST_ASSERT_EQUAL_UINT32(1200, stream.clients[1].maxSendUs);
+  TEST_ASSERT_EQUAL_UINT32(0, stream.clients[1].framesDropped);
+}
+
+void test_slow_send_drops_frames_until_backoff_expires() {
+  SnapshotStreamMetrics stream = connectedStream();
+  recordStreamSend(stream, 1, kPolicy, true, 45000, 1000);
+  TEST_ASSERT_TRUE(stream.clients[1].lagging);
+  const uint32_t revision = stream.revision;
+  TEST_ASSERT_FALSE(streamClientMaySend(stream, 1, 1200));
+  TEST_ASSERT_FALSE(streamClientMaySend(stream, 1, 1400));
+  TEST_ASSERT_EQUAL_UINT32(2, stream.clients[1].framesDropped);
+  TEST_ASSERT_TRUE(stream.revision != revision);
+  TEST_ASSERT_TRUE(streamClientMaySend(stream, 1, 1500));
+
+  recordStreamSend(stream, 1, kPolicy, true, 3000, 1500);
+  TEST_ASSERT_FALSE(stream.clients[1].lagging);
+  TEST_ASSERT_FALSE(streamClientBackingOff(stream, 1, 1501));
+}
+
+void test_client_lagging_past_limit_is_evicted() {
+  SnapshotStreamMetrics stream = connectedStream();
+  recordStreamSend(stream, 1, kPolicy, false, 100, 1000);
+  TEST_ASSERT_EQUAL_UINT32(1, stream.clients[1].sendFailures);
+  TEST_ASSERT_TRUE(stream.clients[1].lagging);
+  for (uint32_t nowMs = 1500; nowMs < 11000; nowMs += 500) {
+    recordStreamSend(stream, 1, kPolicy, true, 30000, nowMs);
+    TEST_ASSERT_FALSE(streamClientShouldEvict(stream, 1, kPolicy, nowMs));
+  }
+  TEST_ASSERT_TRUE(streamClientShouldEvict(stream, 1, kPolicy, 11000));
+
+  recordStreamEviction(stream, 1);
+  TEST_ASSERT_EQUAL_UINT32(1, stream.evictions);
+  TEST_ASSERT_FALSE(stream.connected[1]);
+  TEST_ASSERT_FALSE(streamClientShouldEvict(stream, 1, kPolicy, 20000));
+}
+
+void test_stream_metrics_list_connected_clients() {
+  SnapshotStreamMetrics stream = connectedStream();
+  resetStreamClient(stream, 3, true);
+  recordStreamSend(stream, 3, kPolicy, true, 25000, 1000);
+  streamClientMaySend(stream, 3, 1100);
+  stream.evictions = 2;
+
+  JsonDocument doc;
+  serializeSnapshotStreamMetrics(doc.to<JsonObject>(), stream);
+  TEST_ASSERT_EQUAL_UINT32(2, doc["wsEvictions"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(2, doc["wsClients"].size());
+  JsonVariantConst lagging = doc["wsClients"][1];
+  TEST_ASSERT_EQUAL_UINT8(3, lagging["client"] | 255);
+  TEST_ASSERT_TRUE(lagging["lagging"] | false);
+  TEST_ASSERT_EQUAL_UINT32(25000, lagging["maxSendUs"] | 0U);
+  TEST_ASSERT_EQUAL_UINT32(1, lagging["framesDropped"] | 0U);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fast_sends_never_back_off);
+  RUN_TEST(test_slow_send_drops_frames_until_backoff_expires);
+  RUN_TEST(test_client_lagging_past_limit_is_evicted);
+  RUN_TEST(test_stream_metrics_list_connected_clients);
+  return UNITY_END();
+}
@@ -0,0 +1,85 @@
+#include <unity.h>
+
+#include "../../src/kernel/v3_timer_index.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+namespace {
+constexpr uint8_t kCards = 8;
+
+struct TimerStorage {
+  uint8_t heap[kCards];
+  uint8_t position[kCards];
+  uint32_t dueMs[kCards];
+  V3TimerIndexView index;
+};
+
+void initStorage(TimerStorage& storage) {
+  storage.index = {storage.heap, storage.position, storage.dueMs, 0, kCards};
+  clearV3TimerIndex(storage.index);
+}
+}  // namespace
+
+void test_pops_due_timers_in_deadline_order() {
+  TimerStorage storage = {};
+  initStorage(storage);
+  setV3TimerDue(storage.index, 3, 300);
+  setV3TimerDue(storage.index, 1, 100);
+  setV3TimerDue(storage.index, 5, 500);
+  setV3TimerDue(storage.index, 2, 200);
+
+  uint8_t cardId = 0;
+  TEST_ASSERT_FALSE(popV3DueTimer(storage.index, 99, cardId));
+  TEST_ASSERT_TRUE(popV3DueTimer(storage.index, 250, cardId));
+  TEST_ASSERT_EQUAL_UINT8(1, cardId);
+  TEST_ASSERT_TRUE(popV3DueTimer(storage.index, 250, cardId));
+  TEST_ASSERT_EQUAL_UINT8(2, cardId);
+  TEST_ASSERT_FALSE(popV3DueTimer(storage.index, 250, cardId));
+  TEST_ASSERT_EQUAL_UINT8(2, storage.index.size);
+}
+
+void test_update_and_remove_keep_heap_order() {
+  TimerStorage storage = {};
+  initStorage(storage);
+  for (uint8_t i = 0; i < kCards; ++i) {
+    setV3TimerDue(storage.index, i, 1000U + i * 10U);
+  }
+  setV3TimerDue(storage.index, 7, 5);
+  setV3TimerDue(storage.index, 0, 2000);
+  removeV3Timer(storage.index, 1);
+  removeV3Timer(storage.index, 1);
+
+  const uint8_t expected[] = {7, 2, 3, 4, 5, 6, 0};
+  uint8_t cardId = 0;
+  for (uint8_t i = 0; i < sizeof(expected); ++i) {
+    TEST_ASSERT_TRUE(popV3DueTimer(storage.index, 5000, cardId));
+    TEST_ASSERT_EQUAL_UINT8(expected[i], cardId);
+    TEST_ASSERT_EQUAL_UINT8(kV3TimerNotQueued, storage.position[cardId]);
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, storage.index.size);
+}
+
+void test_ordering_survives_clock_wrap() {
+  TimerStorage storage = {};
+  initStorage(storage);
+  setV3TimerDue(storage.index, 0, 0x00000010UL);
+  setV3TimerDue(storage.index, 1, 0xFFFFFFF0UL);
+
+  uint8_t cardId = 0;
+  uint32_t dueMs = 0;
+  TEST_ASSERT_TRUE(peekV3NextTimer(storage.index, cardId, dueMs));
+  TEST_ASSERT_EQUAL_UINT8(1, cardId);
+  TEST_ASSERT_TRUE(popV3DueTimer(storage.index, 0xFFFFFFF8UL, cardId));
+  TEST_ASSERT_FALSE(popV3DueTimer(storage.index, 0xFFFFFFF8UL, cardId));
+  TEST_ASSERT_TRUE(popV3DueTimer(storage.index, 0x20, cardId));
+  TEST_ASSERT_EQUAL_UINT8(0, cardId);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_pops_due_timers_in_deadline_order);
+  RUN_TEST(test_update_and_remove_keep_heap_order);
+  RUN_TEST(test_ordering_survives_clock_wrap);
+  return UNITY_END();
+}
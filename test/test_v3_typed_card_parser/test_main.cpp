@@ -10,6 +10,8 @@ constexpr uint8_t kSioStart = 10;
 constexpr uint8_t kMathStart = 14;
 constexpr uint8_t kRtcStart = 16;
 constexpr uint8_t kTotalCards = 18;
+constexpr V3CardLayout kLayout = {kTotalCards, kDoStart,   kAiStart,
+                                  kSioStart,   kMathStart, kRtcStart};
 
 logicCardType expectedType(uint8_t id) {
   if (id < kDoStart) return DigitalInput;
@@ -66,8 +68,7 @@ void test_parse_di_card_success() {
 
   V3CardConfig out = {};
   String reason;
-  bool ok = parseV3CardToTyped(card, sourceMap, kTotalCards, kDoStart, kAiStart,
-                               kSioStart, kMathStart, kRtcStart, out, reason);
+  bool ok = parseV3CardToTyped(card, sourceMap, kLayout, out, reason);
   TEST_ASSERT_TRUE(ok);
   TEST_ASSERT_EQUAL_UINT8(0, out.cardId);
   TEST_ASSERT_EQUAL(static_cast<int>(V3CardFamily::DI),
@@ -87,8 +88,7 @@ void test_parse_rejects_card_type_slot_mismatch() {
 
   V3CardConfig out = {};
   String reason;
-  bool ok = parseV3CardToTyped(card, sourceMap, kTotalCards, kDoStart, kAiStart,
-                               kSioStart, kMathStart, kRtcStart, out, reason);
+  bool ok = parseV3CardToTyped(card, sourceMap, kLayout, out, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -127,8 +127,7 @@ void test_parse_rejects_invalid_mission_state_threshold() {
 
   V3CardConfig out = {};
   String reason;
-  bool ok = parseV3CardToTyped(card, sourceMap, kTotalCards, kDoStart, kAiStart,
-                               kSioStart, kMathStart, kRtcStart, out, reason);
+  bool ok = parseV3CardToTyped(card, sourceMap, kLayout, out, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -148,8 +147,7 @@ void test_parse_rtc_card_success() {
 
   V3CardConfig out = {};
   String reason;
-  bool ok = parseV3CardToTyped(card, sourceMap, kTotalCards, kDoStart, kAiStart,
-                               kSioStart, kMathStart, kRtcStart, out, reason);
+  bool ok = parseV3CardToTyped(card, sourceMap, kLayout, out, reason);
   TEST_ASSERT_TRUE(ok);
   TEST_ASSERT_EQUAL(static_cast<int>(V3CardFamily::RTC),
                     static_cast<int>(out.family));
@@ -11,6 +11,8 @@ constexpr uint8_t kSioStart = 10;
 constexpr uint8_t kMathStart = 14;
 constexpr uint8_t kRtcStart = 16;
 constexpr uint8_t kTotalCards = 18;
+constexpr V3CardLayout kLayout = {kTotalCards, kDoStart,   kAiStart,
+                                  kSioStart,   kMathStart, kRtcStart};
 
 V3CardFamily familyForId(uint8_t id) {
   if (id < kDoStart) return V3CardFamily::DI;
@@ -39,25 +41,39 @@ void seedValidCards(V3CardConfig* cards) {
     cards[i].enabled = true;
     cards[i].faultPolicy = V3FaultPolicy::WARN;
 
-    setDefaultCondition(cards[i].di.set);
-    setDefaultCondition(cards[i].di.reset);
-    setDefaultCondition(cards[i].dout.set);
-    setDefaultCondition(cards[i].dout.reset);
-    setDefaultCondition(cards[i].sio.set);
-    setDefaultCondition(cards[i].sio.reset);
-    setDefaultCondition(cards[i].math.set);
-    setDefaultCondition(cards[i].math.reset);
-
-    cards[i].di.edgeMode = Mode_DI_Rising;
-    cards[i].dout.mode = Mode_DO_Normal;
-    cards[i].sio.mode = Mode_DO_Normal;
-    cards[i].ai.inputMin = 0;
-    cards[i].ai.inputMax = 4095;
-    cards[i].ai.outputMin = 0;
-    cards[i].ai.outputMax = 10000;
-    cards[i].ai.emaAlphaX100 = 50;
-    cards[i].rtc.hour = 12;
-    cards[i].rtc.minute = 30;
+    // Family configs share storage; seed only the card's own family.
+    switch (cards[i].family) {
+      case V3CardFamily::DI:
+        setDefaultCondition(cards[i].di.set);
+        setDefaultCondition(cards[i].di.reset);
+        cards[i].di.edgeMode = Mode_DI_Rising;
+        break;
+      case V3CardFamily::DO:
+        setDefaultCondition(cards[i].dout.set);
+        setDefaultCondition(cards[i].dout.reset);
+        cards[i].dout.mode = Mode_DO_Normal;
+        break;
+      case V3CardFamily::AI:
+        cards[i].ai.inputMin = 0;
+        cards[i].ai.inputMax = 4095;
+        cards[i].ai.outputMin = 0;
+        cards[i].ai.outputMax = 10000;
+        cards[i].ai.emaAlphaX100 = 50;
+        break;
+      case V3CardFamily::SIO:
+        setDefaultCondition(cards[i].sio.set);
+        setDefaultCondition(cards[i].sio.reset);
+        cards[i].sio.mode = Mode_DO_Normal;
+        break;
+      case V3CardFamily::MATH:
+        setDefaultCondition(cards[i].math.set);
+        setDefaultCondition(cards[i].math.reset);
+        break;
+      case V3CardFamily::RTC:
+        cards[i].rtc.hour = 12;
+        cards[i].rtc.minute = 30;
+        break;
+    }
   }
 }
 }  // namespace
@@ -70,8 +86,7 @@ void test_validate_typed_cards_accepts_valid_layout() {
   seedValidCards(cards);
 
   std::string reason;
-  bool ok = validateTypedCardConfigs(cards, kTotalCards, kDoStart, kAiStart,
-                                     kSioStart, kMathStart, kRtcStart, reason);
+  bool ok = validateTypedCardConfigs(cards, kLayout, reason);
   TEST_ASSERT_TRUE(ok);
 }
 
@@ -81,8 +96,7 @@ void test_validate_typed_cards_rejects_family_slot_mismatch() {
   cards[8].family = V3CardFamily::DO;  // id=8 is AI slot.
 
   std::string reason;
-  bool ok = validateTypedCardConfigs(cards, kTotalCards, kDoStart, kAiStart,
-                                     kSioStart, kMathStart, kRtcStart, reason);
+  bool ok = validateTypedCardConfigs(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -92,8 +106,7 @@ void test_validate_typed_cards_rejects_do_mode_mismatch() {
   cards[4].dout.mode = Mode_AI_Continuous;
 
   std::string reason;
-  bool ok = validateTypedCardConfigs(cards, kTotalCards, kDoStart, kAiStart,
-                                     kSioStart, kMathStart, kRtcStart, reason);
+  bool ok = validateTypedCardConfigs(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -105,8 +118,7 @@ void test_validate_typed_cards_rejects_illegal_operator_for_ai_source() {
   cards[4].dout.set.combiner = Combine_None;
 
   std::string reason;
-  bool ok = validateTypedCardConfigs(cards, kTotalCards, kDoStart, kAiStart,
-                                     kSioStart, kMathStart, kRtcStart, reason);
+  bool ok = validateTypedCardConfigs(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 
@@ -116,8 +128,7 @@ void test_validate_typed_cards_rejects_rtc_minute_out_of_range() {
   cards[16].rtc.minute = 77;
 
   std::string reason;
-  bool ok = validateTypedCardConfigs(cards, kTotalCards, kDoStart, kAiStart,
-                                     kSioStart, kMathStart, kRtcStart, reason);
+  bool ok = validateTypedCardConfigs(cards, kLayout, reason);
   TEST_ASSERT_FALSE(ok);
 }
 